@@ -1,22 +1,19 @@
-QT += core gui widgets
-QT += multimedia
+# Top-level project: qmake && make builds everything below.
+#   alarmcore  - widget-free alarm logic (static library, QtCore only)
+#   app        - the Rise and Pi GUI (Alarm)
+#   simulator  - virtual-clock alarm simulator (alarm-sim)
+#   wheelbench - timing wheel benchmark (wheelbench)
+#   soak       - long-running leak check of the GUI on a virtual clock (alarm-soak)
+TEMPLATE = subdirs
 
-CONFIG -= app_bundle
-CONFIG += c++17
+SUBDIRS = alarmcore app simulator wheelbench soak
 
-INCLUDEPATH += include
+app.subdir = app
+simulator.subdir = tools/simulator
+wheelbench.subdir = tools/wheelbench
+soak.subdir = tools/soak
 
-SOURCES += main.cpp \
-           src/clockwidget.cpp \
-           src/mainwindow.cpp \
-           src/setalarmwindow.cpp \
-           src/viewAlarm.cpp \
-           src/alarm_details.cpp
-
-HEADERS += include/clockwidget.h \
-           include/mainwindow.h \
-           include/setalarmwindow.h \
-           include/viewAlarm.h \
-           include/alarm_details.h
-
-RESOURCES += resources.qrc
+app.depends = alarmcore
+simulator.depends = alarmcore
+wheelbench.depends = alarmcore
+soak.depends = alarmcore
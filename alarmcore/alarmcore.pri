@@ -0,0 +1,17 @@
+# Links a project against the alarmcore static library.
+ALARMCORE_OUT = $$shadowed($$PWD)
+win32 {
+    CONFIG(debug, debug|release): ALARMCORE_OUT = $$ALARMCORE_OUT/debug
+    else: ALARMCORE_OUT = $$ALARMCORE_OUT/release
+}
+
+# The next-fire index computes in parallel with QtConcurrent
+QT += concurrent
+
+INCLUDEPATH += $$PWD/../include
+DEPENDPATH += $$PWD/../include
+
+LIBS += -L$$ALARMCORE_OUT -lalarmcore
+
+win32-msvc*: PRE_TARGETDEPS += $$ALARMCORE_OUT/alarmcore.lib
+else: PRE_TARGETDEPS += $$ALARMCORE_OUT/libalarmcore.a
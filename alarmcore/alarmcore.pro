@@ -0,0 +1,60 @@
+# Widget-free alarm logic shared by the GUI and the command line tools.
+# Consumers include alarmcore.pri instead of listing these sources.
+TEMPLATE = lib
+TARGET = alarmcore
+
+QT = core concurrent
+
+CONFIG += staticlib c++17
+
+INCLUDEPATH += ../include
+
+SOURCES += ../src/clocksource.cpp \
+           ../src/labelpool.cpp \
+           ../src/alarmstore.cpp \
+           ../src/alarmchangetracker.cpp \
+           ../src/alarmhistory.cpp \
+           ../src/alarmscheduler.cpp \
+           ../src/alarmservice.cpp \
+           ../src/alarmprofiles.cpp \
+           ../src/firebatch.cpp \
+           ../src/deadlinescheduler.cpp \
+           ../src/countdowntimers.cpp \
+           ../src/stopwatch.cpp \
+           ../src/nextfireindex.cpp \
+           ../src/timingwheel.cpp \
+           ../src/occurrencecache.cpp \
+           ../src/holidaycalendar.cpp \
+           ../src/zoneoffsettable.cpp \
+           ../src/memoryusage.cpp \
+           ../src/allocationcounter.cpp
+
+HEADERS += ../include/alarm.h \
+           ../include/labelpool.h \
+           ../include/clocksource.h \
+           ../include/alarmstore.h \
+           ../include/alarmchangetracker.h \
+           ../include/alarmhistory.h \
+           ../include/alarmscheduler.h \
+           ../include/alarmservice.h \
+           ../include/alarmprofiles.h \
+           ../include/firebatch.h \
+           ../include/deadlinescheduler.h \
+           ../include/countdowntimers.h \
+           ../include/stopwatch.h \
+           ../include/nextfireindex.h \
+           ../include/timingwheel.h \
+           ../include/occurrencecache.h \
+           ../include/holidaycalendar.h \
+           ../include/zoneoffsettable.h \
+           ../include/memoryusage.h \
+           ../include/allocationcounter.h
+
+kiosk {
+    CONFIG += release
+    CONFIG -= debug
+    DEFINES += QT_NO_DEBUG_OUTPUT
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -Os
+    linux: QMAKE_CXXFLAGS_RELEASE += -ffunction-sections -fdata-sections
+}
@@ -0,0 +1,4 @@
+# Counts heap allocations by replacing the C library's malloc (glibc only).
+# Opt-in: it changes the allocator of the whole program, so it is kept out of
+# alarmcore and clashes with sanitizers and other allocators.
+SOURCES += $$PWD/../src/allocationhooks.cpp
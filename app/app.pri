@@ -0,0 +1,32 @@
+# The Rise and Pi widgets, shared by the app and the soak test (everything but main.cpp).
+SOURCES += $$PWD/../src/clockwidget.cpp \
+           $$PWD/../src/clockface.cpp \
+           $$PWD/../src/mainwindow.cpp \
+           $$PWD/../src/setalarmwindow.cpp \
+           $$PWD/../src/viewAlarm.cpp \
+           $$PWD/../src/alarm_details.cpp \
+           $$PWD/../src/slotprofiler.cpp \
+           $$PWD/../src/stallwatchdog.cpp \
+           $$PWD/../src/profileroverlay.cpp \
+           $$PWD/../src/agendaview.cpp \
+           $$PWD/../src/worldclockpanel.cpp \
+           $$PWD/../src/historyview.cpp \
+           $$PWD/../src/soundlibrary.cpp \
+           $$PWD/../src/timerspanel.cpp
+
+HEADERS += $$PWD/../include/clockwidget.h \
+           $$PWD/../include/clockface.h \
+           $$PWD/../include/mainwindow.h \
+           $$PWD/../include/setalarmwindow.h \
+           $$PWD/../include/viewAlarm.h \
+           $$PWD/../include/alarm_details.h \
+           $$PWD/../include/slotprofiler.h \
+           $$PWD/../include/stallwatchdog.h \
+           $$PWD/../include/profileroverlay.h \
+           $$PWD/../include/agendaview.h \
+           $$PWD/../include/worldclockpanel.h \
+           $$PWD/../include/historyview.h \
+           $$PWD/../include/soundlibrary.h \
+           $$PWD/../include/timerspanel.h
+
+RESOURCES += $$PWD/../resources.qrc
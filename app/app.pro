@@ -0,0 +1,44 @@
+QT += core gui widgets
+QT += multimedia
+# Single-instance lock and command socket
+QT += network
+
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TARGET = Alarm
+
+# Put the executable at the top of the build tree, where it used to be
+DESTDIR = $$OUT_PWD/..
+
+include(../alarmcore/alarmcore.pri)
+include(app.pri)
+
+SOURCES += ../main.cpp \
+           ../src/singleinstance.cpp
+
+HEADERS += ../include/singleinstance.h
+
+# Heap counters for the profiler overlay: qmake CONFIG+=heapcount
+# Replaces malloc with a counting wrapper (glibc only), so leave it off for
+# sanitizer builds and other allocators.
+heapcount: include(../alarmcore/allocationhooks.pri)
+
+# Kiosk build for small devices: qmake CONFIG+=kiosk
+# Runs on the linuxfb/eglfs/offscreen platforms, drops debug output and the
+# time zone list, and caps the number of stored alarms and the pixmap cache.
+kiosk {
+    TARGET = Alarm-kiosk
+    CONFIG += release
+    CONFIG -= debug
+    DEFINES += RISE_KIOSK \
+               RISE_MAX_ALARMS=256 \
+               RISE_PIXMAP_CACHE_KB=1024 \
+               QT_NO_DEBUG_OUTPUT
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -Os
+    linux {
+        QMAKE_CXXFLAGS_RELEASE += -ffunction-sections -fdata-sections
+        QMAKE_LFLAGS_RELEASE += -Wl,--gc-sections -Wl,-s
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file agendaview.h
+ * @brief Header file for the AgendaView class.
+ *
+ * This file defines the AgendaView window, which lists what will ring over
+ * the next 24 hours, 7 days or 30 days, and the AgendaModel table model
+ * behind it.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef AGENDAVIEW_H
+#define AGENDAVIEW_H
+
+#include <QAbstractTableModel>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QTableView>
+#include <QTimeEdit>
+#include <QTimer>
+#include <QWidget>
+#include "alarmchangetracker.h"
+#include "alarmstore.h"
+#include "clocksource.h"
+#include "occurrencecache.h"
+
+/**
+ * @class AgendaModel
+ * @brief Read-only table of occurrences (time, label, repeat).
+ *
+ * Rows are formatted only when the view asks for them, so a window with
+ * hundreds of thousands of occurrences costs one vector copy.
+ */
+class AgendaModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty model.
+     * @param store Store used to look up labels and repeat settings.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AgendaModel(AlarmStore *store, QObject *parent = nullptr);
+
+    /**
+     * @brief Replaces the rows.
+     * @param occurrences The occurrences to show, in display order.
+     */
+    void setOccurrences(const QVector<Occurrence> &occurrences);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    AlarmStore *alarmStore; ///< Source of labels.
+    QVector<Occurrence> rows; ///< Occurrences shown.
+};
+
+/**
+ * @class AgendaView
+ * @brief Window listing the upcoming occurrences of every alarm.
+ *
+ * The list is recomputed from the OccurrenceCache when the window or the
+ * time-of-day filter changes, once per batch of alarm changes and once a
+ * minute, and only while the window is visible.
+ */
+class AgendaView : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the agenda window.
+     * @param cache Occurrence projection to query.
+     * @param store The alarm store (for labels and change notifications).
+     * @param clock Clock defining "now" (nullptr means the system clock).
+     * @param parent The parent widget (default is nullptr).
+     */
+    AgendaView(OccurrenceCache *cache, AlarmStore *store, ClockSource *clock = nullptr, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief Queries the cache for the selected window and updates the table.
+     */
+    void refresh();
+
+private:
+    OccurrenceCache *occurrenceCache; ///< Projection being shown.
+    ClockSource *clockSource; ///< Defines the start of the window.
+    AlarmChangeTracker *changeTracker; ///< Coalesces store changes into one refresh.
+    AgendaModel *model; ///< Rows of the table.
+    QComboBox *rangeSelector; ///< Next 24 hours / 7 days / 30 days.
+    QCheckBox *timeFilter; ///< Enables the time-of-day filter.
+    QTimeEdit *filterStart; ///< Earliest time of day shown.
+    QTimeEdit *filterEnd; ///< Latest time of day shown (exclusive).
+    QLabel *summaryLabel; ///< Number of occurrences and query time.
+    QTimer minuteTimer; ///< Moves the window forward while visible.
+};
+
+#endif // AGENDAVIEW_H
@@ -0,0 +1,42 @@
+/**
+ * @file alarm.h
+ * @brief Definition of the Alarm record.
+ *
+ * This file defines the Alarm structure, which groups together everything the
+ * application knows about a single alarm (time, repeat setting, label, sound,
+ * holiday calendar, group, enable flag and snooze state).
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARM_H
+#define ALARM_H
+
+#include <QString>
+#include <QTime>
+#include "labelpool.h"
+
+/**
+ * @struct Alarm
+ * @brief A single alarm as stored in the AlarmStore.
+ */
+struct Alarm {
+    quint64 id = 0;      ///< Stable id assigned by the AlarmStore.
+    QTime time;          ///< Time the alarm rings next (moves when snoozed).
+    QTime originalTime;  ///< Time originally chosen by the user.
+    QString repeat;      ///< Repeat setting ("Never", "Every Monday", ...).
+    QString sound;       ///< Name of the sound to play.
+    QString calendar;    ///< Holiday calendar whose dates are skipped ("" for none).
+    Label label;         ///< Label chosen by the user (shared with every alarm of the same label).
+    Label group;         ///< Group the alarm belongs to ("Ward B", ...; empty for none).
+    bool enabled = true; ///< False if the alarm is kept but must not ring.
+    bool snoozed = false; ///< True if this entry is a snoozed copy.
+
+    /**
+     * @brief Returns the label as shown to the user, marking snoozed copies.
+     */
+    QString displayLabel() const { return snoozed ? label.toString() + " (Snoozed)" : label.toString(); }
+};
+
+#endif // ALARM_H
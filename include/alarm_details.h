@@ -19,14 +19,17 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QCheckBox>
+#include <QStringList>
+#include "soundlibrary.h"
 
 /**
  * @class AlarmDetails
  * @brief Dialog for modifying and deleting alarm details.
  * 
  * The AlarmDetails class allows users to edit alarm settings such as time,
- * repeat frequency, label, and sound. It emits signals when alarms are
- * modified or deleted.
+ * repeat frequency, label, sound and group, and to switch an alarm off
+ * without deleting it. It emits signals when alarms are modified or deleted.
  */
 
 class AlarmDetails : public QDialog {
@@ -42,10 +45,18 @@ public:
      * @param repeat The repeat setting of the alarm.
      * @param label The label of the alarm.
      * @param sound The selected alarm sound.
+     * @param calendar The holiday calendar the alarm skips ("" for none).
+     * @param group The group of the alarm ("" for none).
+     * @param enabled Whether the alarm is switched on.
+     * @param calendars Names of the holiday calendars to offer.
+     * @param groups Names of the existing groups to offer.
+     * @param sounds Sounds to offer (nullptr offers the built-in names).
      * @param parent The parent widget (default is nullptr).
      */
 
-    explicit AlarmDetails(QTime time, QString repeat, QString label, QString sound, QWidget *parent = nullptr);
+    explicit AlarmDetails(QTime time, QString repeat, QString label, QString sound, QString calendar,
+                          QString group, bool enabled, const QStringList &calendars, const QStringList &groups,
+                          const SoundLibrary *sounds = nullptr, QWidget *parent = nullptr);
 
 signals:
     /**
@@ -54,9 +65,13 @@ signals:
      * @param repeat The updated repeat setting.
      * @param label The updated alarm label.
      * @param sound The updated alarm sound.
+     * @param calendar The updated holiday calendar ("" for none).
+     * @param group The updated group ("" for none).
+     * @param enabled Whether the alarm is switched on.
      */
 
-    void alarmModified(QTime time, QString repeat, QString label, QString sound); 
+    void alarmModified(QTime time, QString repeat, QString label, QString sound, QString calendar, QString group,
+                       bool enabled);
     
      /**
      * @brief Emitted when an alarm is deleted.
@@ -89,6 +104,9 @@ private:
     QComboBox *repeatComboBox; ///< Dropdown for selecting the repeat frequency.
     QLineEdit *labelEdit; ///< Input field for setting the alarm label.
     QComboBox *soundComboBox; ///< Dropdown for selecting the alarm sound.
+    QComboBox *calendarComboBox; ///< Dropdown for selecting the holiday calendar.
+    QComboBox *groupComboBox; ///< Editable dropdown for the alarm's group.
+    QCheckBox *enabledCheckBox; ///< Switches the alarm on or off.
     QPushButton *modifyButton;  ///< Button for modifying the alarm.
     QPushButton *deleteButton;  ///< Button for deleting the alarm.
     QPushButton *closeButton; ///< Button for closing the dialog.
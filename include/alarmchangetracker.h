@@ -0,0 +1,98 @@
+/**
+ * @file alarmchangetracker.h
+ * @brief Header file for the AlarmChangeTracker class.
+ *
+ * This file defines the AlarmChangeTracker class, which collects the change
+ * stream of an AlarmStore and hands it to a view at most once per event-loop
+ * iteration.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMCHANGETRACKER_H
+#define ALARMCHANGETRACKER_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include "alarmstore.h"
+
+/**
+ * @class AlarmChangeTracker
+ * @brief Coalesces store changes into one deferred batch.
+ *
+ * Every change emitted by the store marks the tracker dirty; the first one
+ * also schedules a flush for when control returns to the event loop. By then
+ * any number of mutations may have happened. They are folded into one net
+ * change per alarm (an alarm added and removed again disappears entirely)
+ * and delivered with a single changesReady() signal, so a burst of N store
+ * changes costs the view one update instead of N.
+ *
+ * While paused (e.g. while the view is hidden) changes keep accumulating
+ * and are delivered when the tracker is resumed.
+ */
+class AlarmChangeTracker : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Starts tracking a store.
+     * @param store The store to track.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AlarmChangeTracker(AlarmStore *store, QObject *parent = nullptr);
+
+    /**
+     * @brief Stops or resumes delivering batches.
+     * @param paused True to hold changes back until resumed.
+     */
+    void setPaused(bool paused);
+
+    /**
+     * @brief Returns true if changes are waiting to be delivered.
+     */
+    bool isDirty() const { return dirty; }
+
+    /**
+     * @brief Delivers the pending changes now instead of waiting for the event loop.
+     */
+    void flush();
+
+    /**
+     * @brief Drops the pending changes without delivering them.
+     *
+     * For views that are about to re-read the whole store anyway.
+     */
+    void discard();
+
+signals:
+    /**
+     * @brief Emitted with the net effect of all changes since the last batch.
+     *
+     * The list has the same layout as AlarmStore::changed(): removals first,
+     * then updates, then additions by ascending index, with indices taken
+     * from the store's current snapshot.
+     *
+     * @param fromVersion The store version before the first pending change.
+     * @param toVersion The current store version.
+     * @param changes The net changes.
+     */
+    void changesReady(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+private slots:
+    /**
+     * @brief Folds one store change into the pending batch.
+     */
+    void track(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+private:
+    AlarmStore *alarmStore; ///< Tracked store.
+    QTimer flushTimer; ///< Zero-interval timer that flushes once per event-loop iteration.
+    QHash<quint64, AlarmChange::Kind> pending; ///< Net change of each touched alarm.
+    quint64 baseVersion = 0; ///< Store version before the first pending change.
+    bool dirty = false; ///< True if a batch is waiting.
+    bool paused = false; ///< True while batches are held back.
+};
+
+#endif // ALARMCHANGETRACKER_H
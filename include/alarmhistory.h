@@ -0,0 +1,232 @@
+/**
+ * @file alarmhistory.h
+ * @brief Header file for the AlarmHistory class.
+ *
+ * This file defines the AlarmHistory class, a fixed-size ring file of
+ * fired, snoozed and dismissed alarm events, and the HistoryRecord layout
+ * stored in it.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMHISTORY_H
+#define ALARMHISTORY_H
+
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include "alarm.h"
+
+class QThread;
+
+/**
+ * @struct HistoryRecord
+ * @brief One event, exactly as it is laid out in the ring file (64 bytes).
+ */
+struct HistoryRecord {
+    /**
+     * @brief What happened to the alarm.
+     */
+    enum Kind : quint8 {
+        Fired = 1,     ///< The alarm rang.
+        Snoozed = 2,   ///< The alarm was snoozed.
+        Dismissed = 3  ///< The alarm was dismissed.
+    };
+
+    quint64 sequence;     ///< Position in the history, starting at 1 (0 marks an empty slot).
+    qint64 atMSecs;       ///< When it happened, in ms since the epoch (UTC).
+    quint64 alarmId;      ///< Store id of the alarm.
+    quint32 checksum;     ///< Checksum of every other field; detects torn writes.
+    quint32 alarmSecond;  ///< Second of the day the alarm was set for.
+    quint8 kind;          ///< A Kind value.
+    quint8 labelLength;   ///< Bytes used in label.
+    char label[30];       ///< UTF-8 label, truncated at a character boundary.
+
+    /**
+     * @brief Returns when the event happened, in local time.
+     */
+    QDateTime dateTime() const { return QDateTime::fromMSecsSinceEpoch(atMSecs); }
+
+    /**
+     * @brief Returns the label as a string.
+     */
+    QString labelText() const { return QString::fromUtf8(label, labelLength); }
+
+    /**
+     * @brief Returns the time the alarm was set for.
+     */
+    QTime alarmTime() const { return QTime::fromMSecsSinceStartOfDay(int(alarmSecond) * 1000); }
+
+    /**
+     * @brief Returns "Fired", "Snoozed" or "Dismissed".
+     */
+    QString kindName() const;
+};
+
+static_assert(sizeof(HistoryRecord) == 64, "HistoryRecord is part of the file format");
+
+/**
+ * @struct HistoryFilter
+ * @brief Selects records in AlarmHistory::find().
+ */
+struct HistoryFilter {
+    int kinds = 0xFF;     ///< Bit (1 << Kind) set for every kind to include.
+    quint64 alarmId = 0;  ///< Only this alarm (0 for every alarm).
+    QByteArray label;     ///< Only labels containing these UTF-8 bytes (empty for any label).
+    qint64 fromMSecs = std::numeric_limits<qint64>::min(); ///< Earliest event time (inclusive).
+    qint64 toMSecs = std::numeric_limits<qint64>::max();   ///< Latest event time (exclusive).
+};
+
+/**
+ * @class AlarmHistory
+ * @brief Append-only event log kept in a memory-mapped ring file.
+ *
+ * The file holds a small header followed by a fixed number of 64-byte
+ * records, so it never grows; once full, the oldest record is overwritten.
+ * record() only queues the event, and a writer thread copies queued
+ * records into the mapping. Because the mapping is shared with the page
+ * cache, everything written survives a crash of the application. On open,
+ * the newest record is found by scanning the slots; records whose checksum
+ * does not match (a write cut short by a crash) are ignored.
+ *
+ * Readers copy records out of the mapping while the writer may be
+ * overwriting them, using a seqlock on the sequence field: the writer clears
+ * the sequence, writes the other fields and then publishes the new
+ * sequence; a reader copies the record and only accepts it if the sequence
+ * was the one asked for both before and after the copy. Every field is
+ * read and written with relaxed atomic word accesses, so a copy that races
+ * with the writer is discarded rather than undefined.
+ */
+class AlarmHistory : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Opens (or creates) the ring file and starts the writer thread.
+     *
+     * A file of another capacity or format is started afresh.
+     *
+     * @param path Location of the ring file.
+     * @param capacity Number of records kept.
+     * @param parent The parent object (default is nullptr).
+     */
+    AlarmHistory(const QString &path, int capacity, QObject *parent = nullptr);
+
+    /**
+     * @brief Writes out the queued records and unmaps the file.
+     */
+    ~AlarmHistory() override;
+
+    /**
+     * @brief Returns false if the file could not be opened or mapped.
+     */
+    bool isOpen() const { return records != nullptr; }
+
+    /**
+     * @brief Returns the reason the file could not be opened.
+     */
+    QString errorString() const { return error; }
+
+    /**
+     * @brief Returns the number of records the file holds.
+     */
+    int capacity() const { return slotCount; }
+
+    /**
+     * @brief Queues an event; never waits for the disk.
+     * @param kind What happened.
+     * @param alarm The alarm it happened to.
+     * @param at When it happened.
+     */
+    void record(HistoryRecord::Kind kind, const Alarm &alarm, const QDateTime &at);
+
+    /**
+     * @brief Returns the sequence of the newest written record (0 if none).
+     */
+    quint64 lastSequence() const { return head.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copies a record out of the mapping.
+     * @param sequence The sequence of the record.
+     * @param record Receives the record.
+     * @return False if it was overwritten, is being overwritten or was never written.
+     */
+    bool recordAt(quint64 sequence, HistoryRecord *record) const;
+
+    /**
+     * @brief Visits the records from newest to oldest.
+     * @param visitor Called with a copy of each record; returns false to stop.
+     * @return The number of records visited.
+     */
+    int visit(const std::function<bool(const HistoryRecord &)> &visitor) const;
+
+    /**
+     * @brief Returns the sequences of the matching records, newest first.
+     * @param filter Which records to return.
+     * @param limit Maximum number of results (-1 for no limit).
+     */
+    QVector<quint64> find(const HistoryFilter &filter, int limit = -1) const;
+
+signals:
+    /**
+     * @brief Emitted from the writer thread after a batch of records was written.
+     * @param lastSequence The sequence of the newest record.
+     */
+    void recordsWritten(quint64 lastSequence);
+
+private:
+    /**
+     * @brief Maps the file, creating or resetting it if needed.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Moves queued records into the mapping until stopped.
+     */
+    void writeLoop();
+
+    /**
+     * @brief Returns the record slot of a sequence.
+     */
+    HistoryRecord *slot(quint64 sequence) const { return records + (sequence - 1) % quint64(slotCount); }
+
+    /**
+     * @brief Copies a slot if it holds the given sequence (seqlock read side).
+     */
+    bool readSlot(quint64 sequence, HistoryRecord *record) const;
+
+    /**
+     * @brief Writes a record into its slot (seqlock write side).
+     */
+    void writeSlot(const HistoryRecord &record);
+
+    /**
+     * @brief Returns true if a slot holds an intact record.
+     */
+    static bool isIntact(const HistoryRecord &record);
+
+    /**
+     * @brief Computes the checksum of a record.
+     */
+    static quint32 checksumOf(const HistoryRecord &record);
+
+    QFile file; ///< The ring file.
+    QString error; ///< Why the file could not be opened.
+    int slotCount; ///< Number of record slots.
+    HistoryRecord *records = nullptr; ///< First slot in the mapping.
+    std::atomic<quint64> head{0}; ///< Sequence of the newest written record.
+    QMutex queueMutex; ///< Guards queue and stopping.
+    QWaitCondition queueReady; ///< Wakes the writer.
+    QVector<HistoryRecord> queue; ///< Records waiting to be written.
+    bool stopping = false; ///< Tells the writer to finish.
+    QThread *writer = nullptr; ///< Writer thread.
+};
+
+#endif // ALARMHISTORY_H
@@ -0,0 +1,245 @@
+/**
+ * @file alarmprofiles.h
+ * @brief Header file for the AlarmProfiles class.
+ *
+ * This file defines the AlarmProfiles class, which keeps one alarm shard
+ * (store file, scheduler and service) per user profile, loads the inactive
+ * ones only when they are about to ring, and merges their next deadlines.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMPROFILES_H
+#define ALARMPROFILES_H
+
+#include <QDateTime>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "alarmhistory.h"
+#include "alarmscheduler.h"
+#include "alarmservice.h"
+#include "clocksource.h"
+#include "holidaycalendar.h"
+
+/**
+ * @class AlarmProfiles
+ * @brief Per-profile alarm shards with lazy loading and a merged next deadline.
+ *
+ * Every profile ("Default", "Anna", "Bed 3") has its own shard: a store file
+ * in the profile folder, and once loaded, its own AlarmScheduler (store,
+ * timing wheel and next-fire index) and AlarmService. Shards never share
+ * alarms or ids, so editing one profile never touches another one's wheel,
+ * and switching the active profile just picks another loaded shard.
+ *
+ * Only the active profile is loaded up front. For the others only the
+ * header of the file is read, which holds the next deadline the shard had
+ * when it was saved; a shard is loaded once that deadline is less than
+ * loadAheadMs away (or the profile is activated), and then stays loaded so
+ * that its alarms ring whichever profile is shown. The earliest deadline of
+ * the unloaded shards is kept, so checking whether one must be loaded is a
+ * single comparison per call of loadDue().
+ *
+ * Holiday calendars are shared: calendars() is copied into every loaded
+ * shard and kept in step with it. Each shard is written back to its file
+ * (atomically, a second after the last change) and when the profiles are
+ * destroyed. Without a folder the profiles only live in memory.
+ */
+class AlarmProfiles : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 loadAheadMs = 10 * 60 * 1000; ///< How long before its next deadline an inactive shard is loaded.
+
+    /**
+     * @brief Constructs the profiles with the empty "Default" profile loaded and active.
+     * @param clock The clock the schedulers read "now" from (nullptr means the system clock).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AlarmProfiles(ClockSource *clock = nullptr, QObject *parent = nullptr);
+
+    /**
+     * @brief Writes every loaded shard back to its file.
+     */
+    ~AlarmProfiles() override;
+
+    /**
+     * @brief Stores the profiles in a folder, creating it if needed.
+     *
+     * Lists the profile files and reads their headers, and moves every
+     * profile's file into the folder. A profile that is already loaded and
+     * has a file there (such as the active one) takes the file's alarms in
+     * place of those it held, so calling this again never duplicates
+     * alarms; loaded profiles without a file keep theirs and are saved into
+     * the folder.
+     *
+     * @param path The folder.
+     * @return False if the folder cannot be created.
+     */
+    bool setDirectory(const QString &path);
+
+    /**
+     * @brief Returns the profile folder ("" if the profiles only live in memory).
+     */
+    QString directory() const { return profileDirectory; }
+
+    /**
+     * @brief Returns the names of all profiles, sorted.
+     */
+    QStringList names() const { return shards.keys(); }
+
+    /**
+     * @brief Returns the name of the active profile.
+     */
+    QString activeName() const { return activeProfile; }
+
+    /**
+     * @brief Returns the scheduler of the active profile (always loaded).
+     */
+    AlarmScheduler *active() const { return shards.value(activeProfile).scheduler; }
+
+    /**
+     * @brief Returns the service of the active profile.
+     */
+    AlarmService *activeService() const { return shards.value(activeProfile).service; }
+
+    /**
+     * @brief Makes a profile the active one, creating it if it does not exist.
+     * @param name The profile (see isValidName()).
+     * @return False if the name is not valid.
+     */
+    bool setActive(const QString &name);
+
+    /**
+     * @brief Returns true if a profile's shard is in memory.
+     */
+    bool isLoaded(const QString &name) const { return shards.value(name).scheduler != nullptr; }
+
+    /**
+     * @brief Returns the schedulers of all loaded shards, in the order they were loaded.
+     */
+    const QVector<AlarmScheduler *> &loaded() const { return loadedSchedulers; }
+
+    /**
+     * @brief Returns the name of the profile a loaded scheduler belongs to.
+     */
+    QString nameOf(const AlarmScheduler *scheduler) const;
+
+    /**
+     * @brief Returns the earliest next deadline across all profiles.
+     *
+     * Loaded shards answer from their next-fire index, unloaded ones with
+     * the deadline saved in their file.
+     *
+     * @param profile Receives the profile of that deadline (may be nullptr).
+     * @return The local date and time, or an invalid QDateTime if nothing will ring.
+     */
+    QDateTime nextDeadline(QString *profile = nullptr) const;
+
+    /**
+     * @brief Returns the next deadline of one profile, loaded or not.
+     */
+    QDateTime nextDeadline(const QString &name) const;
+
+    /**
+     * @brief Loads the unloaded shards whose next deadline is less than loadAheadMs after now.
+     * @param now The current local date and time.
+     * @return The number of shards loaded.
+     */
+    int loadDue(const QDateTime &now);
+
+    /**
+     * @brief Returns the holiday calendars shared by all profiles.
+     */
+    HolidayCalendars *calendars() const { return sharedCalendars; }
+
+    /**
+     * @brief Records the events of every profile in a history (not owned; nullptr stops recording).
+     */
+    void setHistory(AlarmHistory *history);
+
+    /**
+     * @brief Limits how many alarms each profile can store (-1 means no limit).
+     */
+    void setCapacity(int maxAlarms);
+
+    /**
+     * @brief Returns true if a text can name a profile: 1 to 64 letters, digits, spaces, '_' or '-'.
+     */
+    static bool isValidName(const QString &name);
+
+signals:
+    /**
+     * @brief Emitted when a profile is created.
+     */
+    void profileAdded(const QString &name);
+
+    /**
+     * @brief Emitted when another profile became the active one.
+     */
+    void activeChanged(const QString &name);
+
+    /**
+     * @brief Emitted when a profile's shard was loaded into memory.
+     */
+    void shardLoaded(const QString &name);
+
+private:
+    /**
+     * @brief One profile's alarms.
+     */
+    struct Shard {
+        QString path; ///< Store file ("" while the profiles only live in memory).
+        AlarmScheduler *scheduler = nullptr; ///< Scheduler holding the alarms (nullptr until loaded).
+        AlarmService *service = nullptr; ///< Snapshot reads of the alarms (nullptr until loaded).
+        QTimer *saveTimer = nullptr; ///< Writes the file a second after the last change.
+        qint64 savedNextMs = -1; ///< Next deadline from the file header (UTC ms, -1 for none).
+    };
+
+    /**
+     * @brief Creates the scheduler of a shard and reads its file, if any.
+     */
+    void load(const QString &name);
+
+    /**
+     * @brief Replaces the alarms of a scheduler's store with those of a file.
+     * @return False if the file exists but cannot be read (the store is then left alone).
+     */
+    bool readFile(const QString &path, AlarmScheduler *scheduler);
+
+    /**
+     * @brief Writes a loaded shard to its file.
+     */
+    void save(const QString &name);
+
+    /**
+     * @brief Reads the saved next deadline of a file.
+     * @return False if the file has no valid header.
+     */
+    static bool readHeader(const QString &path, qint64 *nextMs);
+
+    /**
+     * @brief Makes a scheduler's calendars equal to the shared ones.
+     */
+    void copyCalendars(AlarmScheduler *scheduler) const;
+
+    /**
+     * @brief Recomputes earliestUnloadedMs.
+     */
+    void updateEarliestUnloaded();
+
+    ClockSource *clockSource; ///< Clock of every scheduler.
+    HolidayCalendars *sharedCalendars; ///< Calendars copied into every shard.
+    AlarmHistory *alarmHistory = nullptr; ///< History of every shard (not owned).
+    int capacity = -1; ///< Alarm limit of every shard.
+    QString profileDirectory; ///< Folder of the store files.
+    QMap<QString, Shard> shards; ///< Shards by profile name.
+    QString activeProfile; ///< Profile shown in the windows.
+    QVector<AlarmScheduler *> loadedSchedulers; ///< Schedulers of the loaded shards.
+    qint64 earliestUnloadedMs = -1; ///< Earliest saved deadline of the unloaded shards (-1 for none).
+};
+
+#endif // ALARMPROFILES_H
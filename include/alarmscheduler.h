@@ -0,0 +1,310 @@
+/**
+ * @file alarmscheduler.h
+ * @brief Header file for the AlarmScheduler class.
+ *
+ * This file defines the AlarmScheduler class, which applies the alarm rules
+ * to the AlarmStore and decides, for a given instant, which alarms are due.
+ * It has no user interface so it can be driven both by the MainWindow and by
+ * the simulator.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMSCHEDULER_H
+#define ALARMSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QDateTime>
+#include <QHash>
+#include <QVector>
+#include "alarm.h"
+#include "alarmhistory.h"
+#include "alarmstore.h"
+#include "clocksource.h"
+#include "holidaycalendar.h"
+#include "nextfireindex.h"
+#include "occurrencecache.h"
+#include "timingwheel.h"
+
+/**
+ * @struct FireJitter
+ * @brief How late alarms were reported due, compared with the second they were set for.
+ */
+struct FireJitter {
+    int count = 0;       ///< Alarms measured.
+    qint64 totalMs = 0;  ///< Sum of their lateness.
+    qint64 worstMs = 0;  ///< Largest lateness.
+    qint64 lastMs = 0;   ///< Lateness of the most recent alarm.
+
+    /**
+     * @brief Returns the average lateness in milliseconds.
+     */
+    double meanMs() const { return count > 0 ? double(totalMs) / count : 0.0; }
+};
+
+/**
+ * @class AlarmScheduler
+ * @brief Evaluates repeat, snooze and dismiss rules on the alarm store.
+ *
+ * The scheduler reads the current time from a ClockSource, so replacing the
+ * system clock with a VirtualClock lets whole weeks or years of alarms be
+ * replayed without waiting. Alarms are identified by their store id.
+ *
+ * Every enabled alarm is mirrored into a TimingWheel, so finding the alarms
+ * due in a minute costs the same with ten alarms as with millions. When a
+ * minute starts, its alarms move to a short list ordered by second, from
+ * which they are reported due at the exact second they are set for. The next
+ * fire instant of every alarm is kept in a NextFireIndex. The scheduler
+ * only depends on QtCore (and QtConcurrent) and is built into the alarmcore
+ * library.
+ */
+class AlarmScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a scheduler with an empty store.
+     * @param clock The clock to read "now" from (nullptr means the system clock).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AlarmScheduler(ClockSource *clock = nullptr, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the clock used by the scheduler.
+     * @return Pointer to the clock source.
+     */
+    ClockSource *clock() const { return clockSource; }
+
+    /**
+     * @brief Returns the store holding the alarms.
+     * @return Pointer to the alarm store (owned by the scheduler).
+     */
+    AlarmStore *store() const { return alarmStore; }
+
+    /**
+     * @brief Returns the projection of the alarms onto the calendar.
+     * @return Pointer to the occurrence cache (owned by the scheduler).
+     */
+    OccurrenceCache *occurrences() const { return occurrenceCache; }
+
+    /**
+     * @brief Returns the holiday calendars alarms can skip.
+     * @return Pointer to the calendars (owned by the scheduler).
+     */
+    HolidayCalendars *calendars() const { return holidayCalendars; }
+
+    /**
+     * @brief Returns the next fire instant of every alarm.
+     * @return Pointer to the index (owned by the scheduler).
+     */
+    NextFireIndex *nextFires() const { return nextFireIndex; }
+
+    /**
+     * @brief Records every fire, snooze and dismiss in a history file from now on.
+     * @param history The history (not owned; nullptr stops recording).
+     */
+    void setHistory(AlarmHistory *history) { alarmHistory = history; }
+
+    /**
+     * @brief Returns the history events are recorded in, or nullptr.
+     */
+    AlarmHistory *history() const { return alarmHistory; }
+
+    /**
+     * @brief Returns all stored alarms.
+     * @return The alarms, in insertion order.
+     */
+    const QVector<Alarm> &alarms() const { return alarmStore->alarms(); }
+
+    /**
+     * @brief Limits how many alarms can be stored.
+     * @param maxAlarms The maximum number of alarms, or -1 for no limit.
+     */
+    void setCapacity(int maxAlarms) { capacity = maxAlarms; }
+
+    /**
+     * @brief Returns the maximum number of alarms (-1 means no limit).
+     */
+    int maxAlarms() const { return capacity; }
+
+    /**
+     * @brief Adds a new alarm.
+     * @param time The time of the alarm.
+     * @param repeat The repeat setting of the alarm.
+     * @param label The label of the alarm.
+     * @param sound The sound associated with the alarm.
+     * @param calendar Holiday calendar whose dates the alarm skips ("" for none).
+     * @param group Group the alarm belongs to ("" for none).
+     * @return False if the scheduler is full and the alarm was not added.
+     */
+    bool addAlarm(QTime time, const QString &repeat, const QString &label, const QString &sound,
+                  const QString &calendar = QString(), const QString &group = QString());
+
+    /**
+     * @brief Returns every alarm that should ring at the given local time.
+     *
+     * Advances the timing wheel to the minute of now and returns the alarms
+     * whose second has been reached. Each alarm is returned once for the
+     * second it rings in; minutes skipped since the previous call (up to 90)
+     * are caught up, larger clock jumps resynchronise the wheel without
+     * ringing the skipped alarms. How late each alarm is reported is added
+     * to fireJitter(). Once an hour the system time zone is compared with
+     * the one next fire instants were computed in.
+     *
+     * To ring on time, call this just after every whole second. In steady
+     * state the call makes no heap allocation, provided the previous result
+     * was released; the NextFireIndex is refreshed later, from the event loop.
+     *
+     * @param now The current local date and time.
+     * @return The ids of all due alarms, in firing order.
+     */
+    QVector<quint64> dueAlarms(const QDateTime &now);
+
+    /**
+     * @brief Returns how late dueAlarms() reported alarms on time so far.
+     *
+     * Only alarms that came due since the previous dueAlarms() call are
+     * counted; alarms rung late on purpose (caught up after a clock jump, or
+     * added after their second had passed) are not.
+     */
+    const FireJitter &fireJitter() const { return jitter; }
+
+    /**
+     * @brief Starts measuring the lateness anew.
+     */
+    void resetFireJitter() { jitter = FireJitter(); }
+
+    /**
+     * @brief Converts a local date and time to a timing wheel minute.
+     * @param local The local date and time.
+     * @return Local minutes since Monday 1970-01-05 00:00.
+     */
+    static qint64 wheelMinute(const QDateTime &local);
+
+    /**
+     * @brief Converts a timing wheel minute back to a local date and time.
+     * @param minute Local minutes since Monday 1970-01-05 00:00.
+     * @return The local date and time.
+     */
+    static QDateTime fromWheelMinute(qint64 minute);
+
+    /**
+     * @brief Returns the day of the week a repeat setting rings on.
+     * @param repeat The repeat setting ("Every Monday", ...).
+     * @return The day (Qt::Monday = 1 ... Qt::Sunday = 7), or 0 if the alarm is not weekly.
+     */
+    static int weeklyDay(const QString &repeat);
+
+    /**
+     * @brief Snoozes an alarm.
+     *
+     * One-time alarms are replaced by a snoozed copy; repeating alarms keep
+     * their original entry (suppressed for today) and gain a snoozed copy.
+     *
+     * @param id The id of the alarm.
+     * @param minutes The number of minutes to snooze for.
+     */
+    void snooze(quint64 id, int minutes);
+
+    /**
+     * @brief Snoozes several alarms in one operation.
+     *
+     * Behaves like snooze() for each alarm but applies a single change to the
+     * store, so views are notified once.
+     *
+     * @param ids The ids of the alarms.
+     * @param minutes The number of minutes to snooze for.
+     */
+    void snoozeAll(const QVector<quint64> &ids, int minutes);
+
+    /**
+     * @brief Dismisses an alarm.
+     *
+     * One-time and snoozed alarms are removed; repeating alarms are suppressed
+     * for the rest of the day.
+     *
+     * @param id The id of the alarm.
+     * @return True if the alarm was removed from the store.
+     */
+    bool dismiss(quint64 id);
+
+    /**
+     * @brief Dismisses several alarms in one operation.
+     *
+     * Behaves like dismiss() for each alarm but applies a single change to the
+     * store, so views are notified at most once.
+     *
+     * @param ids The ids of the alarms.
+     * @return The number of alarms removed from the store.
+     */
+    int dismissAll(const QVector<quint64> &ids);
+
+private slots:
+    /**
+     * @brief Mirrors store changes into the timing wheel.
+     */
+    void onStoreChanged(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+private:
+    /**
+     * @brief An alarm of the current minute waiting for its second.
+     */
+    struct ArmedAlarm {
+        qint64 second;   ///< Local seconds since the wheel epoch it rings at.
+        quint64 id;      ///< Store id of the alarm.
+    };
+
+    /**
+     * @brief Inserts an alarm into the timing wheel at its next occurrence (disabled alarms are left out).
+     */
+    void scheduleAlarm(const Alarm &alarm);
+
+    /**
+     * @brief Adds an alarm to the armed list, keeping it ordered by second.
+     */
+    void arm(qint64 second, quint64 id);
+
+    /**
+     * @brief Removes an alarm from the timing wheel.
+     */
+    void unscheduleAlarm(quint64 id);
+
+    /**
+     * @brief Re-creates the timing wheel at the given minute from the store.
+     */
+    void rebuildWheel(qint64 minute);
+
+    /**
+     * @brief Checks whether an alarm was dismissed for the rest of a day or the day is a holiday for it.
+     */
+    bool isSuppressed(const Alarm &alarm, const QDate &date) const;
+
+    /**
+     * @brief Remembers that an alarm was dismissed on a date.
+     *
+     * Only one day's dismissals are ever kept, so the set cannot grow forever.
+     */
+    void markDismissed(const Label &label, const QDate &date);
+
+    ClockSource *clockSource; ///< Source of the current time.
+    AlarmStore *alarmStore; ///< Stored alarms.
+    HolidayCalendars *holidayCalendars; ///< Dates skipped by alarms that refer to them.
+    OccurrenceCache *occurrenceCache; ///< Upcoming occurrences, expanded on demand.
+    NextFireIndex *nextFireIndex; ///< Next fire instant of every alarm.
+    AlarmHistory *alarmHistory = nullptr; ///< Event log (not owned), or nullptr.
+    QSet<Label> dismissedToday; ///< Labels of the alarms dismissed on dismissedDate.
+    QDate dismissedDate; ///< Date the entries in dismissedToday belong to.
+    int capacity = -1; ///< Maximum number of alarms (-1 means no limit).
+    TimingWheel wheel; ///< Alarms by the minute they ring next.
+    QHash<quint64, TimingWheel::Handle> wheelHandles; ///< Wheel entry of each alarm.
+    QVector<ArmedAlarm> armed; ///< Alarms whose minute the wheel has passed, waiting for their second.
+    QVector<quint64> firedIds; ///< Alarms reached by the latest dueAlarms() call (reused).
+    QVector<quint64> dueIds; ///< Result of the latest dueAlarms() call (reused).
+    FireJitter jitter; ///< Lateness of the alarms reported due so far.
+    qint64 lastCheckedSecond = 0; ///< Local second (since the wheel epoch) of the previous dueAlarms() call.
+};
+
+#endif // ALARMSCHEDULER_H
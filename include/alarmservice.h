@@ -0,0 +1,258 @@
+/**
+ * @file alarmservice.h
+ * @brief Header file for the AlarmService class.
+ *
+ * This file defines the AlarmService class, the thread-safe entry point for
+ * code that embeds the alarm logic, and the AlarmServiceSnapshot values it
+ * hands to readers.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMSERVICE_H
+#define ALARMSERVICE_H
+
+#include <QDateTime>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QTimeZone>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "alarmscheduler.h"
+#include "alarmstore.h"
+#include "nextfireindex.h"
+
+/**
+ * @class AlarmServiceSnapshot
+ * @brief Immutable view of the alarms and their next fire instants.
+ *
+ * A snapshot never changes once obtained and may be read and copied from
+ * any thread. Copies are O(1).
+ */
+class AlarmServiceSnapshot {
+public:
+    /**
+     * @brief Returns the store version of the alarms.
+     */
+    quint64 version() const { return store.version(); }
+
+    /**
+     * @brief Returns the alarms in display order.
+     */
+    const QVector<Alarm> &alarms() const { return store.alarms(); }
+
+    /**
+     * @brief Returns the alarm with the given id, or nullptr.
+     */
+    const Alarm *find(quint64 id) const;
+
+    /**
+     * @brief Returns when an alarm rings next.
+     * @return The local date and time, or an invalid QDateTime if it never rings again.
+     */
+    QDateTime nextFire(quint64 id) const;
+
+    /**
+     * @brief Returns the id of the alarm that rings first (0 if none).
+     */
+    quint64 nextAlarmId() const { return fires ? fires->earliestId : 0; }
+
+    /**
+     * @brief Returns when the first alarm rings.
+     * @return The local date and time, or an invalid QDateTime if nothing will ring.
+     */
+    QDateTime nextAlarmTime() const;
+
+private:
+    friend class AlarmService;
+
+    AlarmSnapshot store; ///< The alarms.
+    std::shared_ptr<const NextFireTable> fires; ///< Their next fire instants (may lag one store version behind).
+    QTimeZone zone; ///< Zone fire instants are shown in.
+};
+
+/**
+ * @class AlarmService
+ * @brief Lock-free snapshot reads for any number of threads, with one writer.
+ *
+ * On the thread the service lives in, which is the only thread that
+ * writes, snapshot() reads the store and the next fire table directly.
+ *
+ * Other threads first attach as readers. While at least one is attached,
+ * the service publishes an AlarmServiceSnapshot after every change of the
+ * store or of the next fire instants, by swapping one atomic pointer
+ * (read-copy-update). Readers load the pointer and copy the snapshot out;
+ * they never take a lock and never wait for the writer.
+ *
+ * A published snapshot holds the store's list, so every change made while
+ * a reader is attached copies the list once (see AlarmSnapshot). With no
+ * reader attached nothing is published: the last published snapshot is
+ * retired and freed, and changes cost only what they touch. The GUI reads
+ * on the service's thread and never attaches.
+ *
+ * Old snapshots are freed with epoch-based reclamation: a reader marks one
+ * of 64 reader slots with the epoch it started in for the few nanoseconds
+ * it takes to copy the snapshot, and a replaced snapshot is only deleted
+ * once no slot holds an epoch from before it was replaced. The writer never
+ * waits for readers; replaced snapshots are freed on a later publish. Up
+ * to 64 threads can copy a snapshot at the same instant; a further one
+ * (or any reader while a reader holding a slot is preempted) yields its
+ * time slice after every full pass over the slots until one is free.
+ *
+ * Mutations may be requested from any thread. They are applied in order on
+ * the service's thread.
+ */
+class AlarmService : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the service over a scheduler and publishes its alarms.
+     * @param scheduler The scheduler whose alarms are served (not owned).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AlarmService(AlarmScheduler *scheduler, QObject *parent = nullptr);
+
+    /**
+     * @brief Frees every snapshot; no reader may still be inside snapshot().
+     */
+    ~AlarmService() override;
+
+    /**
+     * @brief Returns the latest snapshot.
+     *
+     * On the service's thread it is the current state. Other threads get
+     * the latest published snapshot without blocking, or an empty one if
+     * they have not attached as readers.
+     */
+    AlarmServiceSnapshot snapshot() const;
+
+    /**
+     * @brief Returns the alarms of snapshot().
+     */
+    QVector<Alarm> alarms() const { return snapshot().alarms(); }
+
+    /**
+     * @brief Starts publishing snapshots for a thread other than the service's.
+     *
+     * The first reader to attach waits once for the service's thread to
+     * publish, so that snapshot() is current when this returns. Does nothing
+     * on the service's thread, whose reads need no publishing.
+     */
+    void attachReader();
+
+    /**
+     * @brief Ends an attachReader(); once the last reader is gone, publishing stops.
+     */
+    void detachReader();
+
+    /**
+     * @brief Returns the store version after the latest change; safe from any thread.
+     */
+    quint64 version() const { return publishedVersion.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Adds an alarm (applied on the service's thread).
+     */
+    void addAlarm(QTime time, const QString &repeat, const QString &label, const QString &sound,
+                  const QString &calendar = QString(), const QString &group = QString());
+
+    /**
+     * @brief Replaces the alarm with the same id (applied on the service's thread).
+     */
+    void updateAlarm(const Alarm &alarm);
+
+    /**
+     * @brief Removes an alarm (applied on the service's thread).
+     */
+    void removeAlarm(quint64 id);
+
+    /**
+     * @brief Switches every alarm of a group on or off (applied on the service's thread).
+     */
+    void setGroupEnabled(const QString &group, bool enabled);
+
+    /**
+     * @brief Snoozes an alarm (applied on the service's thread).
+     */
+    void snooze(quint64 id, int minutes);
+
+    /**
+     * @brief Dismisses an alarm (applied on the service's thread).
+     */
+    void dismiss(quint64 id);
+
+signals:
+    /**
+     * @brief Emitted on the service's thread after every change of the alarms or of their next fire instants.
+     * @param version The store version after the change.
+     */
+    void published(quint64 version);
+
+private:
+    /**
+     * @brief Heap cell holding one published snapshot.
+     */
+    struct State {
+        AlarmServiceSnapshot snapshot; ///< The published value.
+    };
+
+    /**
+     * @brief One reader's announcement of the epoch it is reading in (0 when free).
+     *
+     * Aligned to a cache line so that readers on different cores do not
+     * contend for the same line.
+     */
+    struct alignas(64) ReaderSlot {
+        std::atomic<quint64> epoch{0}; ///< Epoch of the reader using the slot, or 0.
+    };
+
+    static const int ReaderSlots = 64; ///< Readers that can copy a snapshot at the same moment.
+
+    /**
+     * @brief Returns a snapshot of the current store and table (service's thread only).
+     */
+    AlarmServiceSnapshot build() const;
+
+    /**
+     * @brief Swaps in a snapshot of the current store and table while readers are attached, or retires the published one.
+     */
+    void publish();
+
+    /**
+     * @brief Retires the published snapshot if no reader is attached any more.
+     */
+    void unpin();
+
+    /**
+     * @brief Replaces the published state (nullptr to publish nothing).
+     */
+    void swapIn(const State *state);
+
+    /**
+     * @brief Deletes the replaced snapshots no reader can still be copying.
+     */
+    void reclaim();
+
+    /**
+     * @brief Runs a mutation on the service's thread.
+     */
+    void post(std::function<void()> mutation);
+
+    AlarmScheduler *alarmScheduler; ///< Source of the alarms; only touched on the service's thread.
+    std::atomic<const State *> current{nullptr}; ///< Published snapshot.
+    std::atomic<quint64> epoch{1}; ///< Incremented every time a snapshot is replaced.
+    std::atomic<quint64> publishedVersion{0}; ///< Store version after the latest change.
+    std::atomic<int> attachedReaders{0}; ///< Threads that called attachReader() and not yet detachReader().
+    QMutex attachMutex; ///< Serializes attaching and detaching readers.
+    mutable ReaderSlot readers[ReaderSlots]; ///< Epochs of readers inside snapshot().
+    QVector<QPair<quint64, const State *>> retired; ///< Replaced snapshots and the epoch they were replaced in.
+    QTimer reclaimTimer; ///< Retries reclamation when readers were busy during publish().
+};
+
+#endif // ALARMSERVICE_H
@@ -0,0 +1,232 @@
+/**
+ * @file alarmstore.h
+ * @brief Header file for the AlarmStore class.
+ *
+ * This file defines the AlarmStore class, the single source of truth for the
+ * alarm list, together with the immutable AlarmSnapshot it hands out and the
+ * AlarmChange records it emits whenever the list changes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALARMSTORE_H
+#define ALARMSTORE_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QStringList>
+#include <QVector>
+#include "alarm.h"
+
+/**
+ * @class AlarmSnapshot
+ * @brief An immutable, versioned view of the alarm list.
+ *
+ * Snapshots are implicitly shared: copying one is O(1), and the store only
+ * copies its list when it is modified while an older snapshot is still held.
+ * Holding a snapshot across changes therefore costs one copy of the list
+ * (on the first change), not one per change; code that keeps snapshots
+ * around should take a new one only when it needs to read again.
+ */
+class AlarmSnapshot {
+public:
+    /**
+     * @brief Constructs an empty snapshot at version 0.
+     */
+    AlarmSnapshot();
+
+    /**
+     * @brief Returns the version of the store this snapshot was taken at.
+     */
+    quint64 version() const { return d->version; }
+
+    /**
+     * @brief Returns the alarms in display order.
+     */
+    const QVector<Alarm> &alarms() const { return d->alarms; }
+
+    /**
+     * @brief Finds an alarm by id in constant time.
+     * @param id The id of the alarm.
+     * @return The index of the alarm, or -1 if it is not in this snapshot.
+     */
+    int indexOf(quint64 id) const { return d->indexById.value(id, -1); }
+
+private:
+    friend class AlarmStore;
+
+    /**
+     * @brief Shared payload of a snapshot.
+     */
+    struct Data : public QSharedData {
+        quint64 version = 0; ///< Store version.
+        QVector<Alarm> alarms; ///< Alarms in display order.
+        QHash<quint64, int> indexById; ///< Index of each alarm in alarms.
+    };
+
+    QSharedDataPointer<Data> d; ///< Shared snapshot data.
+};
+
+/**
+ * @struct AlarmChange
+ * @brief One entry of the change stream emitted by the AlarmStore.
+ */
+struct AlarmChange {
+    /**
+     * @brief What happened to the alarm.
+     */
+    enum Kind {
+        Added,   ///< The alarm is new.
+        Updated, ///< The alarm's fields changed.
+        Removed  ///< The alarm was removed.
+    };
+
+    Kind kind;  ///< What happened.
+    quint64 id; ///< Id of the affected alarm.
+    int index;  ///< Index in the new snapshot (-1 for Removed).
+};
+
+/**
+ * @class AlarmStore
+ * @brief Owns the alarm list and publishes snapshots and change deltas.
+ *
+ * Every mutation bumps the version and emits changed() with the list of
+ * alarms that were added, updated or removed, so views can patch themselves
+ * instead of rebuilding from a full copy. Views that fall behind (or start
+ * late) can resynchronise from snapshot().
+ *
+ * The store also indexes the alarms by group, so the k alarms of a group are
+ * found without scanning the list and switching them on or off is a single
+ * change of k updates.
+ */
+class AlarmStore : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty store.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit AlarmStore(QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the current snapshot (O(1)).
+     */
+    AlarmSnapshot snapshot() const { return current; }
+
+    /**
+     * @brief Returns the current version.
+     */
+    quint64 version() const { return current.version(); }
+
+    /**
+     * @brief Returns how many changes had to copy the whole list because a snapshot of the previous version was held.
+     */
+    quint64 detachCount() const { return detaches; }
+
+    /**
+     * @brief Returns the current alarms without taking a snapshot.
+     */
+    const QVector<Alarm> &alarms() const { return current.alarms(); }
+
+    /**
+     * @brief Returns the alarm with the given id, or nullptr.
+     */
+    const Alarm *find(quint64 id) const;
+
+    /**
+     * @brief Adds an alarm and assigns it a new id.
+     * @param alarm The alarm to add (its id is ignored).
+     * @return The id given to the alarm.
+     */
+    quint64 add(const Alarm &alarm);
+
+    /**
+     * @brief Replaces the alarm with the same id.
+     * @param alarm The new contents of the alarm.
+     * @return False if no alarm has that id.
+     */
+    bool update(const Alarm &alarm);
+
+    /**
+     * @brief Removes an alarm.
+     * @param id The id of the alarm.
+     * @return False if no alarm has that id.
+     */
+    bool remove(quint64 id);
+
+    /**
+     * @brief Applies several changes as one version.
+     *
+     * Removals are applied first, then updates, then additions (which are
+     * appended in order and receive new ids). Exactly one changed() signal is
+     * emitted, or none if nothing changed.
+     *
+     * @param added Alarms to append.
+     * @param updated Alarms to replace, matched by id.
+     * @param removed Ids of alarms to remove.
+     * @return The ids given to the added alarms.
+     */
+    QVector<quint64> apply(const QVector<Alarm> &added, const QVector<Alarm> &updated, const QSet<quint64> &removed);
+
+    /**
+     * @brief Returns the names of the groups at least one alarm belongs to, sorted.
+     */
+    QStringList groupNames() const;
+
+    /**
+     * @brief Returns the ids of the alarms in a group.
+     */
+    QSet<quint64> groupMembers(const Label &group) const { return groupIndex.value(group); }
+
+    /**
+     * @brief Switches alarms on or off as one change.
+     *
+     * Only the alarms whose flag differs are updated, so views and the
+     * scheduler see at most one update per affected alarm.
+     *
+     * @param ids The ids of the alarms.
+     * @param enabled The new state.
+     * @return The number of alarms whose state changed.
+     */
+    int setEnabled(const QSet<quint64> &ids, bool enabled);
+
+    /**
+     * @brief Switches every alarm of a group on or off as one change.
+     * @return The number of alarms whose state changed.
+     */
+    int setGroupEnabled(const Label &group, bool enabled) { return setEnabled(groupMembers(group), enabled); }
+
+signals:
+    /**
+     * @brief Emitted after every mutation.
+     * @param fromVersion The version before the change.
+     * @param toVersion The version after the change.
+     * @param changes What changed, removals first.
+     */
+    void changed(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+private:
+    /**
+     * @brief Adds an alarm to its group's entry in groupIndex.
+     */
+    void indexGroup(const Alarm &alarm);
+
+    /**
+     * @brief Removes an alarm from its group's entry in groupIndex.
+     */
+    void unindexGroup(const Alarm &alarm);
+
+    AlarmSnapshot current; ///< The current contents.
+    quint64 nextId = 1; ///< Id given to the next added alarm.
+    quint64 detaches = 0; ///< Changes that copied the list (see detachCount()).
+    QHash<Label, QSet<quint64>> groupIndex; ///< Ids of the alarms in each non-empty group.
+};
+
+Q_DECLARE_METATYPE(AlarmChange)
+
+#endif // ALARMSTORE_H
@@ -0,0 +1,95 @@
+/**
+ * @file allocationcounter.h
+ * @brief Process-wide heap allocation counters.
+ *
+ * This file declares the AllocationCounter functions, which report how many
+ * heap blocks the process has allocated and freed, and the AllocationProbe
+ * class, which counts the allocations made by the calling thread within a
+ * scope. They back the heap line of the profiler overlay and the
+ * allocation check of the benchmark.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+namespace AllocationCounter {
+
+/**
+ * @brief Returns true if allocations are counted in this program.
+ *
+ * Counting needs the allocation hooks, which wrap the C library's malloc
+ * that every Qt container and operator new end up in. They only exist for
+ * glibc and are opt-in: a program links them by including
+ * alarmcore/allocationhooks.pri (wheelbench does, the app with
+ * CONFIG+=heapcount). Elsewhere every counter stays 0.
+ */
+bool isAvailable();
+
+/**
+ * @brief Returns the number of heap blocks allocated by all threads so far.
+ */
+quint64 allocations();
+
+/**
+ * @brief Returns the number of heap blocks freed by all threads so far.
+ */
+quint64 frees();
+
+/**
+ * @brief Returns the number of heap blocks allocated by the calling thread so far.
+ */
+quint64 threadAllocations();
+
+/**
+ * @brief Marks the counters as live; called once by the allocation hooks.
+ */
+void setAvailable() noexcept;
+
+/**
+ * @brief Counts one allocated block; called by the allocation hooks.
+ */
+void countAllocation() noexcept;
+
+/**
+ * @brief Counts one freed block; called by the allocation hooks.
+ */
+void countFree() noexcept;
+
+} // namespace AllocationCounter
+
+/**
+ * @class AllocationProbe
+ * @brief Counts the heap allocations the calling thread makes while the probe lives.
+ *
+ * Used as a test hook around code that must not allocate:
+ * @code
+ * AllocationProbe probe;
+ * scheduler.dueAlarms(now);
+ * Q_ASSERT(probe.count() == 0);
+ * @endcode
+ * Allocations of other threads are not counted.
+ */
+class AllocationProbe {
+public:
+    AllocationProbe() : start(AllocationCounter::threadAllocations()) {}
+
+    /**
+     * @brief Returns the allocations made since construction or the last restart().
+     */
+    quint64 count() const { return AllocationCounter::threadAllocations() - start; }
+
+    /**
+     * @brief Starts counting from zero again.
+     */
+    void restart() { start = AllocationCounter::threadAllocations(); }
+
+private:
+    quint64 start; ///< Thread allocation count when counting started.
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,88 @@
+/**
+ * @file clockface.h
+ * @brief Header file for the ClockFace class.
+ *
+ * This file defines the ClockFace class, a custom-painted "hh:mm:ss"
+ * seven-segment display that replaces QLCDNumber in the ClockWidget.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef CLOCKFACE_H
+#define CLOCKFACE_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QRect>
+
+/**
+ * @class ClockFace
+ * @brief A seven-segment clock display with cached glyphs and partial repaints.
+ *
+ * The digit and colon glyphs are rendered once into a pixmap atlas for the
+ * current size and device pixel ratio. The atlas is kept in QPixmapCache, so
+ * faces of the same size and colours (such as the rows of the world clock)
+ * share a single copy. Setting a new time only schedules a
+ * repaint of the cells whose digit actually changed (usually just the
+ * seconds), and no strings are built per tick.
+ */
+class ClockFace : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a ClockFace showing 00:00:00.
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit ClockFace(QWidget *parent = nullptr);
+
+    /**
+     * @brief Shows a new time, repainting only the digits that changed.
+     * @param hour The hour (0-23).
+     * @param minute The minute (0-59).
+     * @param second The second (0-59).
+     */
+    void setTime(int hour, int minute, int second);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    static const int CellCount = 8;   ///< Cells in "hh:mm:ss".
+    static const int ColonGlyph = 10; ///< Atlas index of the colon glyph.
+
+    /**
+     * @brief Recomputes the cell rectangles for the current widget size.
+     */
+    void layoutCells();
+
+    /**
+     * @brief Renders the eleven glyphs into the atlas for the current size and DPI.
+     */
+    void rebuildAtlas();
+
+    /**
+     * @brief Returns the QPixmapCache key of the atlas for the current size, DPI and palette.
+     */
+    QString atlasKey() const;
+
+    /**
+     * @brief Returns the atlas glyph shown in a cell.
+     */
+    int glyphForCell(int cell) const;
+
+    QPixmap atlas;              ///< Pre-rendered digits 0-9 followed by the colon.
+    qreal atlasRatio = 0;       ///< Device pixel ratio the atlas was rendered for.
+    QSize digitSize;            ///< Size of a digit cell in device-independent pixels.
+    QSize colonSize;            ///< Size of a colon cell in device-independent pixels.
+    QRect cells[CellCount];     ///< Position of each cell in the widget.
+    int digits[6] = {0, 0, 0, 0, 0, 0}; ///< Displayed digits (h h m m s s).
+};
+
+#endif // CLOCKFACE_H
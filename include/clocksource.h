@@ -0,0 +1,118 @@
+/**
+ * @file clocksource.h
+ * @brief Header file for the ClockSource classes.
+ *
+ * This file defines the ClockSource interface through which the application
+ * reads the current time and a monotonic time base, together with the real
+ * system clock and a virtual clock that can be set and advanced manually
+ * (used by the simulator).
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef CLOCKSOURCE_H
+#define CLOCKSOURCE_H
+
+#include <QDateTime>
+
+/**
+ * @class ClockSource
+ * @brief Abstract source of the current date and time.
+ *
+ * Every part of the application that needs "now" asks a ClockSource instead of
+ * calling QTime::currentTime() or QDateTime::currentDateTimeUtc() directly, so
+ * that the scheduler can be driven by a virtual clock.
+ */
+class ClockSource {
+public:
+    virtual ~ClockSource() = default;
+
+    /**
+     * @brief Returns the current instant in UTC.
+     * @return The current date and time in UTC.
+     */
+    virtual QDateTime currentDateTimeUtc() const = 0;
+
+    /**
+     * @brief Returns the current instant in the local time zone.
+     * @return The current local date and time.
+     */
+    QDateTime currentDateTime() const { return currentDateTimeUtc().toLocalTime(); }
+
+    /**
+     * @brief Returns a time base that only ever moves forward at a steady rate.
+     *
+     * Unlike the wall clock it does not jump when the date or time is set,
+     * so durations (countdown timers, the stopwatch) are measured on it.
+     *
+     * @return Milliseconds since an unspecified start.
+     */
+    virtual qint64 monotonicMSecs() const = 0;
+
+    /**
+     * @brief Returns the shared clock backed by the real system time.
+     * @return Pointer to the system clock (never nullptr, never deleted).
+     */
+    static ClockSource *system();
+};
+
+/**
+ * @class SystemClock
+ * @brief ClockSource that reads the real system time.
+ */
+class SystemClock : public ClockSource {
+public:
+    QDateTime currentDateTimeUtc() const override;
+
+    /**
+     * @brief Reads CLOCK_MONOTONIC (or the platform's equivalent) through QElapsedTimer.
+     */
+    qint64 monotonicMSecs() const override;
+};
+
+/**
+ * @class VirtualClock
+ * @brief ClockSource whose time only moves when told to.
+ *
+ * The virtual clock stores the current instant as milliseconds since the epoch
+ * and can be set to any instant (to simulate clock jumps) or advanced by an
+ * arbitrary amount, so a full year can be replayed as fast as the CPU allows.
+ * Only advance() moves its monotonic time; jumps leave it alone.
+ */
+class VirtualClock : public ClockSource {
+public:
+    /**
+     * @brief Constructs a virtual clock starting at the given instant.
+     * @param start The initial date and time (any time spec).
+     */
+    explicit VirtualClock(const QDateTime &start = QDateTime::fromMSecsSinceEpoch(0, Qt::UTC));
+
+    QDateTime currentDateTimeUtc() const override;
+    qint64 monotonicMSecs() const override { return monotonic; }
+
+    /**
+     * @brief Moves the clock to the given instant (forwards or backwards).
+     * @param dateTime The new current date and time.
+     */
+    void setCurrentDateTime(const QDateTime &dateTime);
+
+    /**
+     * @brief Advances the clock.
+     * @param msecs Number of milliseconds to move forward (negative moves back; the
+     *              monotonic time never does).
+     */
+    void advance(qint64 msecs);
+
+    /**
+     * @brief Returns the current instant as milliseconds since the epoch.
+     * @return Milliseconds since 1970-01-01T00:00:00Z.
+     */
+    qint64 currentMSecsSinceEpoch() const { return msecsSinceEpoch; }
+
+private:
+    qint64 msecsSinceEpoch; ///< Current virtual instant.
+    qint64 monotonic = 0; ///< Milliseconds advanced since construction.
+};
+
+#endif // CLOCKSOURCE_H
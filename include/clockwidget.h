@@ -13,13 +13,15 @@
 #define CLOCKWIDGET_H
 
 #include <QWidget>
-#include <QLCDNumber>
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QTime>
 #include <QTimeZone>
 #include <QComboBox>
 #include <QLabel>
+#include "clockface.h"
+#include "clocksource.h"
+#include "zoneoffsettable.h"
 
 /**
  * @class ClockWidget
@@ -39,10 +41,11 @@ public:
      *
      * Initializes the clock display and timezone selection dropdown.
      *
+     * @param clock The clock to read the time from (default is the system clock).
      * @param parent The parent widget (default is nullptr).
      */
 
-    explicit ClockWidget(QWidget *parent = nullptr);
+    explicit ClockWidget(ClockSource *clock = nullptr, QWidget *parent = nullptr);
 
 private slots:
 
@@ -65,10 +68,12 @@ private slots:
     void changeTimezone(const QString &timezoneId); 
 
 private:
-    QLCDNumber *clockDisplay; ///< Display for showing the current time
+    ClockFace *clockDisplay; ///< Display for showing the current time
     QComboBox *timezoneSelector; // Dropdown for timezone selection
     QLabel *timezoneLabel; ///< Label for displaying timezone information.
     QTimeZone currentTimeZone; ///< Stores the currently selected timezone.
+    ZoneOffsetTable zoneOffsets; ///< Cached offset of currentTimeZone (one entry).
+    ClockSource *clockSource; ///< Source of the current time.
 };
 
 #endif // CLOCKWIDGET_H
@@ -0,0 +1,154 @@
+/**
+ * @file countdowntimers.h
+ * @brief Header file for the CountdownTimers class.
+ *
+ * This file defines the CountdownTimers class, which runs any number of
+ * kitchen or lab timers at once on a shared DeadlineScheduler, and the
+ * CountdownTimer values it keeps.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef COUNTDOWNTIMERS_H
+#define COUNTDOWNTIMERS_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "deadlinescheduler.h"
+
+/**
+ * @struct CountdownTimer
+ * @brief One countdown and where it stands.
+ */
+struct CountdownTimer {
+    quint64 id = 0;          ///< Unique id within the CountdownTimers.
+    QString label;           ///< Name shown in the timer list.
+    qint64 durationMs = 0;   ///< Length set by the user.
+    qint64 remainingMs = 0;  ///< Time left when not running.
+    qint64 deadline = 0;     ///< Monotonic time it ends at while running.
+    quint64 handle = 0;      ///< DeadlineScheduler handle while running, else 0.
+    bool finished = false;   ///< Ran down to zero and has not been reset since.
+
+    /**
+     * @brief Returns true while the timer counts down.
+     */
+    bool isRunning() const { return handle != 0; }
+
+    /**
+     * @brief Returns the time left at a monotonic instant, never below zero.
+     * @param now Monotonic time in ms.
+     */
+    qint64 remainingAt(qint64 now) const { return isRunning() ? qMax<qint64>(0, deadline - now) : remainingMs; }
+};
+
+/**
+ * @class CountdownTimers
+ * @brief A list of countdown timers sharing one DeadlineScheduler.
+ *
+ * A running timer is nothing but a deadline on the monotonic clock, so
+ * pausing and resuming are exact, a wall-clock change does not shorten or
+ * lengthen any of them, and no timer needs a QTimer of its own. The time
+ * left is computed when asked, which is how the display reads it.
+ */
+class CountdownTimers : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty timer list.
+     * @param scheduler Scheduler the deadlines are kept in (not owned).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit CountdownTimers(DeadlineScheduler *scheduler, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the clock the timers run on.
+     */
+    ClockSource *clock() const { return deadlineScheduler->clock(); }
+
+    /**
+     * @brief Returns the timers in the order they were added.
+     */
+    const QVector<CountdownTimer> &timers() const { return list; }
+
+    /**
+     * @brief Returns the timer with the given id, or nullptr.
+     */
+    const CountdownTimer *find(quint64 id) const;
+
+    /**
+     * @brief Returns the number of running timers.
+     */
+    int runningCount() const { return byHandle.size(); }
+
+    /**
+     * @brief Adds a stopped timer.
+     * @param label The name of the timer.
+     * @param durationMs Its length in milliseconds (must be positive).
+     * @return The id of the new timer, or 0 if the duration is not positive.
+     */
+    quint64 add(const QString &label, qint64 durationMs);
+
+    /**
+     * @brief Starts or resumes a timer; a finished timer starts over.
+     */
+    void start(quint64 id);
+
+    /**
+     * @brief Stops a timer, keeping the time left.
+     */
+    void pause(quint64 id);
+
+    /**
+     * @brief Stops a timer and sets it back to its full length.
+     */
+    void reset(quint64 id);
+
+    /**
+     * @brief Removes a timer.
+     */
+    void remove(quint64 id);
+
+signals:
+    /**
+     * @brief Emitted after a timer was added.
+     */
+    void added(quint64 id);
+
+    /**
+     * @brief Emitted after a timer was removed.
+     */
+    void removed(quint64 id);
+
+    /**
+     * @brief Emitted when a timer is started, paused, reset or finished.
+     */
+    void stateChanged(quint64 id);
+
+    /**
+     * @brief Emitted when a timer runs down to zero (after stateChanged()).
+     */
+    void finished(quint64 id);
+
+private slots:
+    /**
+     * @brief Finishes the timer whose deadline was reached.
+     */
+    void onExpired(quint64 handle);
+
+private:
+    /**
+     * @brief Returns the index of a timer in the list, or -1.
+     */
+    int indexOf(quint64 id) const;
+
+    DeadlineScheduler *deadlineScheduler; ///< Shared deadline queue (not owned).
+    QVector<CountdownTimer> list; ///< Timers in the order they were added.
+    QHash<quint64, quint64> byHandle; ///< Timer id of every running deadline.
+    quint64 lastId = 0; ///< Source of new ids.
+};
+
+#endif // COUNTDOWNTIMERS_H
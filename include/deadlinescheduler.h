@@ -0,0 +1,104 @@
+/**
+ * @file deadlinescheduler.h
+ * @brief Header file for the DeadlineScheduler class.
+ *
+ * This file defines the DeadlineScheduler class, which lets any number of
+ * countdowns wait for their deadline on the monotonic clock through a single
+ * timer.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <set>
+#include <utility>
+#include "clocksource.h"
+
+/**
+ * @class DeadlineScheduler
+ * @brief Ordered set of monotonic deadlines served by one precise timer.
+ *
+ * Deadlines are kept sorted, and the one QTimer is always armed for the
+ * earliest of them only, so a hundred running countdowns cost one timer and
+ * one wake-up per deadline rather than one timer each. Adding or cancelling
+ * a deadline is O(log n).
+ *
+ * Deadlines are in ClockSource::monotonicMSecs(), so setting the date or
+ * time does not move them. With a VirtualClock the timer does not follow the
+ * virtual time; whoever advances the clock calls poll().
+ */
+class DeadlineScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static const qint64 NoDeadline; ///< nextDeadline() when nothing is scheduled.
+
+    /**
+     * @brief Constructs an empty scheduler.
+     * @param clock Clock whose monotonic time the deadlines are in (nullptr means the system clock).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit DeadlineScheduler(ClockSource *clock = nullptr, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the clock the deadlines are measured on.
+     */
+    ClockSource *clock() const { return clockSource; }
+
+    /**
+     * @brief Adds a deadline.
+     * @param deadline Monotonic time to expire at, in ms; a past one expires on the next pass of the event loop.
+     * @return Handle passed to expired() and cancel() (never 0).
+     */
+    quint64 schedule(qint64 deadline);
+
+    /**
+     * @brief Removes a deadline that has not expired yet.
+     * @param handle The handle returned by schedule().
+     * @return False if the handle is unknown or already expired.
+     */
+    bool cancel(quint64 handle);
+
+    /**
+     * @brief Returns the earliest deadline, or NoDeadline.
+     */
+    qint64 nextDeadline() const { return queue.empty() ? NoDeadline : queue.begin()->first; }
+
+    /**
+     * @brief Returns the number of deadlines waiting.
+     */
+    int pending() const { return deadlines.size(); }
+
+public slots:
+    /**
+     * @brief Reports every deadline that has been reached, earliest first.
+     */
+    void poll();
+
+signals:
+    /**
+     * @brief Emitted once when a deadline is reached.
+     * @param handle The handle returned by schedule().
+     */
+    void expired(quint64 handle);
+
+private:
+    /**
+     * @brief Arms the timer for the earliest deadline, or stops it.
+     */
+    void rearm();
+
+    ClockSource *clockSource; ///< Source of the monotonic time.
+    std::set<std::pair<qint64, quint64>> queue; ///< (deadline, handle), earliest first.
+    QHash<quint64, qint64> deadlines; ///< Deadline of every waiting handle.
+    quint64 lastHandle = 0; ///< Source of new handles.
+    QTimer timer; ///< Fires at the earliest deadline.
+};
+
+#endif // DEADLINESCHEDULER_H
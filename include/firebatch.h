@@ -0,0 +1,94 @@
+/**
+ * @file firebatch.h
+ * @brief Header file for the FireBatch class.
+ *
+ * This file defines the FireBatch class, which collects the alarms due at
+ * one instant across every loaded profile and builds the text announcing
+ * them, reusing its buffers from one firing to the next.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef FIREBATCH_H
+#define FIREBATCH_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+#include "alarmprofiles.h"
+
+/**
+ * @class FireBatch
+ * @brief The alarms due at one instant, per scheduler, with their announcement.
+ *
+ * collect() is called once a second by the main window. The per-scheduler
+ * id lists, the message and the detailed text are members that are cleared
+ * with their capacity kept, so once they have grown to the largest batch
+ * seen, a firing allocates nothing here (wheelbench --fire-allocs checks
+ * this). Whoever shows the texts should drop its copies before the next
+ * collect(), or that call copies them instead of reusing them.
+ */
+class FireBatch {
+public:
+    /**
+     * @brief The alarms one scheduler reported due.
+     */
+    struct Part {
+        AlarmScheduler *scheduler = nullptr; ///< Scheduler of the profile the alarms belong to.
+        QVector<quint64> ids;                ///< Due alarms (reused between firings).
+    };
+
+    static const int ShownLabels = 10; ///< Labels listed in message(); the rest only in details().
+
+    /**
+     * @brief Loads the profiles about to ring and collects what every loaded one has due.
+     *
+     * The labels are prefixed with their profile's name as soon as more than
+     * one profile is loaded.
+     *
+     * @param profiles The profiles to check.
+     * @param now The current local date and time.
+     * @return The number of due alarms.
+     */
+    int collect(AlarmProfiles &profiles, const QDateTime &now);
+
+    /**
+     * @brief Returns the number of alarms collected by the latest collect().
+     */
+    int count() const { return dueCount; }
+
+    /**
+     * @brief Returns true if nothing was due.
+     */
+    bool isEmpty() const { return dueCount == 0; }
+
+    /**
+     * @brief Returns the first due alarm, whose sound is played for the batch.
+     */
+    const Alarm *first() const;
+
+    /**
+     * @brief Returns the text announcing the batch (the first labels for large ones).
+     */
+    const QString &message() const { return messageText; }
+
+    /**
+     * @brief Returns every label, one per line, when message() does not list them all ("" otherwise).
+     */
+    const QString &details() const { return detailText; }
+
+    const Part *begin() const { return parts.constData(); }
+    const Part *end() const { return parts.constData() + usedParts; }
+
+private:
+    void appendLabel(QString &text, const QString &prefix, const Alarm &alarm) const;
+
+    QVector<Part> parts;     ///< Per-scheduler batches; only the first usedParts are current.
+    int usedParts = 0;       ///< Schedulers with due alarms in the latest collect().
+    int dueCount = 0;        ///< Due alarms in the latest collect().
+    QString messageText;     ///< Text of the latest batch (reused).
+    QString detailText;      ///< All labels of the latest batch, if not all are in messageText (reused).
+};
+
+#endif // FIREBATCH_H
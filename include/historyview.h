@@ -0,0 +1,95 @@
+/**
+ * @file historyview.h
+ * @brief Header file for the HistoryView class.
+ *
+ * This file defines the HistoryView widget, the History tab of the View
+ * Alarms window, and the HistoryModel table model behind it.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef HISTORYVIEW_H
+#define HISTORYVIEW_H
+
+#include <QAbstractTableModel>
+#include <QComboBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTimer>
+#include <QWidget>
+#include "alarmhistory.h"
+
+/**
+ * @class HistoryModel
+ * @brief Read-only table of history records (when, event, label, alarm time).
+ *
+ * The model only stores the sequence number of each row; cells are read
+ * out of the history file's mapping when the view paints them.
+ */
+class HistoryModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty model.
+     * @param history The history to read records from.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit HistoryModel(AlarmHistory *history, QObject *parent = nullptr);
+
+    /**
+     * @brief Replaces the rows.
+     * @param sequences Sequences of the records to show, in display order.
+     */
+    void setSequences(const QVector<quint64> &sequences);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    AlarmHistory *alarmHistory; ///< Source of the records.
+    QVector<quint64> rows; ///< Sequence of each row.
+};
+
+/**
+ * @class HistoryView
+ * @brief Lists recorded fire, snooze and dismiss events, newest first.
+ *
+ * The list can be narrowed to one kind of event, a time range and a label.
+ * It is refreshed when shown, when a filter changes and (at most every
+ * half second) when new records are written while it is visible.
+ */
+class HistoryView : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the view.
+     * @param history The history to show.
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit HistoryView(AlarmHistory *history, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    /**
+     * @brief Runs the query for the current filters and updates the table.
+     */
+    void refresh();
+
+private:
+    AlarmHistory *alarmHistory; ///< History being shown.
+    HistoryModel *model; ///< Rows of the table.
+    QComboBox *kindSelector; ///< All events / fired / snoozed / dismissed.
+    QComboBox *rangeSelector; ///< Last 24 hours / 7 days / everything.
+    QLineEdit *labelFilter; ///< Part of the label to look for.
+    QLabel *summaryLabel; ///< Number of events shown and kept.
+    QTimer refreshTimer; ///< Coalesces refreshes caused by new records.
+};
+
+#endif // HISTORYVIEW_H
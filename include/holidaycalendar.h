@@ -0,0 +1,139 @@
+/**
+ * @file holidaycalendar.h
+ * @brief Header file for the HolidayCalendar and HolidayCalendars classes.
+ *
+ * This file defines HolidayCalendar, a set of excluded dates (public
+ * holidays, vacations, site closures), and HolidayCalendars, the named
+ * collection of calendars that alarms refer to.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef HOLIDAYCALENDAR_H
+#define HOLIDAYCALENDAR_H
+
+#include <QDate>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @class HolidayCalendar
+ * @brief A set of excluded dates stored as sorted, disjoint day intervals.
+ *
+ * Adjacent and overlapping ranges are merged when added, so a calendar with
+ * a two-week vacation and a dozen holidays holds about a dozen intervals and
+ * contains() is a binary search over them.
+ */
+class HolidayCalendar {
+public:
+    /**
+     * @brief An inclusive range of Julian days.
+     */
+    struct Interval {
+        qint64 first; ///< First excluded day.
+        qint64 last;  ///< Last excluded day.
+    };
+
+    /**
+     * @brief Excludes a single date.
+     */
+    void addDate(const QDate &date) { addRange(date, date); }
+
+    /**
+     * @brief Excludes every date from first to last, inclusive.
+     */
+    void addRange(const QDate &first, const QDate &last);
+
+    /**
+     * @brief Returns true if the date is excluded (O(log n)).
+     */
+    bool contains(const QDate &date) const;
+
+    /**
+     * @brief Returns the excluded ranges, sorted.
+     */
+    const QVector<Interval> &intervals() const { return ranges; }
+
+    /**
+     * @brief Returns true if no date is excluded.
+     */
+    bool isEmpty() const { return ranges.isEmpty(); }
+
+private:
+    QVector<Interval> ranges; ///< Sorted, non-overlapping, non-adjacent ranges.
+};
+
+/**
+ * @class HolidayCalendars
+ * @brief Named holiday calendars that alarms refer to by name.
+ *
+ * An alarm whose Alarm::calendar names a calendar does not ring on the
+ * calendar's dates. Looking up whether a date is excluded is one hash
+ * lookup plus a binary search, so it is cheap enough for the fire path.
+ */
+class HolidayCalendars : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty collection.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit HolidayCalendars(QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the calendar names, sorted.
+     */
+    QStringList names() const;
+
+    /**
+     * @brief Returns the calendar with the given name, or nullptr.
+     */
+    const HolidayCalendar *calendar(const QString &name) const;
+
+    /**
+     * @brief Adds or replaces a calendar.
+     */
+    void setCalendar(const QString &name, const HolidayCalendar &calendar);
+
+    /**
+     * @brief Removes a calendar; alarms referring to it ring normally again.
+     */
+    void removeCalendar(const QString &name);
+
+    /**
+     * @brief Returns true if the named calendar excludes the date.
+     * @param name Calendar name ("" or an unknown name excludes nothing).
+     * @param date The date to check.
+     */
+    bool excludes(const QString &name, const QDate &date) const;
+
+    /**
+     * @brief Loads calendars from a text file.
+     *
+     * The file has one date ("2025-12-25") or range ("2025-12-24..2025-12-31")
+     * per line, optionally followed by a description. "[name]" lines start a
+     * new calendar; dates before the first one go into a calendar named after
+     * the file. "#" starts a comment. Calendars in the file replace existing
+     * calendars of the same name.
+     *
+     * @param path The file to read.
+     * @param error Receives a description of the first problem, if any.
+     * @return The names of the calendars loaded, empty on error.
+     */
+    QStringList importFile(const QString &path, QString *error = nullptr);
+
+signals:
+    /**
+     * @brief Emitted whenever a calendar is added, replaced or removed.
+     */
+    void changed();
+
+private:
+    QHash<QString, HolidayCalendar> calendars; ///< Calendars by name.
+};
+
+#endif // HOLIDAYCALENDAR_H
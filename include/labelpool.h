@@ -0,0 +1,186 @@
+/**
+ * @file labelpool.h
+ * @brief Header file for the Label and LabelPool classes.
+ *
+ * This file defines the LabelPool, which stores every distinct alarm label
+ * once, and the Label handle the alarms hold instead of a string of their
+ * own.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef LABELPOOL_H
+#define LABELPOOL_H
+
+#include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @class LabelPool
+ * @brief Process-wide, reference-counted intern table of label texts.
+ *
+ * Each distinct text is stored once and identified by a 32-bit handle;
+ * handle 0 is the empty label. The entries live in fixed chunks that never
+ * move, so reading the text of a handle one holds a reference to takes no
+ * lock and is safe from any thread (the alarm snapshots are read from many).
+ * Interning and freeing take a mutex. When the last reference to a text
+ * goes away its handle is reused for the next new text.
+ *
+ * Every text is kept in a QString whose buffer is shared with everyone who
+ * reads it, so even reading a label never allocates. Code uses the pool
+ * through Label; the pool itself only shows up in statistics.
+ */
+class LabelPool {
+public:
+    /**
+     * @brief Returns the pool; it is never destroyed, so labels in static objects stay valid.
+     */
+    static LabelPool &instance();
+
+    /**
+     * @brief Returns the handle of a text, adding the text if it is new, and takes a reference.
+     * @return The handle (0 for an empty text, which takes no reference).
+     */
+    quint32 intern(const QString &text);
+
+    /**
+     * @brief Takes another reference to a handle one already holds.
+     */
+    void retain(quint32 handle) {
+        if (handle != 0) entry(handle).refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops a reference; the text is freed with the last one.
+     */
+    void release(quint32 handle);
+
+    /**
+     * @brief Returns the text of a handle one holds a reference to.
+     */
+    const QString &text(quint32 handle) const;
+
+    /**
+     * @brief Returns the number of distinct texts stored.
+     */
+    int size() const;
+
+    /**
+     * @brief Returns the number of characters stored across all distinct texts.
+     */
+    qint64 storedChars() const;
+
+private:
+    /**
+     * @brief One distinct text and the number of Labels referring to it.
+     */
+    struct Entry {
+        std::atomic<int> refs{0}; ///< Labels holding the handle.
+        QString text; ///< The text (null while the entry is free).
+    };
+
+    static const int ChunkBits = 10; ///< 1024 entries (16 KB) per chunk.
+    static const quint32 ChunkSize = 1u << ChunkBits;
+    static const int MaxChunks = 65536; ///< 64 M distinct texts.
+
+    LabelPool() = default;
+
+    /**
+     * @brief Returns the entry of a handle.
+     */
+    Entry &entry(quint32 handle) const {
+        return chunks[handle >> ChunkBits].load(std::memory_order_acquire)[handle & (ChunkSize - 1)];
+    }
+
+    mutable QMutex mutex; ///< Guards byText, freeHandles, nextHandle and the chunk allocation.
+    QHash<QString, quint32> byText; ///< Handle of every stored text.
+    QVector<quint32> freeHandles; ///< Handles whose text was freed.
+    quint32 nextHandle = 1; ///< First handle never used.
+    qint64 chars = 0; ///< Characters of all stored texts.
+    std::atomic<Entry *> chunks[MaxChunks] = {}; ///< Entry storage; chunks are allocated on demand and never freed.
+};
+
+/**
+ * @class Label
+ * @brief Interned label text: a 32-bit handle into the LabelPool.
+ *
+ * Copying a Label adjusts a reference count instead of a string, and two
+ * Labels are equal exactly when their handles are, so comparing or hashing
+ * them is an integer operation. Alarms that share a label ("Standup",
+ * "Meds") share one stored text.
+ */
+class Label {
+public:
+    /**
+     * @brief Constructs the empty label.
+     */
+    Label() = default;
+
+    /**
+     * @brief Interns a text.
+     */
+    Label(const QString &text) : id(LabelPool::instance().intern(text)) {}
+
+    /**
+     * @brief Interns a UTF-8 text.
+     */
+    Label(const char *text) : Label(QString::fromUtf8(text)) {}
+
+    Label(const Label &other) : id(other.id) { LabelPool::instance().retain(id); }
+    Label(Label &&other) noexcept : id(other.id) { other.id = 0; }
+    ~Label() { LabelPool::instance().release(id); }
+
+    Label &operator=(const Label &other) {
+        LabelPool::instance().retain(other.id);
+        LabelPool::instance().release(id);
+        id = other.id;
+        return *this;
+    }
+
+    Label &operator=(Label &&other) noexcept {
+        std::swap(id, other.id);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the handle; equal handles mean equal texts.
+     */
+    quint32 handle() const { return id; }
+
+    /**
+     * @brief Returns true for the empty label.
+     */
+    bool isEmpty() const { return id == 0; }
+
+    /**
+     * @brief Returns the text; it shares the pool's buffer, so no characters are copied.
+     */
+    QString toString() const { return id == 0 ? QString() : LabelPool::instance().text(id); }
+
+    bool operator==(const Label &other) const { return id == other.id; }
+    bool operator!=(const Label &other) const { return id != other.id; }
+
+private:
+    quint32 id = 0; ///< Pool handle (0 for the empty label).
+};
+
+/**
+ * @brief Hashes a label by its handle.
+ */
+inline uint qHash(const Label &label, uint seed = 0) {
+    return qHash(label.handle(), seed);
+}
+
+/**
+ * @brief Writes the text of a label to the debug output.
+ */
+inline QDebug operator<<(QDebug debug, const Label &label) {
+    return debug << label.toString();
+}
+
+#endif // LABELPOOL_H
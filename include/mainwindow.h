@@ -18,6 +18,7 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QComboBox>
 #include <QMainWindow>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -25,9 +26,23 @@
 #include <QTime>
 #include <QTimer>  
 #include <QSet>
-#include <QSound>
+#include <QAudioOutput>
+#include <QPointer>
+#include "agendaview.h"
+#include "worldclockpanel.h"
+#include "alarmprofiles.h"
+#include "alarmscheduler.h"
+#include "alarmservice.h"
+#include "clocksource.h"
 #include "clockwidget.h"
+#include "countdowntimers.h"
+#include "deadlinescheduler.h"
+#include "firebatch.h"
+#include "profileroverlay.h"
 #include "setalarmwindow.h"
+#include "soundlibrary.h"
+#include "stallwatchdog.h"
+#include "timerspanel.h"
 #include "viewAlarm.h"
 
 /**
@@ -44,70 +59,184 @@ class MainWindow : public QMainWindow {
 public:
     /**
      * @brief Constructs the MainWindow.
+     * @param clock The clock to read the time from (default: the system clock).
      * @param parent Pointer to the parent QWidget (default: nullptr).
      */
-    explicit MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(ClockSource *clock = nullptr, QWidget *parent = nullptr);
+
+    /**
+     * @brief Returns the scheduler holding the active profile's alarms.
+     * @return Pointer to the alarm scheduler.
+     */
+    AlarmScheduler *scheduler() const { return alarmScheduler; }
+
+    /**
+     * @brief Returns the thread-safe view of the active profile's alarms for embedding code.
+     * @return Pointer to the alarm service.
+     */
+    AlarmService *service() const { return alarmService; }
+
+    /**
+     * @brief Returns the alarm profiles; the windows show the active one, all of them ring.
+     * @return Pointer to the profiles.
+     */
+    AlarmProfiles *profiles() const { return alarmProfiles; }
+
+    /**
+     * @brief Returns the alarm sounds offered in the dialogs and played when alarms ring.
+     * @return Pointer to the sound library.
+     */
+    SoundLibrary *sounds() const { return soundLibrary; }
+
+    /**
+     * @brief Returns the countdown timers shown in the Timers window.
+     * @return Pointer to the countdown timers.
+     */
+    CountdownTimers *timers() const { return countdownTimers; }
 
     /**
      * @brief Retrieves the list of set alarm times.
+     *
+     * Reads the service's latest snapshot, so it may be called from any thread.
+     *
      * @return A QList of QTime objects representing the alarm times.
      */
     QList<QTime> getAlarms() const;
 
     /**
      * @brief Retrieves the list of alarm labels.
+     *
+     * Reads the service's latest snapshot, so it may be called from any thread.
+     *
      * @return A QList of QString objects representing the alarm labels.
      */
     QList<QString> getAlarmLabels() const;
 
+    /**
+     * @brief Sets the watchdog whose stalls are shown in the profiler overlay.
+     * @param watchdog The stall watchdog (not owned, may be nullptr).
+     */
+    void setStallWatchdog(StallWatchdog *watchdog) { stallWatchdog = watchdog; }
+
+    /**
+     * @brief Runs a command given on the command line of this or a later launch.
+     *
+     * Commands: "show" (also the empty command), "alarms", "agenda", "timers",
+     * "list", "add HH:mm[:ss] [label] [repeat] [sound] [group]", "groups",
+     * "enable <group>", "disable <group>", "profiles", "profile <name>" and
+     * "timer <seconds|mm:ss|h:mm:ss> [label]". Alarm commands act on the
+     * active profile.
+     *
+     * @param command The command and its arguments.
+     * @param reply Receives the text to print for the user.
+     * @return False if the command is unknown or its arguments are invalid.
+     */
+    bool handleCommand(const QStringList &command, QString *reply);
+
+public slots:
+    /**
+     * @brief Shows or hides the profiler overlay (Ctrl+Shift+P).
+     */
+    void toggleProfilerOverlay();
+
 private slots:
     /**
      * @brief Opens the Set Alarm window to create a new alarm.
      */
     void openSetAlarm();
 
+    /**
+     * @brief Points the windows at the active profile's alarms.
+     *
+     * The alarm list and the agenda of the previous profile are closed; they
+     * are built again from the new profile's store when opened. No other
+     * profile is loaded or read.
+     *
+     * @param name The profile that became active.
+     */
+    void showProfile(const QString &name);
+
     /**
      * @brief Opens the View Alarms window to display active alarms.
      */
     void openViewAlarms();
 
+    /**
+     * @brief Opens the Agenda window listing upcoming occurrences.
+     */
+    void openAgenda();
+
+    /**
+     * @brief Opens the World Clock window.
+     */
+    void openWorldClock();
+
+    /**
+     * @brief Opens the Timers window with the countdown timers and the stopwatch.
+     */
+    void openTimers();
+
+    /**
+     * @brief Rings for a countdown timer that ran down and lists it in the timer message box.
+     * @param id The id of the timer.
+     */
+    void countdownFinished(quint64 id);
+
     /**
      * @brief Handles a newly set alarm.
      * @param time The time of the alarm.
      * @param repeat The repeat setting of the alarm.
      * @param label The label for the alarm.
      * @param sound The sound associated with the alarm.
+     * @param calendar The holiday calendar the alarm skips ("" for none).
+     * @param group The group the alarm belongs to ("" for none).
      */
-    void handleAlarmSet(QTime time, QString repeat, QString label, QString sound);
+    void handleAlarmSet(QTime time, QString repeat, QString label, QString sound, QString calendar, QString group);
 
     /**
-     * @brief Checks active alarms and triggers notifications when an alarm matches the current time.
+     * @brief Asks for a holiday calendar file and imports it.
      */
-    void checkAlarms(); 
+    void importHolidays();
 
     /**
-     * @brief Snoozes a triggered alarm for a specified duration.
-     * @param index The index of the alarm in the list.
-     * @param minutes The number of minutes to snooze the alarm.
+     * @brief Checks the alarms of every loaded profile and fires all alarms due at the current time as one batch.
      */
-    void snoozeAlarm(int index, int minutes);
+    void checkAlarms(); 
+
     void playAlarmSound(const QString &soundName); 
     void stopAlarmSound(); 
 
 private:
+    QComboBox *profileComboBox; //< Selects (or, when a new name is typed, creates) the active profile
     QPushButton *setAlarmButton;  //< Button to open the Set Alarm window 
     QPushButton *viewAlarmsButton; //< Button to open the View Alarms window 
+    QPushButton *agendaButton; //< Button to open the Agenda window
+    QPushButton *worldClockButton; //< Button to open the World Clock window
+    QPushButton *timersButton; //< Button to open the Timers window
     ViewAlarm *viewAlarmWindow; //< Pointer to the View Alarm window 
+    AgendaView *agendaWindow = nullptr; //< Agenda window, created on first use
+    WorldClockPanel *worldClockWindow = nullptr; //< World Clock window, created on first use
+    TimersPanel *timersWindow = nullptr; //< Timers window, created on first use
     ClockWidget *clockWidget; //< Widget displaying the current time 
-    QList<QTime> alarms; //< List of active alarm times 
-    QList<QString> alarmLabels; //< List of labels associated with alarms 
-    QList<QString> alarmRepeats; //<Stores repeat setting
-    QList<QString> alarmSounds; //< Stores sound choices for alarms
-    QSound *alarmPlayer = nullptr; //< Pointer to the QSound object that plays the alarm sound
-    QSet<QString> dismissedToday; //<Track dismissed alarms (by label + date)
-    QTimer *alarmCheckTimer; //< Timer that checks alarms every second 
-    QList<bool> alarmIsSnoozed; //< Boolean for snoozing an alarm
-    QVector<QTime> originalAlarmTimes; //< Keep track of original alarm time set 
+    AlarmProfiles *alarmProfiles; //< One alarm shard per profile
+    AlarmScheduler *alarmScheduler; //< Stores the active profile's alarms and decides when they ring
+    AlarmService *alarmService; //< Lock-free snapshots of the active profile's alarms for other threads
+    SoundLibrary *soundLibrary; //< Decoded alarm sounds
+    QAudioOutput *alarmOutput = nullptr; //< Plays the ringing alarm's sound; kept while the format stays the same
+    LoopingSoundDevice *alarmStream = nullptr; //< Repeats the ringing alarm's samples; reused for every alarm
+    StreamingSoundDevice *alarmTrack = nullptr; //< Streams the ringing alarm's track if it is too long to keep in memory
+    QMessageBox *alarmBox = nullptr; //< Message box shown for every firing, created on first use
+    QPushButton *alarmSnoozeButton = nullptr; //< Snooze button of alarmBox
+    QPushButton *alarmDismissButton = nullptr; //< Dismiss button of alarmBox
+    DeadlineScheduler *deadlineScheduler; //< One timer for every countdown deadline
+    CountdownTimers *countdownTimers; //< Kitchen and lab timers on the monotonic clock
+    QPointer<QMessageBox> timerBox; //< Lists the finished timers until acknowledged
+    QStringList finishedTimers; //< Labels listed in timerBox
+    QTimer *alarmCheckTimer; //< Timer that checks alarms just after every whole second
+    bool alarmFiring = false; //< True while the alarm message box is open
+    FireBatch dueBatch; //< Alarms due at the latest check and their texts; buffers reused between firings
+    StallWatchdog *stallWatchdog = nullptr; //< Event-loop stall watchdog (not owned)
+    ProfilerOverlay *profilerOverlay = nullptr; //< Debug timing panel, created on first use
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,85 @@
+/**
+ * @file memoryusage.h
+ * @brief Helpers for measuring the memory footprint of the process.
+ *
+ * This file declares functions that read the resident set size (RSS) and the
+ * open file descriptors of the running process, and the RssReporter class,
+ * which logs the RSS periodically. They are used by the kiosk build to check
+ * its memory budget and by the soak test to detect leaks.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <QObject>
+#include <QTimer>
+
+namespace MemoryUsage {
+
+/**
+ * @brief Returns the resident set size of the current process.
+ * @return The RSS in kilobytes, or -1 if it cannot be determined.
+ */
+qint64 residentKb();
+
+/**
+ * @brief Returns the number of file descriptors the current process has open.
+ * @return The count, or -1 if it cannot be determined.
+ */
+int openFileDescriptors();
+
+} // namespace MemoryUsage
+
+/**
+ * @class RssReporter
+ * @brief Samples the process RSS on a timer and logs it.
+ *
+ * The reporter keeps the peak value it has seen so that a run can be judged
+ * against a steady-state footprint budget when it ends.
+ */
+class RssReporter : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Starts sampling the RSS.
+     * @param intervalMs Milliseconds between samples.
+     * @param log True to print every sample with qInfo().
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit RssReporter(int intervalMs, bool log, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the most recent sample in kilobytes.
+     */
+    qint64 lastKb() const { return last; }
+
+    /**
+     * @brief Returns the largest sample seen so far in kilobytes.
+     */
+    qint64 peakKb() const { return peak; }
+
+public slots:
+    /**
+     * @brief Takes one sample immediately.
+     */
+    void sample();
+
+signals:
+    /**
+     * @brief Emitted after every sample.
+     * @param rssKb The resident set size in kilobytes.
+     */
+    void sampled(qint64 rssKb);
+
+private:
+    QTimer timer; ///< Drives periodic sampling.
+    bool logSamples; ///< Whether each sample is printed.
+    qint64 last = -1; ///< Most recent sample.
+    qint64 peak = -1; ///< Largest sample.
+};
+
+#endif // MEMORYUSAGE_H
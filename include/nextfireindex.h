@@ -0,0 +1,256 @@
+/**
+ * @file nextfireindex.h
+ * @brief Header file for the NextFireIndex class.
+ *
+ * This file defines the NextFireIndex class, which stores the next instant
+ * every alarm will ring at, and the immutable NextFireTable it publishes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef NEXTFIREINDEX_H
+#define NEXTFIREINDEX_H
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QTimeZone>
+#include <QTimer>
+#include <QVector>
+#include <limits>
+#include <memory>
+#include "alarmstore.h"
+#include "clocksource.h"
+#include "holidaycalendar.h"
+
+/**
+ * @struct NextFireTable
+ * @brief The next fire instant of every alarm, as of one store version.
+ *
+ * Tables are never modified after they are published, so any thread may
+ * keep reading one while a newer table replaces it.
+ */
+struct NextFireTable {
+    static constexpr qint64 NoFire = std::numeric_limits<qint64>::max(); ///< The alarm never rings again.
+
+    quint64 version = 0;        ///< Store version the table describes.
+    QVector<quint64> ids;       ///< Alarm ids, ascending (the store's order).
+    QVector<qint64> fireAt;     ///< Next fire instant of ids[i], in ms since the epoch (UTC).
+    qint64 earliest = NoFire;   ///< Smallest entry of fireAt.
+    quint64 earliestId = 0;     ///< Alarm with the smallest entry (0 if none rings).
+
+    /**
+     * @brief Returns the next fire instant of an alarm (O(log n)).
+     * @param id The id of the alarm.
+     * @return Milliseconds since the epoch (UTC), or NoFire.
+     */
+    qint64 fireAtOf(quint64 id) const;
+};
+
+/**
+ * @class NextFireIndex
+ * @brief Keeps a NextFireTable in step with the store, the time zone and the holiday calendars.
+ *
+ * Single alarm edits, and alarms that have just fired, are patched into a
+ * copy of the current table. When every entry is invalidated at once (the
+ * time zone or a holiday calendar changed, or the clock jumped) the store
+ * is split into chunks that are computed in parallel on the global thread
+ * pool. In both cases the finished table replaces the old one with a single
+ * atomic pointer store, so readers never see a half-updated table.
+ *
+ * The next fire instant of an alarm is the first second after the current
+ * one on which the alarm rings, skipping its holiday calendar (dismissals
+ * for the rest of a day are not taken into account).
+ */
+class NextFireIndex : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an index over a store.
+     * @param store The alarms.
+     * @param calendars Holiday calendars the alarms can refer to.
+     * @param clock Defines the current time (nullptr means the system clock).
+     * @param parent The parent object (default is nullptr).
+     */
+    NextFireIndex(AlarmStore *store, HolidayCalendars *calendars, ClockSource *clock = nullptr,
+                  QObject *parent = nullptr);
+
+    /**
+     * @brief Waits for a running recompute so that its threads do not outlive the store.
+     */
+    ~NextFireIndex() override;
+
+    /**
+     * @brief Returns the current table; safe to call from any thread.
+     */
+    std::shared_ptr<const NextFireTable> table() const;
+
+    /**
+     * @brief Returns the next fire instant of an alarm.
+     * @return The local date and time, or an invalid QDateTime if it never rings again.
+     */
+    QDateTime nextFire(quint64 id) const;
+
+    /**
+     * @brief Returns the earliest next fire instant of all alarms.
+     * @return The local date and time, or an invalid QDateTime if nothing will ring.
+     */
+    QDateTime nextDeadline() const;
+
+    /**
+     * @brief Returns the zone next fire instants are computed in.
+     */
+    QTimeZone timeZone() const { return zone; }
+
+    /**
+     * @brief Changes the zone and recomputes every entry.
+     */
+    void setTimeZone(const QTimeZone &timeZone);
+
+    /**
+     * @brief Marks alarms that have just fired so that their next occurrence is looked up.
+     *
+     * Only queues the ids (no heap allocation once the queue has grown); the
+     * lookup runs on the next flush.
+     *
+     * @param ids The alarms.
+     */
+    void markFired(const QVector<quint64> &ids);
+
+    /**
+     * @brief Starts recomputing every entry in the background.
+     *
+     * A call made while a recompute is running starts another one when the
+     * first finishes.
+     */
+    void recompute();
+
+    /**
+     * @brief Recomputes every entry and waits for the result.
+     */
+    void recomputeNow();
+
+    /**
+     * @brief Applies every pending change now instead of on the next event loop pass.
+     */
+    void sync();
+
+    /**
+     * @brief Returns true while a bulk recompute is running.
+     */
+    bool isRecomputing() const { return job != nullptr; }
+
+signals:
+    /**
+     * @brief Emitted after a new table was published (by a patch or a bulk recompute).
+     */
+    void tableChanged();
+
+    /**
+     * @brief Emitted when a bulk recompute has been published.
+     * @param alarms Number of alarms computed.
+     * @param elapsedMs Wall time of the recompute.
+     */
+    void recomputed(int alarms, qint64 elapsedMs);
+
+private slots:
+    /**
+     * @brief Collects the alarms changed in the store.
+     */
+    void onStoreChanged(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+    /**
+     * @brief Patches the pending changes into a new table.
+     */
+    void flush();
+
+    /**
+     * @brief Publishes the result of a bulk recompute.
+     */
+    void finishRecompute();
+
+private:
+    /**
+     * @brief The fields of an alarm its next fire instant depends on.
+     *
+     * A bulk recompute copies these instead of holding a store snapshot, so
+     * edits made while it runs do not make the store copy its list.
+     */
+    struct FireInput {
+        quint64 id = 0;      ///< Alarm id.
+        QTime time;          ///< Time of day it rings at.
+        QString repeat;      ///< Repeat setting.
+        QString calendar;    ///< Holiday calendar it skips.
+        bool enabled = true; ///< False if it never rings.
+        bool snoozed = false; ///< Snoozed copies ignore the calendar.
+
+        /**
+         * @brief Copies the relevant fields of an alarm.
+         */
+        static FireInput of(const Alarm &alarm);
+    };
+
+    /**
+     * @brief Everything needed to compute next fire instants, copied so worker threads share nothing mutable.
+     */
+    struct Rules {
+        QTimeZone zone;                             ///< Zone of the alarm times.
+        qint64 fromDay = 0;                         ///< Local Julian day of the first candidate second.
+        int fromSecond = 0;                         ///< Second of the day of the first candidate second.
+        QVector<int> midnightOffsets;               ///< UTC offset at local midnight of fromDay + i, in seconds.
+        QVector<bool> transitionDays;               ///< Days on which the offset changes.
+        QHash<QString, HolidayCalendar> calendars;  ///< Copies of the holiday calendars.
+
+        /**
+         * @brief Returns the next fire instant of an alarm in ms since the epoch, or NoFire.
+         */
+        qint64 fireAt(const FireInput &alarm) const;
+
+        /**
+         * @brief Returns the next fire instant of an alarm of the store.
+         */
+        qint64 fireAt(const Alarm &alarm) const { return fireAt(FireInput::of(alarm)); }
+
+        /**
+         * @brief Converts a local day and second of the day to ms since the epoch.
+         */
+        qint64 toUtc(qint64 day, int second) const;
+    };
+
+    /**
+     * @brief State of a running bulk recompute.
+     */
+    struct Job;
+
+    /**
+     * @brief Returns the rules for the second after the current one.
+     *
+     * The per-day offsets are only rebuilt when the day, zone or calendars changed.
+     */
+    const Rules &currentRules();
+
+    /**
+     * @brief Publishes a table with one atomic store.
+     */
+    void publish(std::shared_ptr<const NextFireTable> next);
+
+    AlarmStore *alarmStore; ///< Alarms being indexed.
+    HolidayCalendars *holidayCalendars; ///< Calendars alarms refer to.
+    ClockSource *clockSource; ///< Defines the current time.
+    QTimeZone zone; ///< Zone of the alarm times.
+    std::shared_ptr<const NextFireTable> current; ///< Published table (accessed with std::atomic_load/store).
+    Rules rules; ///< Cached rules (see currentRules()).
+    bool rulesValid = false; ///< False when the zone or calendars changed since rules was built.
+    QVector<quint64> dirtyIds; ///< Alarms to look up on the next flush (may repeat; its capacity is kept).
+    bool dirty = false; ///< True if the store changed or alarms fired since the last flush.
+    QTimer flushTimer; ///< Coalesces changes into one flush per event loop pass.
+    std::shared_ptr<Job> job; ///< Running bulk recompute, if any.
+    QFutureWatcher<void> jobWatcher; ///< Reports the end of the running recompute.
+    bool recomputeAgain = false; ///< A recompute was requested while one was running.
+};
+
+#endif // NEXTFIREINDEX_H
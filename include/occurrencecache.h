@@ -0,0 +1,159 @@
+/**
+ * @file occurrencecache.h
+ * @brief Header file for the OccurrenceCache class.
+ *
+ * This file defines the OccurrenceCache class, which answers "what rings
+ * between these two instants" by expanding repeat rules into concrete
+ * occurrences on demand, and the Occurrence record it returns.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef OCCURRENCECACHE_H
+#define OCCURRENCECACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+#include "alarmstore.h"
+#include "clocksource.h"
+#include "holidaycalendar.h"
+
+/**
+ * @struct Occurrence
+ * @brief One concrete ringing of an alarm.
+ */
+struct Occurrence {
+    qint64 minute;   ///< Local wheel minute it rings at (see AlarmScheduler::wheelMinute()).
+    quint64 alarmId; ///< Id of the alarm in the store.
+
+    /**
+     * @brief Returns the local date and time of the occurrence.
+     */
+    QDateTime dateTime() const;
+};
+
+/**
+ * @class OccurrenceCache
+ * @brief Lazily expanded projection of the alarms onto the calendar.
+ *
+ * Weekly alarms are indexed once in a table sorted by minute of the week;
+ * one-time alarms in a table sorted by minute of the day. A query expands
+ * only the days it covers, each day being a contiguous slice of the weekly
+ * table, and keeps the expanded days for later queries. Store changes
+ * update the tables and the expanded days for the affected alarm only, so
+ * editing one alarm never throws the cache away.
+ *
+ * Nothing is built until the first query. One-time alarms ring at their
+ * next occurrence (relative to the clock), like in the AlarmScheduler.
+ * Dates excluded by an alarm's holiday calendar are left out. Disabled
+ * alarms stay in the tables and are left out as occurrences are copied into
+ * a result, so switching a group of k alarms on or off costs k set
+ * operations and keeps every expanded day. A batch moving a large part of
+ * the alarms (new times for many of them) drops the tables instead, to be
+ * rebuilt on the next query.
+ */
+class OccurrenceCache : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an empty cache following a store.
+     * @param store The store whose alarms are projected.
+     * @param clock Clock used to place one-time alarms (nullptr means the system clock).
+     * @param parent The parent object (default is nullptr).
+     */
+    OccurrenceCache(AlarmStore *store, ClockSource *clock = nullptr, QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the holiday calendars used to leave out excluded dates.
+     * @param calendars The calendars (not owned, may be nullptr).
+     */
+    void setCalendars(HolidayCalendars *calendars);
+
+    /**
+     * @brief Returns every occurrence in [from, to), ordered by time.
+     * @param from First instant of the window (local time).
+     * @param to End of the window (local time, exclusive).
+     */
+    QVector<Occurrence> occurrences(const QDateTime &from, const QDateTime &to);
+
+    /**
+     * @brief Returns the occurrences in [from, to) whose time of day is in [dayStart, dayEnd).
+     *
+     * If dayEnd is not after dayStart the time range wraps around midnight,
+     * e.g. 22:00 to 02:00.
+     *
+     * @param from First instant of the window (local time).
+     * @param to End of the window (local time, exclusive).
+     * @param dayStart Earliest time of day.
+     * @param dayEnd Latest time of day (exclusive).
+     */
+    QVector<Occurrence> occurrences(const QDateTime &from, const QDateTime &to, const QTime &dayStart, const QTime &dayEnd);
+
+    /**
+     * @brief Returns the number of days currently expanded.
+     */
+    int cachedDays() const { return dayCache.size(); }
+
+    /**
+     * @brief Drops the tables and every expanded day.
+     */
+    void clear();
+
+private slots:
+    /**
+     * @brief Updates the tables for the alarms that changed.
+     */
+    void onStoreChanged(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+private:
+    /**
+     * @brief An alarm in one of the pattern tables.
+     */
+    struct PatternEntry {
+        int minute;   ///< Minute of the week (weekly table) or of the day (one-time table).
+        quint64 id;   ///< Alarm id.
+    };
+
+    /**
+     * @brief Where an alarm is in the tables, and the calendar its expanded days were filtered with.
+     */
+    struct PatternKey {
+        int minute;       ///< Minute of the week (>= 0) or -1 - minute of the day.
+        QString calendar; ///< Holiday calendar of the alarm.
+    };
+
+    /**
+     * @brief A range of minutes of the day, [begin, end).
+     */
+    struct DayRange {
+        int begin;
+        int end;
+    };
+
+    QVector<Occurrence> query(qint64 fromMinute, qint64 toMinute, const QVector<DayRange> &ranges);
+    void build();
+    void addPattern(const Alarm &alarm);
+    void removePattern(quint64 id);
+    bool moves(const Alarm &alarm) const;
+    const QVector<Occurrence> &expandDay(qint64 day);
+    bool isSkipped(quint64 id, qint64 day) const;
+
+    static const int maxCachedDays = 62; ///< Expanded days kept before old ones are dropped.
+
+    AlarmStore *alarmStore;     ///< Projected store.
+    ClockSource *clockSource;   ///< Places one-time alarms.
+    HolidayCalendars *holidays = nullptr; ///< Excluded dates per alarm.
+    bool built = false;         ///< True once the tables reflect the store.
+    QVector<PatternEntry> weekly;  ///< Weekly alarms by minute of the week.
+    QVector<PatternEntry> oneTime; ///< Other alarms by minute of the day.
+    QHash<quint64, PatternKey> patternKeys; ///< Place in the tables, by id.
+    QSet<quint64> disabledIds; ///< Alarms in the tables that are switched off.
+    QHash<qint64, QVector<Occurrence>> dayCache; ///< Expanded weekly occurrences by wheel day.
+};
+
+#endif // OCCURRENCECACHE_H
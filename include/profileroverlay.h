@@ -0,0 +1,64 @@
+/**
+ * @file profileroverlay.h
+ * @brief Header file for the ProfilerOverlay class.
+ *
+ * This file defines the ProfilerOverlay class, a small debug panel showing
+ * the time spent in the hot slots, the event-loop stalls recorded by the
+ * StallWatchdog and how late the alarms rang.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QTimer>
+#include <QWidget>
+#include "alarmscheduler.h"
+#include "stallwatchdog.h"
+
+/**
+ * @class ProfilerOverlay
+ * @brief Tool window with per-slot timings, recent stalls, alarm lateness and heap traffic.
+ *
+ * The panel refreshes itself twice a second while visible, so it costs
+ * nothing when hidden.
+ */
+class ProfilerOverlay : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the overlay.
+     * @param watchdog Source of the stall data (may be nullptr).
+     * @param scheduler Source of the alarm lateness (may be nullptr).
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit ProfilerOverlay(StallWatchdog *watchdog, AlarmScheduler *scheduler, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief Redraws the tables from the profiler, the watchdog and the scheduler.
+     */
+    void refresh();
+
+private:
+    StallWatchdog *watchdog; ///< Stall source (not owned).
+    AlarmScheduler *scheduler; ///< Lateness source (not owned).
+    QLabel *jitterLine; ///< Alarm lateness.
+    QLabel *heapLine; ///< Heap blocks in use and allocation rate.
+    QLabel *slotTable; ///< Per-slot timings.
+    QLabel *stallTable; ///< Recent stalls.
+    QTimer refreshTimer; ///< Refreshes the panel while it is visible.
+    QElapsedTimer heapSampleTimer; ///< Time since the allocation count was last read.
+    quint64 heapSampleAllocations = 0; ///< Allocation count at the last refresh.
+};
+
+#endif // PROFILEROVERLAY_H
@@ -20,14 +20,17 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QStringList>
+#include "soundlibrary.h"
 
 /**
  * @class SetAlarmWindow
  * @brief The SetAlarmWindow class provides a dialog for setting an alarm.
  * 
- * The SetAlarmWindow class allows users to set an alarm by selecting a time, a repeat option, a label, and a sound.
+ * The SetAlarmWindow class allows users to set an alarm by selecting a time, a repeat option, a label, a sound,
+ * optionally a holiday calendar whose dates the alarm skips and optionally a group it belongs to.
  * The alarm settings are saved when the user clicks the save button. A signal is emitted to the main window with the 
- * alarm details, which include the time, repeat option, label, and sound.
+ * alarm details, which include the time, repeat option, label, sound, calendar and group.
  * 
  */
 
@@ -37,9 +40,13 @@ class SetAlarmWindow : public QDialog {
 public:
     /**
      * @brief Constructs a SetAlarmWindow dialog.
+     * @param calendars Names of the holiday calendars to offer (the selector is hidden if empty).
+     * @param groups Names of the existing groups to offer (a new name can be typed).
+     * @param sounds Sounds to offer (nullptr offers the built-in names).
      * @param parent The parent widget, default is nullptr.
      */
-    explicit SetAlarmWindow(QWidget *parent = nullptr);
+    explicit SetAlarmWindow(const QStringList &calendars = QStringList(), const QStringList &groups = QStringList(),
+                            const SoundLibrary *sounds = nullptr, QWidget *parent = nullptr);
 
 signals:
     /**
@@ -48,8 +55,10 @@ signals:
      * @param repeat The repeat option for the alarm.
      * @param label The label for the alarm.
      * @param sound The selected sound for the alarm.
+     * @param calendar The holiday calendar the alarm skips ("" for none).
+     * @param group The group the alarm belongs to ("" for none).
      */
-    void alarmSet(QTime time, QString repeat, QString label, QString sound); // Updated Signal
+    void alarmSet(QTime time, QString repeat, QString label, QString sound, QString calendar, QString group);
 
 private slots:
     /**
@@ -62,6 +71,8 @@ private:
     QComboBox *repeatComboBox;  ///< Repeat option selection widget. 
     QLineEdit *labelEdit;        ///< Alarm label input widget. 
     QComboBox *soundComboBox;   ///< Sound selection widget. 
+    QComboBox *calendarComboBox; ///< Holiday calendar selection widget.
+    QComboBox *groupComboBox;    ///< Group selection (editable) widget.
     QPushButton *saveButton;     ///< Button to save the alarm. 
     QLabel *errorLabel;         ///< Label to display error messages. 
 };
@@ -0,0 +1,104 @@
+/**
+ * @file singleinstance.h
+ * @brief Header file for the SingleInstance class.
+ *
+ * This file defines the SingleInstance class, which makes sure only one
+ * Rise and Pi process runs per user and carries the commands of later
+ * launches over to it.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QLocalServer>
+#include <QLockFile>
+#include <QObject>
+#include <QStringList>
+#include <functional>
+#include <memory>
+
+/**
+ * @class SingleInstance
+ * @brief Lock file plus local socket that elects one primary process.
+ *
+ * The first process takes a lock file in the temporary folder and listens on
+ * a local socket of the same name. A later launch fails to take the lock,
+ * sends its command line to the socket, prints the reply and exits, without
+ * ever creating a QApplication or a window. The lock is released by the
+ * operating system when the primary dies, so a crashed instance never
+ * blocks the next launch; the lock also decides which of two simultaneous
+ * launches becomes primary.
+ *
+ * tryPrimary() and forward() need no application object, so main() can call
+ * them before deciding whether to start the GUI.
+ */
+class SingleInstance : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Handles a forwarded command in the primary instance.
+     * @return True if the command succeeded; the reply is printed by the sender.
+     */
+    using Handler = std::function<bool(const QStringList &command, QString *reply)>;
+
+    /**
+     * @brief Constructs the instance guard; nothing is locked yet.
+     * @param name Name of the lock file and the socket (default: per user).
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit SingleInstance(const QString &name = defaultName(), QObject *parent = nullptr);
+
+    /**
+     * @brief Releases the lock and stops listening.
+     */
+    ~SingleInstance() override;
+
+    /**
+     * @brief Returns the per-user name shared by every launch of the application.
+     */
+    static QString defaultName();
+
+    /**
+     * @brief Tries to become the primary instance.
+     * @return True if the lock was taken (listen() is then called once the app is ready).
+     */
+    bool tryPrimary();
+
+    /**
+     * @brief Starts accepting commands from later launches; needs an event loop.
+     * @param handler Runs every received command.
+     * @return False if the socket cannot be created.
+     */
+    bool listen(Handler handler);
+
+    /**
+     * @brief Sends a command to the primary instance and waits for its reply.
+     *
+     * Retries for up to timeoutMs while the primary has the lock but is not
+     * listening yet (it is still starting).
+     *
+     * @param command The command, e.g. {"add", "07:30", "Wake up"}; empty means "show".
+     * @param reply Receives the reply text.
+     * @param timeoutMs How long to wait in total.
+     * @return 0 if the command succeeded, 1 if it failed, 3 if no primary answered.
+     */
+    int forward(const QStringList &command, QString *reply, int timeoutMs = 2000);
+
+private slots:
+    /**
+     * @brief Reads the command of a connecting launch and sends the handler's reply.
+     */
+    void onNewConnection();
+
+private:
+    QString serverName; ///< Name of the local socket.
+    QLockFile lockFile; ///< Held by the primary for as long as it runs.
+    std::unique_ptr<QLocalServer> server; ///< Receives commands (primary only, after listen()).
+    Handler commandHandler; ///< Runs received commands.
+};
+
+#endif // SINGLEINSTANCE_H
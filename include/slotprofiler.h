@@ -0,0 +1,101 @@
+/**
+ * @file slotprofiler.h
+ * @brief Header file for the SlotProfiler class.
+ *
+ * This file defines the SlotProfiler class, which accumulates the time spent
+ * in the application's hot slots, and the RISE_PROFILE_SLOT macro used to
+ * time a slot body.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef SLOTPROFILER_H
+#define SLOTPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @class SlotProfiler
+ * @brief Per-slot call counts and timings, plus the name of the running slot.
+ *
+ * Timings are recorded on the GUI thread only. The name of the slot that is
+ * currently running is published atomically so the StallWatchdog thread can
+ * say which slot an event-loop stall happened in. Time spent in nested event
+ * loops (QDialog::exec, QMessageBox::exec) counts towards the slot that
+ * opened them.
+ */
+class SlotProfiler {
+public:
+    /**
+     * @brief Accumulated timings of one slot.
+     */
+    struct Stats {
+        const char *name = nullptr; ///< Slot name given to RISE_PROFILE_SLOT.
+        quint64 calls = 0;          ///< Number of completed calls.
+        qint64 totalNs = 0;         ///< Total time spent in the slot.
+        qint64 maxNs = 0;           ///< Longest single call.
+        qint64 lastNs = 0;          ///< Duration of the most recent call.
+    };
+
+    /**
+     * @class Scope
+     * @brief Times the enclosing block and marks it as the running slot.
+     */
+    class Scope {
+    public:
+        explicit Scope(const char *name);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *name;       ///< Slot being timed.
+        const char *previous;   ///< Slot that was running before (for nested calls).
+        QElapsedTimer timer;    ///< Measures the call.
+    };
+
+    /**
+     * @brief Returns the application-wide profiler.
+     */
+    static SlotProfiler &instance();
+
+    /**
+     * @brief Returns the slot running on the GUI thread, or nullptr.
+     *
+     * Safe to call from any thread.
+     */
+    const char *activeSlot() const { return active.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the timings of every slot seen so far, in first-seen order.
+     */
+    const QVector<Stats> &stats() const { return slotStats; }
+
+    /**
+     * @brief Forgets all recorded timings.
+     */
+    void reset() { slotStats.clear(); }
+
+private:
+    SlotProfiler() = default;
+
+    /**
+     * @brief Adds one call of a slot.
+     */
+    void record(const char *name, qint64 nsecs);
+
+    QVector<Stats> slotStats; ///< Timings by slot (a handful of entries).
+    std::atomic<const char *> active{nullptr}; ///< Slot currently running.
+};
+
+/**
+ * @brief Times the rest of the enclosing block under the given slot name.
+ * @param name A string literal, e.g. "MainWindow::checkAlarms".
+ */
+#define RISE_PROFILE_SLOT(name) SlotProfiler::Scope riseProfileScope(name)
+
+#endif // SLOTPROFILER_H
@@ -0,0 +1,331 @@
+/**
+ * @file soundlibrary.h
+ * @brief Header file for the SoundLibrary class.
+ *
+ * This file defines the SoundLibrary class, which keeps the alarm sounds
+ * (the built-in ones and those in a user sound folder) decoded in memory,
+ * the DecodedSound values it hands out, the LoopingSoundDevice that plays
+ * one of them on repeat and the StreamingSoundDevice that plays a long
+ * track straight from its file.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef SOUNDLIBRARY_H
+#define SOUNDLIBRARY_H
+
+#include <QAudioFormat>
+#include <QComboBox>
+#include <QDateTime>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QIODevice>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+
+/**
+ * @struct DecodedSound
+ * @brief PCM samples of one sound file, ready to be played.
+ *
+ * Decoded sounds are never modified once published, so a sound that is
+ * playing stays valid while its file is replaced or deleted.
+ *
+ * Tracks longer than SoundLibrary::streamThreshold are not loaded: pcm
+ * stays empty and only the position of the samples in the file is kept,
+ * so that a StreamingSoundDevice can play them from there.
+ */
+struct DecodedSound {
+    QString name;         ///< Name shown in the sound selectors.
+    QString path;         ///< File the samples were read from.
+    QAudioFormat format;  ///< Layout of the samples.
+    QByteArray pcm;       ///< Interleaved samples (empty for a streamed track).
+    qint64 dataOffset = 0; ///< Offset of the samples in the file.
+    qint64 dataSize = 0;  ///< Size of the samples in the file, in whole frames.
+
+    /**
+     * @brief Returns true if the samples are left in the file.
+     */
+    bool isStreamed() const { return pcm.isEmpty(); }
+};
+
+/**
+ * @class SoundLibrary
+ * @brief Named alarm sounds, decoded off the GUI thread and reloaded when their files change.
+ *
+ * The built-in sounds (Classic, Beep, Rooster) come from the resources. Every
+ * .wav file in the user sound folder is offered under its base name and
+ * replaces a built-in sound of the same name. The folder is watched: after
+ * files are added, changed or removed, and have been left alone for half a
+ * second, only those files are decoded again, on a small thread pool of the
+ * library's own. Sounds appear in the selectors once they are decoded, so
+ * neither the GUI thread nor a ringing alarm ever waits for a decode.
+ *
+ * Only uncompressed PCM and float WAV files are supported. Files with more
+ * than streamThreshold bytes of samples are streamed when they ring rather
+ * than held in memory; "decoding" them only reads their header.
+ */
+class SoundLibrary : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 streamThreshold = 2 * 1024 * 1024; ///< Largest sample data kept in memory (about 12 s of CD audio).
+
+    /**
+     * @brief Constructs the library and starts decoding the built-in sounds.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit SoundLibrary(QObject *parent = nullptr);
+
+    /**
+     * @brief Waits for running decodes so that they do not outlive the library.
+     */
+    ~SoundLibrary() override;
+
+    /**
+     * @brief Watches a folder for user sounds, creating it if needed.
+     * @param path The folder.
+     * @return False if the folder cannot be created or watched.
+     */
+    bool setDirectory(const QString &path);
+
+    /**
+     * @brief Returns the watched user sound folder.
+     */
+    QString directory() const { return userDirectory; }
+
+    /**
+     * @brief Returns the names of the decoded sounds, sorted.
+     */
+    QStringList names() const;
+
+    /**
+     * @brief Returns a decoded sound.
+     * @param name The name of the sound.
+     * @return The sound, or nullptr if no sound of that name has been decoded.
+     */
+    std::shared_ptr<const DecodedSound> sound(const QString &name) const;
+
+    /**
+     * @brief Sets where streamed tracks start playing and how long they take to fade in.
+     * @param startMs Offset into the track; tracks shorter than that start at the beginning.
+     * @param fadeInMs Duration of the fade from silence to full volume (0 for none).
+     */
+    void setTrackPlayback(qint64 startMs, int fadeInMs);
+
+    /**
+     * @brief Returns the offset streamed tracks start playing at.
+     */
+    qint64 trackStartMs() const { return trackStart; }
+
+    /**
+     * @brief Returns the fade-in duration of streamed tracks.
+     */
+    int trackFadeInMs() const { return trackFadeIn; }
+
+    /**
+     * @brief Fills a sound selector and keeps it in step with the library.
+     *
+     * Sounds are inserted and removed one item at a time as they come and
+     * go; the selected item is never removed. The selector stops following
+     * the library when it is destroyed.
+     *
+     * @param comboBox The selector.
+     */
+    void populate(QComboBox *comboBox) const;
+
+    /**
+     * @brief Reads a WAV file and returns its samples.
+     *
+     * For a file with more than streamThreshold bytes of samples only the
+     * header is read and the sound is returned without samples.
+     *
+     * @param name The name to give the sound.
+     * @param path The file.
+     * @param error Receives the reason if the file cannot be used (may be nullptr).
+     * @return The sound, or nullptr on error.
+     */
+    static std::shared_ptr<const DecodedSound> decodeWav(const QString &name, const QString &path,
+                                                         QString *error = nullptr);
+
+signals:
+    /**
+     * @brief Emitted when a sound name becomes available.
+     */
+    void soundAdded(const QString &name);
+
+    /**
+     * @brief Emitted when a sound name is no longer available.
+     */
+    void soundRemoved(const QString &name);
+
+private slots:
+    /**
+     * @brief Notes a change in the folder and (re)starts the settle timer.
+     */
+    void scheduleScan(const QString &path);
+
+    /**
+     * @brief Compares the folder with the files known so far and decodes the new and changed ones.
+     */
+    void scan();
+
+private:
+    /**
+     * @brief What is known about one file of the user folder.
+     */
+    struct FileState {
+        QString name;          ///< Sound name (the file's base name).
+        qint64 size = -1;      ///< Size when it was last submitted for decoding.
+        QDateTime modified;    ///< Modification time when it was last submitted.
+        quint64 generation = 0; ///< Decode whose result is still wanted.
+    };
+
+    /**
+     * @brief Decodes a file on the pool and hands the result to finishDecode().
+     */
+    void submitDecode(const QString &name, const QString &path, bool builtIn, quint64 generation);
+
+    /**
+     * @brief Publishes a decoded sound unless its file changed again meanwhile.
+     */
+    void finishDecode(const QString &path, bool builtIn, quint64 generation,
+                      std::shared_ptr<const DecodedSound> decoded, const QString &error);
+
+    /**
+     * @brief Drops the user sound of a file that is gone.
+     */
+    void forgetFile(const QString &path);
+
+    QThreadPool decodePool; ///< Threads the files are decoded on.
+    QFileSystemWatcher watcher; ///< Reports changes of the folder and its files.
+    QTimer scanTimer; ///< Waits until the folder has settled before scanning it.
+    QString userDirectory; ///< Watched folder.
+    QHash<QString, FileState> files; ///< Files of the folder by path.
+    quint64 lastGeneration = 0; ///< Source of FileState::generation.
+    QMap<QString, std::shared_ptr<const DecodedSound>> builtInSounds; ///< Decoded built-in sounds by name.
+    QMap<QString, std::shared_ptr<const DecodedSound>> userSounds; ///< Decoded user sounds by name.
+    qint64 trackStart = 0; ///< Offset streamed tracks start at, in milliseconds.
+    int trackFadeIn = 0; ///< Fade-in of streamed tracks, in milliseconds.
+};
+
+/**
+ * @class LoopingSoundDevice
+ * @brief Read-only device that returns the samples of a sound over and over.
+ *
+ * Used in pull mode by a QAudioOutput to ring until the alarm is answered.
+ */
+class LoopingSoundDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the device; it still has to be opened.
+     * @param sound The sound to repeat.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit LoopingSoundDevice(std::shared_ptr<const DecodedSound> sound, QObject *parent = nullptr);
+
+    /**
+     * @brief Switches to another sound and starts it from the beginning.
+     *
+     * Lets one device (and the audio output reading it) be reused for every
+     * alarm. An empty pointer releases the sound; reads then return nothing.
+     */
+    void setSound(std::shared_ptr<const DecodedSound> sound);
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    std::shared_ptr<const DecodedSound> decoded; ///< Samples being repeated (may be empty).
+    qint64 position = 0; ///< Offset of the next byte to return.
+};
+
+/**
+ * @class StreamingSoundDevice
+ * @brief Read-only device that plays a long track from its file, over and over.
+ *
+ * The file is memory-mapped one window at a time and the samples are
+ * copied into a small ring buffer ahead of the reads, with the fade-in
+ * applied on the way. Only the ring and one window are in memory however
+ * long the track is, and opening the device reads nothing but the first
+ * window, so playback starts just as fast for an hour-long file. At the
+ * end the track starts again from the start offset, without the fade.
+ */
+class StreamingSoundDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 WindowBytes = 256 * 1024; ///< Part of the file mapped at a time.
+    static constexpr int RingBytes = 64 * 1024; ///< Samples decoded ahead of the reads.
+
+    /**
+     * @brief Constructs the device; it still has to be opened.
+     * @param sound A streamed track (see DecodedSound::isStreamed()).
+     * @param startMs Offset to start at; an offset past the end starts at the beginning.
+     * @param fadeInMs Duration of the fade-in (0 for none).
+     * @param parent The parent object (default is nullptr).
+     */
+    StreamingSoundDevice(std::shared_ptr<const DecodedSound> sound, qint64 startMs, int fadeInMs,
+                         QObject *parent = nullptr);
+
+    /**
+     * @brief Opens the file and maps the window at the start offset.
+     * @return False if the file cannot be opened or mapped.
+     */
+    bool open(OpenMode mode) override;
+
+    /**
+     * @brief Unmaps the window and closes the file.
+     */
+    void close() override;
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    /**
+     * @brief Decodes samples from the file into the free part of the ring.
+     */
+    void refill();
+
+    /**
+     * @brief Maps the window holding the given file offset.
+     * @return False if the file cannot be mapped there.
+     */
+    bool mapWindow(qint64 offset);
+
+    /**
+     * @brief Scales frames that fall within the fade-in.
+     */
+    void applyFade(char *frames, qint64 frameCount);
+
+    std::shared_ptr<const DecodedSound> decoded; ///< Track being played.
+    QFile file; ///< The track's file.
+    uchar *window = nullptr; ///< Mapped part of the file.
+    qint64 windowStart = 0; ///< File offset of the mapped part.
+    qint64 windowSize = 0; ///< Size of the mapped part.
+    qint64 startOffset = 0; ///< File offset playback starts (and loops back) at.
+    qint64 filePosition = 0; ///< File offset of the next byte to decode.
+    qint64 fadeFrames = 0; ///< Length of the fade-in, in frames.
+    qint64 decodedFrames = 0; ///< Frames decoded since the start, up to fadeFrames.
+    QByteArray ring; ///< Decoded samples, RingBytes rounded down to whole frames.
+    int ringRead = 0; ///< Offset of the next byte to return.
+    int ringFill = 0; ///< Decoded bytes not returned yet.
+};
+
+#endif // SOUNDLIBRARY_H
@@ -0,0 +1,130 @@
+/**
+ * @file stallwatchdog.h
+ * @brief Header file for the StallWatchdog class.
+ *
+ * This file defines the StallWatchdog class, which measures how responsive
+ * the GUI event loop is from a separate thread and records every stall
+ * longer than a threshold together with the slot that was running.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+
+class QThread;
+
+/**
+ * @class StallWatchdog
+ * @brief Detects event-loop stalls of the thread it was created in.
+ *
+ * A precise timer on the GUI thread stamps a heartbeat every few tens of
+ * milliseconds. A monitor thread checks the heartbeat; when it stops for
+ * longer than the threshold the stall is attributed to the slot reported by
+ * SlotProfiler::activeSlot(), and recorded once the loop runs again.
+ */
+class StallWatchdog : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief One recorded stall.
+     */
+    struct Stall {
+        QDateTime startedAt; ///< Local time the event loop stopped responding.
+        qint64 durationMs;   ///< How long the event loop was blocked.
+        QString slot;        ///< Slot running during the stall ("" if unknown).
+    };
+
+    /**
+     * @brief Constructs a watchdog for the current thread's event loop.
+     * @param thresholdMs Shortest blockage reported as a stall.
+     * @param parent The parent object (default is nullptr).
+     */
+    explicit StallWatchdog(int thresholdMs = 250, QObject *parent = nullptr);
+
+    /**
+     * @brief Stops the monitor thread.
+     */
+    ~StallWatchdog() override;
+
+    /**
+     * @brief Starts the heartbeat and the monitor thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the heartbeat and the monitor thread.
+     */
+    void stop();
+
+    /**
+     * @brief Returns the stall threshold in milliseconds.
+     */
+    int threshold() const { return thresholdMs; }
+
+    /**
+     * @brief Returns the most recent stalls, oldest first.
+     */
+    const QVector<Stall> &recentStalls() const { return stalls; }
+
+    /**
+     * @brief Returns the number of stalls since start().
+     */
+    int stallCount() const { return totalStalls; }
+
+    /**
+     * @brief Returns the longest stall since start(), in milliseconds.
+     */
+    qint64 worstStallMs() const { return worstMs; }
+
+signals:
+    /**
+     * @brief Emitted on the GUI thread once a stall has ended.
+     * @param stall The stall that was recorded.
+     */
+    void stallDetected(const StallWatchdog::Stall &stall);
+
+private:
+    /**
+     * @brief Stamps the heartbeat (GUI thread).
+     */
+    void beat();
+
+    /**
+     * @brief Body of the monitor thread.
+     */
+    void watch();
+
+    /**
+     * @brief Stores a finished stall and reports it (GUI thread).
+     */
+    void recordStall(qint64 startMs, qint64 durationMs, const char *slot);
+
+    static const int heartbeatMs = 50;  ///< Heartbeat period.
+    static const int maxStalls = 64;    ///< Number of stalls kept in recentStalls().
+
+    const int thresholdMs;              ///< Shortest reported stall.
+    QTimer heartbeat;                   ///< Fires beat() on the GUI thread.
+    QElapsedTimer monotonic;            ///< Shared monotonic time base.
+    QDateTime startedAt;                ///< Wall-clock time monotonic was started.
+    QThread *monitor = nullptr;         ///< Monitor thread.
+    std::atomic<qint64> lastBeatMs{0};  ///< Monotonic time of the last heartbeat.
+    std::atomic<bool> running{false};   ///< Tells the monitor thread to keep going.
+    QVector<Stall> stalls;              ///< Recent stalls (GUI thread only).
+    int totalStalls = 0;                ///< Stalls since start().
+    qint64 worstMs = 0;                 ///< Longest stall since start().
+};
+
+Q_DECLARE_METATYPE(StallWatchdog::Stall)
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,78 @@
+/**
+ * @file stopwatch.h
+ * @brief Header file for the Stopwatch class.
+ *
+ * This file defines the Stopwatch class, which measures elapsed time and
+ * lap times on the monotonic clock.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+#include <QVector>
+#include "clocksource.h"
+
+/**
+ * @class Stopwatch
+ * @brief Start/stop/lap stopwatch on ClockSource::monotonicMSecs().
+ *
+ * The stopwatch keeps the time accumulated over earlier runs plus the
+ * monotonic instant the current run started at; nothing ticks while it runs,
+ * and the elapsed time is exact whenever it is read.
+ */
+class Stopwatch {
+public:
+    /**
+     * @brief Constructs a stopped stopwatch at zero.
+     * @param clock Clock to measure on (nullptr means the system clock).
+     */
+    explicit Stopwatch(ClockSource *clock = nullptr) : clockSource(clock ? clock : ClockSource::system()) {}
+
+    /**
+     * @brief Starts or resumes measuring.
+     */
+    void start();
+
+    /**
+     * @brief Stops measuring, keeping the elapsed time.
+     */
+    void stop();
+
+    /**
+     * @brief Stops and clears the elapsed time and the laps.
+     */
+    void reset();
+
+    /**
+     * @brief Records a lap at the current elapsed time.
+     * @return The length of the lap in ms.
+     */
+    qint64 lap();
+
+    /**
+     * @brief Returns true while measuring.
+     */
+    bool isRunning() const { return running; }
+
+    /**
+     * @brief Returns the total elapsed time in ms.
+     */
+    qint64 elapsedMs() const;
+
+    /**
+     * @brief Returns the elapsed time at the end of every lap, oldest first.
+     */
+    const QVector<qint64> &splits() const { return lapSplits; }
+
+private:
+    ClockSource *clockSource; ///< Source of the monotonic time.
+    qint64 accumulatedMs = 0; ///< Elapsed time of the finished runs.
+    qint64 startedAt = 0; ///< Monotonic start of the current run.
+    bool running = false; ///< True while measuring.
+    QVector<qint64> lapSplits; ///< Elapsed time at the end of each lap.
+};
+
+#endif // STOPWATCH_H
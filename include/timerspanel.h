@@ -0,0 +1,135 @@
+/**
+ * @file timerspanel.h
+ * @brief Header file for the TimersPanel class.
+ *
+ * This file defines the TimersPanel window, which lists the countdown
+ * timers and holds the stopwatch.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef TIMERSPANEL_H
+#define TIMERSPANEL_H
+
+#include <QHash>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QTimeEdit>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QWidget>
+#include "countdowntimers.h"
+#include "stopwatch.h"
+
+/**
+ * @class TimersPanel
+ * @brief Window with any number of countdown timers and a stopwatch with laps.
+ *
+ * The timers and the stopwatch keep running while the window is closed; the
+ * window only draws them. All of them are drawn by one frame timer that
+ * reads the monotonic clock once per frame and changes only the texts that
+ * differ, so Qt repaints the window once per frame however many timers run.
+ * Frames come every 16 ms while the stopwatch runs, otherwise just when the
+ * next countdown's second changes, and not at all while the window is hidden.
+ */
+class TimersPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the panel over the application's timers.
+     * @param timers The countdown timers to show (not owned).
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit TimersPanel(CountdownTimers *timers, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief Updates every running display from one clock reading and plans the next frame.
+     */
+    void renderFrame();
+
+    /**
+     * @brief Adds a timer from the label and duration fields.
+     */
+    void addTimer();
+
+    /**
+     * @brief Creates the row of a new timer.
+     */
+    void onTimerAdded(quint64 id);
+
+    /**
+     * @brief Deletes the row of a removed timer.
+     */
+    void onTimerRemoved(quint64 id);
+
+    /**
+     * @brief Updates the buttons of a timer that started, paused, reset or finished.
+     */
+    void onTimerStateChanged(quint64 id);
+
+    /**
+     * @brief Starts or stops the stopwatch.
+     */
+    void toggleStopwatch();
+
+    /**
+     * @brief Adds a lap to the lap list.
+     */
+    void recordLap();
+
+    /**
+     * @brief Clears the stopwatch and its laps.
+     */
+    void resetStopwatch();
+
+private:
+    /**
+     * @brief Widgets of one timer.
+     */
+    struct Row {
+        QWidget *container = nullptr;     ///< Holds the row's widgets.
+        QLabel *time = nullptr;           ///< Time left.
+        QPushButton *startPause = nullptr; ///< "Start", "Pause" or "Restart".
+        QString shownText;                ///< Text of time, to skip unchanged updates.
+    };
+
+    /**
+     * @brief Draws a frame on the next pass of the event loop; several requests make one frame.
+     */
+    void requestFrame();
+
+    /**
+     * @brief Formats the time left of a countdown, rounded up to the second ("1:04:05", "4:05").
+     */
+    static QString countdownText(qint64 ms);
+
+    /**
+     * @brief Formats the stopwatch time with hundredths ("04:05.27", "1:04:05.27").
+     */
+    static QString stopwatchText(qint64 ms);
+
+    static const int frameMs = 16; ///< Frame interval while the stopwatch runs (about 60 Hz).
+
+    CountdownTimers *countdownTimers; ///< The timers shown (not owned).
+    Stopwatch stopwatch; ///< The stopwatch shown.
+    QHash<quint64, Row> rows; ///< Row of every timer by id.
+    QVBoxLayout *rowLayout; ///< One row per timer.
+    QLineEdit *labelEdit; ///< Label of the next timer.
+    QTimeEdit *durationEdit; ///< Length of the next timer.
+    QLabel *stopwatchLabel; ///< Stopwatch time.
+    QString shownStopwatchText; ///< Text of stopwatchLabel, to skip unchanged updates.
+    QPushButton *stopwatchButton; ///< "Start" or "Stop".
+    QListWidget *lapList; ///< Laps, newest first.
+    QTimer frameTimer; ///< Draws the next frame.
+};
+
+#endif // TIMERSPANEL_H
@@ -0,0 +1,174 @@
+/**
+ * @file timingwheel.h
+ * @brief Header file for the TimingWheel class.
+ *
+ * This file defines the TimingWheel class, a hierarchical timing wheel with
+ * minute resolution used by the alarm core to find due alarms without
+ * scanning every registered alarm on each tick.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TimingWheel
+ * @brief Hierarchical timing wheel with O(1) insert, cancel and per-minute advance.
+ *
+ * Time is measured in "wheel minutes": local wall-clock minutes counted from
+ * Monday 1970-01-05 00:00, so that (minute % MinutesPerWeek) is the minute of
+ * the week starting on Monday.
+ *
+ * Two kinds of entries are supported:
+ * - Weekly entries live permanently in one of 10080 minute-of-week buckets
+ *   and fire every time the wheel passes that minute of the week.
+ * - One-shot entries live in four cascading levels of 64 buckets each
+ *   (1 minute, 64 minutes, ~68 hours and ~182 days per bucket) and are
+ *   removed when they fire.
+ *
+ * Entries are kept in intrusive doubly linked lists inside a single node
+ * array, so inserting or cancelling never searches, and advancing by one
+ * minute touches a fixed number of buckets plus the entries that fire or
+ * cascade. The wheel is plain C++ with no Qt dependency.
+ */
+class TimingWheel {
+public:
+    /**
+     * @brief Identifies an entry; stale handles are detected by a generation count.
+     */
+    using Handle = std::uint64_t;
+
+    static constexpr Handle InvalidHandle = 0;          ///< Never returned by schedule calls.
+    static constexpr std::int64_t MinutesPerWeek = 7 * 24 * 60; ///< Number of weekly buckets.
+
+    /**
+     * @brief Constructs an empty wheel whose current minute is startMinute.
+     * @param startMinute The wheel minute the wheel starts at.
+     */
+    explicit TimingWheel(std::int64_t startMinute = 0);
+
+    /**
+     * @brief Returns the last minute the wheel has advanced to.
+     */
+    std::int64_t currentMinute() const { return origin + current; }
+
+    /**
+     * @brief Returns the number of scheduled entries.
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Pre-allocates space for the given number of entries.
+     */
+    void reserve(std::size_t entries);
+
+    /**
+     * @brief Schedules a one-shot entry.
+     *
+     * Entries at or before the current minute fire on the next advance.
+     *
+     * @param minute The wheel minute to fire at.
+     * @param payload Value passed back when the entry fires.
+     * @return Handle for cancel().
+     */
+    Handle scheduleAt(std::int64_t minute, std::uint64_t payload);
+
+    /**
+     * @brief Schedules an entry that fires every week.
+     * @param minuteOfWeek Minute of the week, 0 = Monday 00:00, 10079 = Sunday 23:59.
+     * @param payload Value passed back when the entry fires.
+     * @return Handle for cancel().
+     */
+    Handle scheduleWeekly(int minuteOfWeek, std::uint64_t payload);
+
+    /**
+     * @brief Removes an entry.
+     * @param handle Handle returned by a schedule call.
+     * @return False if the handle is unknown, already fired (one-shot) or cancelled.
+     */
+    bool cancel(Handle handle);
+
+    /**
+     * @brief Removes every entry and restarts the wheel at the given minute.
+     */
+    void clear(std::int64_t startMinute);
+
+    /**
+     * @brief Advances the wheel minute by minute up to the given minute.
+     *
+     * For each minute passed, fire(payload, handle) is called for every entry
+     * due at that minute. The callback may schedule or cancel entries. Moving
+     * backwards does nothing.
+     *
+     * @param minute The wheel minute to advance to.
+     * @param fire Callable taking (std::uint64_t payload, Handle handle).
+     * @return The number of entries fired.
+     */
+    template <typename Fire>
+    std::size_t advanceTo(std::int64_t minute, Fire &&fire) {
+        std::size_t fired = 0;
+        while (origin + current < minute) {
+            collectNextMinute();
+            for (const Fired &entry : scratch) {
+                // A weekly entry may have been cancelled by an earlier callback
+                if (entry.weekly && !isLive(entry.handle)) continue;
+                fire(entry.payload, entry.handle);
+                ++fired;
+            }
+        }
+        return fired;
+    }
+
+private:
+    static constexpr int LevelBits = 6;
+    static constexpr int LevelSize = 1 << LevelBits;
+    static constexpr int LevelCount = 4;
+    static constexpr std::uint32_t Nil = 0xFFFFFFFFu;
+
+    /**
+     * @brief One entry (or bucket sentinel) in the node array.
+     */
+    struct Node {
+        std::uint64_t payload = 0;  ///< User value.
+        std::int32_t deadline = 0;  ///< One-shot: minute relative to origin. Weekly: -1.
+        std::uint32_t prev = Nil;   ///< Previous node in the bucket list.
+        std::uint32_t next = Nil;   ///< Next node in the bucket list (or free list).
+        std::uint32_t generation = 0; ///< Odd while the node is in use.
+    };
+
+    /**
+     * @brief An entry collected for firing during advanceTo().
+     */
+    struct Fired {
+        std::uint64_t payload;
+        Handle handle;
+        bool weekly;
+    };
+
+    std::uint32_t allocateNode();
+    void freeNode(std::uint32_t index);
+    void linkBefore(std::uint32_t sentinel, std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void place(std::uint32_t index);
+    void cascade(int level);
+    void collectNextMinute();
+    bool isLive(Handle handle) const;
+    Handle handleFor(std::uint32_t index) const;
+    std::uint32_t weeklySentinel(std::int64_t minute) const;
+    std::uint32_t levelSentinel(int level, int slot) const;
+
+    std::vector<Node> nodes;     ///< Bucket sentinels followed by entries.
+    std::vector<Fired> scratch;  ///< Entries firing in the minute being processed.
+    std::uint32_t freeList = Nil; ///< First free entry node.
+    std::int64_t origin;         ///< Wheel minute that relative minute 0 stands for.
+    std::int32_t current = 0;    ///< Current minute relative to origin.
+    std::size_t count = 0;       ///< Number of live entries.
+};
+
+#endif // TIMINGWHEEL_H
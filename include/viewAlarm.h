@@ -16,74 +16,213 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
-#include <QFrame>
+#include <QComboBox>
+#include <QAbstractListModel>
+#include <QListView>
+#include <QStyledItemDelegate>
 #include <QTime>
-#include <QMap>
-#include <QScrollArea>
-#include <QFile>
-#include <QTextStream>
+#include <QVector>
+#include <QTimer>
+#include "alarmchangetracker.h"
+#include "alarmstore.h"
+#include "alarmhistory.h"
+#include "holidaycalendar.h"
+#include "nextfireindex.h"
+#include "soundlibrary.h"
 
 /**
- * @class ViewAlarm
- * @brief A widget for displaying and managing active alarms.
+ * @class AlarmListModel
+ * @brief List model of the store's alarms, one row per alarm in store order.
  *
- * The ViewAlarm class provides a user interface for listing active alarms as buttons.
- * Users can interact with these alarms through the GUI.
+ * The model only keeps the ids of the rows it has announced to its view;
+ * texts, colours and countdowns are read from the store and the
+ * NextFireIndex when the view asks for a row, which it only does for the
+ * rows it paints. Store ids ascend in store order, so a row is found by a
+ * binary search over the ids. No snapshot is held, so the store never has
+ * to copy its list for this view.
  */
-class ViewAlarm : public QWidget {
+class AlarmListModel : public QAbstractListModel {
     Q_OBJECT
 
 public:
     /**
-     * @brief Constructs a ViewAlarm instance.
+     * @brief Roles served next to Qt::DisplayRole.
+     */
+    enum Role {
+        AlarmIdRole = Qt::UserRole, ///< Id of the alarm (quint64).
+        EnabledRole,                ///< True if the alarm can ring.
+        CountdownRole               ///< "in 3h 12m", or an empty string without a next fire instant.
+    };
+
+    /**
+     * @brief Constructs the model with the store's current alarms.
+     * @param store The alarm store to show.
+     * @param nextFires Next fire instants for the countdowns (nullptr leaves them empty).
+     * @param clock Clock the countdowns run against.
+     * @param parent The parent object (default is nullptr).
+     */
+    AlarmListModel(AlarmStore *store, NextFireIndex *nextFires, ClockSource *clock, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Re-reads the ids of every alarm and resets the view.
+     */
+    void reload();
+
+    /**
+     * @brief Applies a batch of store changes as row insertions, removals and data changes.
      *
-     * Initializes the alarm display layout and related UI components.
+     * If the changes do not start at the version currently shown, or touch
+     * most of the list, the model is reloaded instead.
      *
-     * @param parent The parent widget (default is nullptr).
+     * @param fromVersion The store version before the changes.
+     * @param toVersion The store version after the changes.
+     * @param changes The changed alarms (see AlarmChangeTracker::changesReady()).
      */
-    explicit ViewAlarm(QWidget *parent = nullptr);
+    void applyChanges(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
 
     /**
-     * @brief Updates the list of alarms displayed.
-     *
-     * This function refreshes the UI to show updated alarm times and labels.
+     * @brief Tells the view that the countdowns of rows first to last (inclusive) have moved on.
+     */
+    void refreshCountdowns(int first, int last);
+
+    /**
+     * @brief Returns the text shown for an alarm ("label - HH:mm:ss [group] (Off)").
+     */
+    static QString alarmText(const Alarm &alarm);
+
+    /**
+     * @brief Returns the countdown shown for an alarm that rings in msecs milliseconds.
      *
-     * @param alarms List of alarm times.
-     * @param labels List of alarm labels.
+     * Minutes are rounded up, so "in 1m" is shown until the final minute,
+     * which counts down in seconds.
      */
+    static QString countdownText(qint64 msecs);
+
+private:
+    /**
+     * @brief Returns the row of an alarm, or -1 if it has none.
+     */
+    int rowOf(quint64 id) const;
+
+    AlarmStore *alarmStore; /**< Source of the alarms */
+    NextFireIndex *nextFireIndex; /**< Source of the countdowns (may be nullptr) */
+    ClockSource *clockSource; /**< Clock the countdowns run against */
+    QVector<quint64> rowIds; /**< Id of each row, ascending */
+    quint64 shownVersion = 0; /**< Store version the rows reflect */
+};
+
+/**
+ * @class AlarmItemDelegate
+ * @brief Paints an alarm row as a rounded button with its countdown at the right edge.
+ *
+ * Enabled alarms are purple, disabled ones grey. Every row has the same
+ * height, so the view lays out 100k rows without measuring them.
+ */
+class AlarmItemDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+/**
+ * @class ViewAlarm
+ * @brief A widget for displaying and managing active alarms.
+ *
+ * The ViewAlarm class lists the alarms of the shared AlarmStore in a
+ * QListView over an AlarmListModel, so the window holds the same few widgets
+ * whatever the number of alarms and only the visible rows are painted. The
+ * model is patched from the store's change stream, coalesced by an
+ * AlarmChangeTracker, so it is updated at most once per event-loop
+ * iteration, and not at all while the window is hidden. Clicking a row opens
+ * the alarm's details; edits made there are written straight back to the
+ * store. When an AlarmHistory is given, a History tab lists past fire,
+ * snooze and dismiss events. When a NextFireIndex is given, each row shows
+ * how long until the alarm rings; only the visible rows are kept current.
+ * Disabled alarms are shown greyed out, and a whole group can be switched on
+ * or off from the group bar above the list with a single store change.
+ */
+class ViewAlarm : public QWidget {
+    Q_OBJECT
 
-    void updateAlarmList(const QList<QTime> &alarms, const QList<QString> &labels, const QList<QString> &repeats, const QList<bool> &isSnoozed);
+public:
+    /**
+     * @brief Constructs a ViewAlarm instance.
+     *
+     * Initializes the alarm display layout and shows the store's current alarms.
+     *
+     * @param store The alarm store to display and edit.
+     * @param calendars Holiday calendars offered in the details dialog (may be nullptr).
+     * @param history Event history shown in the History tab (nullptr hides the tab).
+     * @param nextFires Next fire instants for the countdowns (nullptr hides them).
+     * @param clock Clock the countdowns run against (nullptr means the system clock).
+     * @param sounds Sounds offered in the details dialog (nullptr offers the built-in names).
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit ViewAlarm(AlarmStore *store, HolidayCalendars *calendars = nullptr, AlarmHistory *history = nullptr,
+                       NextFireIndex *nextFires = nullptr, ClockSource *clock = nullptr,
+                       const SoundLibrary *sounds = nullptr, QWidget *parent = nullptr);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
-    QVBoxLayout *alarmsLayout; /**< Layout to hold alarm buttons */
-    QMap<QPushButton*, QString> alarmButtons; /**< Map buttons to labels */
-    QList<QTime> alarms; /**< Stores alarm times */
-    QList<QString> alarmLabels; /**< Stores alarm labels */
-    QList<QString> alarmRepeats; /**< Stores alarm repeat settings */
-    QList<bool> alarmIsSnoozed;  // Add this to the private section
+    /**
+     * @brief Refills the group selector if groups were added or removed; hides the bar when there are none.
+     */
+    void updateGroupBar();
 
-signals:
-    void alarmModified(int index, QTime newTime, QString newRepeat, QString newLabel, QString newSound);
-    void alarmDeleted(const QString &label);
+    /**
+     * @brief Switches every alarm of the selected group on or off.
+     */
+    void setSelectedGroupEnabled(bool enabled);
 
+    AlarmStore *alarmStore; /**< Shared source of truth for alarms */
+    HolidayCalendars *holidayCalendars; /**< Calendars an alarm can skip */
+    AlarmChangeTracker *changeTracker; /**< Batches store changes for this view */
+    AlarmListModel *alarmModel; /**< Rows of the alarm list */
+    QListView *alarmList; /**< Shows the alarms */
+    NextFireIndex *nextFireIndex; /**< Source of the countdowns (may be nullptr) */
+    const SoundLibrary *soundLibrary; /**< Sounds offered when an alarm is modified */
+    QTimer countdownTimer; /**< Ticks the countdowns every second while shown */
+    QWidget *groupBar; /**< Group selector with its enable and disable buttons */
+    QComboBox *groupComboBox; /**< Selects the group to switch */
+    QStringList shownGroups; /**< Groups listed in groupComboBox */
 
 private slots:
     /**
-     * @brief Handles user interactions with an alarm button.
+     * @brief Applies a batch of store changes to the list and the group bar.
+     *
+     * @param fromVersion The store version before the changes.
+     * @param toVersion The store version after the changes.
+     * @param changes The changed alarms.
+     */
+    void applyChanges(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes);
+
+    /**
+     * @brief Repaints the countdowns of the rows inside the viewport.
      *
-     * This slot is triggered when an alarm button is clicked.
+     * The first and last visible rows are found at the viewport's top and
+     * bottom edges, and only that range is reported as changed, so a tick
+     * costs the same with 100k alarms as with 10.
      */
-    void handleAlarmClick();
+    void updateVisibleCountdowns();
 
     /**
-     * @brief Removes an alarm from the list.
+     * @brief Opens the details of a clicked alarm.
      *
-     * This function removes an alarm entry based on the provided label.
+     * This slot is triggered when a row of the alarm list is clicked.
      *
-     * @param alarmLabel The label of the alarm to be removed.
+     * @param index The clicked row.
      */
-    void removeAlarm(const QString &alarmLabel);
+    void handleAlarmClick(const QModelIndex &index);
 };
 
 
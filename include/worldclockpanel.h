@@ -0,0 +1,106 @@
+/**
+ * @file worldclockpanel.h
+ * @brief Header file for the WorldClockPanel class.
+ *
+ * This file defines the WorldClockPanel window, which shows the current
+ * time in any number of time zones side by side.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef WORLDCLOCKPANEL_H
+#define WORLDCLOCKPANEL_H
+
+#include <QComboBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include "clockface.h"
+#include "clocksource.h"
+#include "zoneoffsettable.h"
+
+/**
+ * @class WorldClockPanel
+ * @brief Window with one clock per selected time zone.
+ *
+ * Every tick reads the clock once and derives all zones from that reading
+ * through a ZoneOffsetTable, so the zone database is only consulted when a
+ * zone crosses a DST transition. The offset/day captions are rebuilt only
+ * when they change, and nothing is updated while the window is hidden.
+ */
+class WorldClockPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the panel with a default set of zones.
+     * @param clock Clock to read the time from (nullptr means the system clock).
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit WorldClockPanel(ClockSource *clock = nullptr, QWidget *parent = nullptr);
+
+    /**
+     * @brief Adds a clock for a zone.
+     * @param zoneId IANA id of the zone, e.g. "Asia/Tokyo".
+     * @return False if the zone is unknown or already shown.
+     */
+    bool addZone(const QByteArray &zoneId);
+
+    /**
+     * @brief Removes the clock of a zone.
+     * @param zoneId IANA id of the zone.
+     */
+    void removeZone(const QByteArray &zoneId);
+
+    /**
+     * @brief Returns the ids of the zones shown, in display order.
+     */
+    QList<QByteArray> zones() const;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief Updates every clock from a single clock reading.
+     */
+    void tick();
+
+    /**
+     * @brief Adds the zone selected in the zone picker.
+     */
+    void addSelectedZone();
+
+private:
+    /**
+     * @brief Widgets of one zone; row i uses zone i + 1 of the offset table.
+     */
+    struct Row {
+        QByteArray zoneId;      ///< IANA id.
+        QLabel *name;           ///< City name.
+        ClockFace *face;        ///< Time display.
+        QLabel *detail;         ///< Day difference and UTC offset.
+        QPushButton *remove;    ///< Removes the row.
+        int shownOffset = -1;   ///< Offset the caption was built for (-1 forces a rebuild).
+        qint64 shownDayDelta = 0; ///< Day difference the caption was built for.
+    };
+
+    /**
+     * @brief Formats the caption below a clock, e.g. "Tomorrow, UTC+09:00".
+     */
+    static QString caption(qint64 dayDelta, int offsetSeconds);
+
+    ClockSource *clockSource; ///< Source of the current time.
+    ZoneOffsetTable offsets; ///< Entry 0 is the system zone, entry i + 1 belongs to rows[i].
+    QVector<Row> rows; ///< Shown zones.
+    QGridLayout *grid; ///< One line per zone.
+    QComboBox *zonePicker; ///< Every known zone id.
+    QTimer tickTimer; ///< Once a second while visible.
+};
+
+#endif // WORLDCLOCKPANEL_H
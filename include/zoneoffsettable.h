@@ -0,0 +1,105 @@
+/**
+ * @file zoneoffsettable.h
+ * @brief Header file for the ZoneOffsetTable class.
+ *
+ * This file defines the ZoneOffsetTable class, which converts one UTC
+ * reading into the local time of many time zones with integer arithmetic,
+ * consulting the time zone database only when a zone's offset changes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#ifndef ZONEOFFSETTABLE_H
+#define ZONEOFFSETTABLE_H
+
+#include <QTimeZone>
+#include <QVector>
+#include <limits>
+
+/**
+ * @class ZoneOffsetTable
+ * @brief Cached UTC offsets with the interval during which each is valid.
+ *
+ * For every zone the table keeps the current offset together with the
+ * previous and next transition instants. update() only goes back to
+ * QTimeZone for zones whose interval no longer contains the given instant
+ * (a DST change, or the clock being set), so a tick normally costs one
+ * comparison and one addition per zone.
+ */
+class ZoneOffsetTable {
+public:
+    /**
+     * @brief Wall-clock fields of a local time.
+     */
+    struct LocalTime {
+        qint64 julianDay; ///< Local date as a Julian day.
+        int hour;         ///< 0-23.
+        int minute;       ///< 0-59.
+        int second;       ///< 0-59.
+    };
+
+    /**
+     * @brief Adds a zone.
+     * @param zone The time zone.
+     * @return Index of the zone in the table.
+     */
+    int addZone(const QTimeZone &zone);
+
+    /**
+     * @brief Removes a zone; later zones move down by one index.
+     */
+    void removeZone(int index);
+
+    /**
+     * @brief Returns the number of zones.
+     */
+    int count() const { return entries.size(); }
+
+    /**
+     * @brief Returns a zone.
+     */
+    const QTimeZone &zone(int index) const { return entries[index].zone; }
+
+    /**
+     * @brief Makes every offset valid for the given instant.
+     * @param utcMSecs Milliseconds since the epoch (UTC).
+     * @return The number of zones that had to be looked up again.
+     */
+    int update(qint64 utcMSecs);
+
+    /**
+     * @brief Returns the cached UTC offset of a zone, in seconds.
+     */
+    int offsetSeconds(int index) const { return entries[index].offset; }
+
+    /**
+     * @brief Converts a UTC instant to local time using the cached offset.
+     *
+     * Call update() with the same (or an earlier, still valid) instant first.
+     *
+     * @param index The zone.
+     * @param utcMSecs Milliseconds since the epoch (UTC).
+     */
+    LocalTime localTime(int index, qint64 utcMSecs) const;
+
+private:
+    /**
+     * @brief One zone with its cached offset.
+     */
+    struct Entry {
+        QTimeZone zone;  ///< The zone.
+        int offset = 0;  ///< Offset from UTC in seconds.
+        qint64 validFrom = std::numeric_limits<qint64>::max(); ///< First instant the offset applies (ms).
+        qint64 validUntil = std::numeric_limits<qint64>::min(); ///< Instant the offset stops applying (ms).
+    };
+
+    /**
+     * @brief Looks up the offset and its validity interval in the zone database.
+     */
+    static void recompute(Entry &entry, qint64 utcMSecs);
+
+    QVector<Entry> entries; ///< Zones in insertion order.
+};
+
+#endif // ZONEOFFSETTABLE_H
@@ -4,30 +4,183 @@
  *
  * This file contains the main function, which initializes
  * the QApplication and displays the main window.
- * 
+ *
  * @author Group 27
  * @date Friday, March 14
  */
 
  #include <QApplication>
+ #include <QCoreApplication>
+ #include <QCommandLineParser>
+ #include <QPixmapCache>
+ #include <QStandardPaths>
+ #include <QTimer>
+ #include <cstdio>
+ #include "alarmhistory.h"
  #include "mainwindow.h"
- 
+ #include "memoryusage.h"
+ #include "singleinstance.h"
+ #include "stallwatchdog.h"
+
  /**
   * @brief The main function of the application.
   *
   * This function initializes a QApplication instance, creates the main window,
   * displays it, and starts the event loop.
   *
+  * Memory options (used by the kiosk footprint check):
+  * - --report-rss <seconds> logs the resident set size periodically.
+  * - --run-for <seconds> quits after the given time.
+  * - --rss-budget <KB> makes the exit status 2 if the final RSS exceeds the budget.
+  *
+  * Latency options:
+  * - --stall-threshold <ms> sets the shortest event-loop stall that is logged (0 disables the watchdog).
+  * - --profile opens the profiler overlay at startup (Ctrl+Shift+P toggles it).
+  *
+  * --holidays <file> loads holiday calendars (repeatable).
+  *
+  * --sounds <folder> sets the folder whose .wav files are offered as alarm sounds.
+  *
+  * History options:
+  * - --history <file> sets the ring file fire, snooze and dismiss events are recorded in.
+  * - --history-size <records> sets how many events it keeps (default 8192, 64 bytes each).
+  *
+  * Only one instance runs per user. A later launch sends its command (e.g.
+  * "add 07:30 Wake", "list", "timer 5:00 Tea"; none means "show") to the
+  * running instance, prints the reply and exits before any GUI is created.
+  * --standalone runs an independent instance that takes no commands.
+  *
   * @param argc The number of command-line arguments.
   * @param argv The array of command-line arguments.
   * @return The exit status of the application.
   */
  int main(int argc, char *argv[]) {
+     QCommandLineParser parser;
+     parser.addHelpOption();
+     parser.addPositionalArgument("command", "Command for the running instance: show, alarms, agenda, timers, list, "
+                                             "add HH:mm[:ss] [label] [repeat] [sound], profiles, profile <name>, "
+                                             "timer <length> [label].",
+                                  "[command [arguments...]]");
+     parser.addOption({"standalone", "Run even if another instance is running, without accepting commands."});
+     parser.addOption({"report-rss", "Log the resident set size every <seconds>.", "seconds"});
+     parser.addOption({"run-for", "Quit after <seconds>.", "seconds"});
+     parser.addOption({"rss-budget", "Exit with status 2 if the final RSS exceeds <KB>.", "KB"});
+     parser.addOption({"stall-threshold", "Log event-loop stalls longer than <ms> (default 250, 0 disables).", "ms", "250"});
+     parser.addOption({"profile", "Show the slot timing and stall overlay."});
+     parser.addOption({"holidays", "Load holiday calendars from <file>. Repeatable.", "file"});
+     parser.addOption({"history", "Record alarm events in <file> (default in the app data folder).", "file"});
+     parser.addOption({"history-size", "Keep the last <records> events (default 8192).", "records", "8192"});
+     parser.addOption({"sounds", "Offer the .wav files in <folder> as alarm sounds (default in the app data folder).",
+                       "folder"});
+     parser.addOption({"profiles", "Keep each profile's alarms in a file in <folder> (default in the app data folder).",
+                       "folder"});
+     parser.addOption({"alarm-profile", "Show the alarms of profile <name>, creating it if needed (default Default).",
+                       "name"});
+     parser.addOption({"track-start", "Start long alarm tracks <seconds> in (default 0).", "seconds", "0"});
+     parser.addOption({"fade-in", "Fade long alarm tracks in over <seconds> (default 0).", "seconds", "0"});
+
+     // Decide before creating the GUI; parse errors are reported by process() below
+     QStringList arguments;
+     for (int i = 0; i < argc; ++i) {
+         arguments.append(QString::fromLocal8Bit(argv[i]));
+     }
+     parser.parse(arguments);
+     const bool standalone = parser.isSet("standalone") || parser.isSet("help");
+     SingleInstance instance; ///< Lock and command socket shared by every launch.
+     if (!standalone && !instance.tryPrimary()) {
+         // A core application is enough for the socket; no window system is touched
+         QCoreApplication forwarder(argc, argv);
+         QString reply;
+         const int status = instance.forward(parser.positionalArguments(), &reply);
+         fprintf(status == 0 ? stdout : stderr, "%s\n", qPrintable(reply));
+         return status;
+     }
+
+ #ifdef RISE_KIOSK
+     // Kiosk devices have no window system; default to the framebuffer unless told otherwise
+     if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+         qputenv("QT_QPA_PLATFORM", "linuxfb");
+     }
+ #endif
+
      QApplication app(argc, argv); ///< The main Qt application object.
-     
+
+     parser.process(app);
+     // The app data folder is only known once the application object exists
+     const QString appData = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+     const QString historyPath = parser.isSet("history") ? parser.value("history") : appData + "/history.ring";
+     const QString soundsPath = parser.isSet("sounds") ? parser.value("sounds") : appData + "/sounds";
+     const QString profilesPath = parser.isSet("profiles") ? parser.value("profiles") : appData + "/profiles";
+
+ #ifdef RISE_KIOSK
+     QPixmapCache::setCacheLimit(RISE_PIXMAP_CACHE_KB);
+ #endif
+
+     const int stallThreshold = parser.value("stall-threshold").toInt();
+     StallWatchdog stallWatchdog(stallThreshold > 0 ? stallThreshold : 250); ///< Measures event-loop responsiveness.
+     if (stallThreshold > 0) {
+         stallWatchdog.start();
+     }
+
+     const int historySize = parser.value("history-size").toInt();
+     AlarmHistory history(historyPath, historySize > 0 ? historySize : 8192); ///< Fire, snooze and dismiss log.
+
      MainWindow mainWindow; ///< The main application window.
+     mainWindow.profiles()->setHistory(history.isOpen() ? &history : nullptr);
+     mainWindow.profiles()->setDirectory(profilesPath);
+     if (parser.isSet("alarm-profile") && !mainWindow.profiles()->setActive(parser.value("alarm-profile"))) {
+         fprintf(stderr, "Invalid profile name: %s\n", qPrintable(parser.value("alarm-profile")));
+     }
+     mainWindow.setStallWatchdog(stallThreshold > 0 ? &stallWatchdog : nullptr);
+     mainWindow.sounds()->setDirectory(soundsPath);
+     mainWindow.sounds()->setTrackPlayback(qint64(parser.value("track-start").toDouble() * 1000),
+                                           int(parser.value("fade-in").toDouble() * 1000));
+     for (const QString &path : parser.values("holidays")) {
+         QString error;
+         if (mainWindow.profiles()->calendars()->importFile(path, &error).isEmpty()) {
+             fprintf(stderr, "%s\n", qPrintable(error.isEmpty() ? path + ": no dates found" : error));
+         }
+     }
+ #ifdef RISE_KIOSK
+     mainWindow.showFullScreen(); ///< Kiosk displays show only the clock.
+ #else
      mainWindow.show(); ///< Display the main window.
- 
+ #endif
+     if (parser.isSet("profile")) {
+         mainWindow.toggleProfilerOverlay();
+     }
+
+     // The first launch runs its own command too, e.g. "Alarm add 07:30 Wake"
+     if (!parser.positionalArguments().isEmpty()) {
+         QString reply;
+         const bool ok = mainWindow.handleCommand(parser.positionalArguments(), &reply);
+         fprintf(ok ? stdout : stderr, "%s\n", qPrintable(reply));
+     }
+     if (!parser.isSet("standalone")) {
+         instance.listen([&mainWindow](const QStringList &command, QString *reply) {
+             return mainWindow.handleCommand(command, reply);
+         });
+     }
+
+     const int reportSeconds = parser.value("report-rss").toInt();
+     RssReporter rssReporter(reportSeconds > 0 ? reportSeconds * 1000 : 10000, reportSeconds > 0);
+
+     if (parser.isSet("run-for")) {
+         QTimer::singleShot(parser.value("run-for").toInt() * 1000, &app, [&]() {
+             rssReporter.sample();
+             const qint64 budget = parser.value("rss-budget").toLongLong();
+             const bool overBudget = budget > 0 && rssReporter.lastKb() > budget;
+             fprintf(stderr, "RSS %lld KB (peak %lld KB, budget %lld KB): %s\n",
+                     rssReporter.lastKb(), rssReporter.peakKb(), budget,
+                     overBudget ? "OVER BUDGET" : "ok");
+             fprintf(stderr, "Stalls over %d ms: %d (worst %lld ms)\n",
+                     stallWatchdog.threshold(), stallWatchdog.stallCount(), stallWatchdog.worstStallMs());
+             const FireJitter &jitter = mainWindow.scheduler()->fireJitter();
+             fprintf(stderr, "Alarm lateness: %d alarms, mean %.1f ms, worst %lld ms\n",
+                     jitter.count, jitter.meanMs(), jitter.worstMs);
+             app.exit(overBudget ? 2 : 0);
+         });
+     }
+
      return app.exec(); ///< Enter the Qt event loop.
  }
- 
\ No newline at end of file
@@ -0,0 +1,189 @@
+/**
+ * @file agendaview.cpp
+ * @brief Implementation file for the AgendaView and AgendaModel classes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "agendaview.h"
+#include "slotprofiler.h"
+#include <QElapsedTimer>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+/**
+ * @brief Constructs an empty agenda model.
+ * @param store Store used to look up labels and repeat settings.
+ * @param parent The parent object.
+ */
+AgendaModel::AgendaModel(AlarmStore *store, QObject *parent)
+    : QAbstractTableModel(parent), alarmStore(store) {
+}
+
+/**
+ * @brief Replaces every row at once.
+ */
+void AgendaModel::setOccurrences(const QVector<Occurrence> &occurrences) {
+    beginResetModel();
+    rows = occurrences;
+    endResetModel();
+}
+
+int AgendaModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int AgendaModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : 3;
+}
+
+/**
+ * @brief Formats one cell on demand.
+ */
+QVariant AgendaModel::data(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid()) return QVariant();
+
+    const Occurrence &occurrence = rows[index.row()];
+    switch (index.column()) {
+    case 0:
+        // Occurrences are kept per minute; the second comes from the alarm
+        if (const Alarm *alarm = alarmStore->find(occurrence.alarmId)) {
+            return occurrence.dateTime().addSecs(alarm->time.second()).toString("ddd dd MMM  HH:mm:ss");
+        }
+        return occurrence.dateTime().toString("ddd dd MMM  HH:mm");
+    case 1:
+        if (const Alarm *alarm = alarmStore->find(occurrence.alarmId)) return alarm->displayLabel();
+        return QVariant();
+    case 2:
+        if (const Alarm *alarm = alarmStore->find(occurrence.alarmId)) return alarm->repeat;
+        return QVariant();
+    }
+    return QVariant();
+}
+
+QVariant AgendaModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    switch (section) {
+    case 0: return "When";
+    case 1: return "Label";
+    case 2: return "Repeat";
+    }
+    return QVariant();
+}
+
+/**
+ * @brief Builds the agenda window.
+ * @param cache Occurrence projection to query.
+ * @param store The alarm store.
+ * @param clock Clock defining "now".
+ * @param parent The parent widget.
+ */
+AgendaView::AgendaView(OccurrenceCache *cache, AlarmStore *store, ClockSource *clock, QWidget *parent)
+    : QWidget(parent), occurrenceCache(cache), clockSource(clock ? clock : ClockSource::system()) {
+    setWindowTitle("Agenda");
+    setWindowFlags(Qt::Window);
+    resize(480, 400);
+
+    rangeSelector = new QComboBox(this);
+    rangeSelector->addItem("Next 24 hours", 1);
+    rangeSelector->addItem("Next 7 days", 7);
+    rangeSelector->addItem("Next 30 days", 30);
+
+    timeFilter = new QCheckBox("Only between", this);
+    filterStart = new QTimeEdit(QTime(6, 0), this);
+    filterStart->setDisplayFormat("HH:mm");
+    filterEnd = new QTimeEdit(QTime(9, 0), this);
+    filterEnd->setDisplayFormat("HH:mm");
+    filterStart->setEnabled(false);
+    filterEnd->setEnabled(false);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(rangeSelector);
+    filterLayout->addWidget(timeFilter);
+    filterLayout->addWidget(filterStart);
+    filterLayout->addWidget(new QLabel("and", this));
+    filterLayout->addWidget(filterEnd);
+    filterLayout->addStretch();
+
+    model = new AgendaModel(store, this);
+    QTableView *table = new QTableView(this);
+    table->setModel(model);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->hide();
+    table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->horizontalHeader()->resizeSection(0, 150);
+
+    summaryLabel = new QLabel(this);
+
+    QPushButton *closeButton = new QPushButton("Close", this);
+    connect(closeButton, &QPushButton::clicked, this, &QWidget::close);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(table);
+    mainLayout->addWidget(summaryLabel);
+    mainLayout->addWidget(closeButton);
+
+    connect(rangeSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AgendaView::refresh);
+    connect(timeFilter, &QCheckBox::toggled, this, [this](bool on) {
+        filterStart->setEnabled(on);
+        filterEnd->setEnabled(on);
+        refresh();
+    });
+    connect(filterStart, &QTimeEdit::timeChanged, this, &AgendaView::refresh);
+    connect(filterEnd, &QTimeEdit::timeChanged, this, &AgendaView::refresh);
+
+    changeTracker = new AlarmChangeTracker(store, this);
+    changeTracker->setPaused(true);
+    connect(changeTracker, &AlarmChangeTracker::changesReady, this, &AgendaView::refresh);
+    connect(&minuteTimer, &QTimer::timeout, this, &AgendaView::refresh);
+}
+
+/**
+ * @brief Starts following the clock and the store when shown.
+ */
+void AgendaView::showEvent(QShowEvent *event) {
+    // The query reads the current store, so changes made while hidden need no replay
+    changeTracker->discard();
+    refresh();
+    changeTracker->setPaused(false);
+    minuteTimer.start(60 * 1000);
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Stops refreshing while hidden.
+ */
+void AgendaView::hideEvent(QHideEvent *event) {
+    changeTracker->setPaused(true);
+    minuteTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+/**
+ * @brief Runs the query for the selected window and filter.
+ */
+void AgendaView::refresh() {
+    RISE_PROFILE_SLOT("AgendaView::refresh");
+    if (!isVisible()) return;
+
+    const QDateTime from = clockSource->currentDateTime();
+    const QDateTime to = from.addDays(rangeSelector->currentData().toInt());
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<Occurrence> occurrences = timeFilter->isChecked()
+            ? occurrenceCache->occurrences(from, to, filterStart->time(), filterEnd->time())
+            : occurrenceCache->occurrences(from, to);
+    const qint64 queryUs = timer.nsecsElapsed() / 1000;
+
+    model->setOccurrences(occurrences);
+    summaryLabel->setText(QString("%1 occurrences (query %2 ms)")
+                              .arg(occurrences.size())
+                              .arg(QString::number(queryUs / 1000.0, 'f', 2)));
+}
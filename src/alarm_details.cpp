@@ -22,9 +22,17 @@
  * @param repeat The alarm's repeat setting.
  * @param label The alarm's label.
  * @param sound The alarm's sound setting.
+ * @param calendar The alarm's holiday calendar.
+ * @param group The alarm's group.
+ * @param enabled Whether the alarm is switched on.
+ * @param calendars Names of the holiday calendars to offer.
+ * @param groups Names of the existing groups to offer.
+ * @param sounds Sounds to offer; the list follows the user sound folder while the dialog is open.
  * @param parent The parent widget (default is nullptr).
  */
-AlarmDetails::AlarmDetails(QTime time, QString repeat, QString label, QString sound, QWidget *parent)
+AlarmDetails::AlarmDetails(QTime time, QString repeat, QString label, QString sound, QString calendar,
+                           QString group, bool enabled, const QStringList &calendars, const QStringList &groups,
+                           const SoundLibrary *sounds, QWidget *parent)
     : QDialog(parent) {
     setWindowTitle("Modify Alarm");
 
@@ -33,7 +41,7 @@ AlarmDetails::AlarmDetails(QTime time, QString repeat, QString label, QString so
     // Time Selection
     layout->addWidget(new QLabel("Change Time:"));
     timeEdit = new QTimeEdit(time, this);
-    timeEdit->setDisplayFormat("HH:mm");
+    timeEdit->setDisplayFormat("HH:mm:ss");
     layout->addWidget(timeEdit);
 
     // Repeat Dropdown
@@ -58,13 +66,52 @@ AlarmDetails::AlarmDetails(QTime time, QString repeat, QString label, QString so
     // Sound Dropdown
     layout->addWidget(new QLabel("Sound:"));
     soundComboBox = new QComboBox(this);
-    soundComboBox->addItem("Classic");
-    soundComboBox->addItem("Beep");
-    soundComboBox->addItem("Rooster");
-
+    if (sounds) {
+        sounds->populate(soundComboBox);
+    } else {
+        soundComboBox->addItem("Classic");
+        soundComboBox->addItem("Beep");
+        soundComboBox->addItem("Rooster");
+    }
+    // Also offered if its file was removed or is still being decoded
+    if (soundComboBox->findText(sound) == -1) {
+        soundComboBox->addItem(sound);
+    }
     soundComboBox->setCurrentText(sound);
     layout->addWidget(soundComboBox);
 
+    // Holiday calendar (also offered if the alarm refers to one that was removed)
+    calendarComboBox = new QComboBox(this);
+    calendarComboBox->addItem("None", QString());
+    for (const QString &name : calendars) {
+        calendarComboBox->addItem(name, name);
+    }
+    if (!calendar.isEmpty() && !calendars.contains(calendar)) {
+        calendarComboBox->addItem(calendar, calendar);
+    }
+    calendarComboBox->setCurrentIndex(qMax(0, calendarComboBox->findData(calendar)));
+    if (calendarComboBox->count() > 1) {
+        layout->addWidget(new QLabel("Skip Dates In:"));
+        layout->addWidget(calendarComboBox);
+    } else {
+        calendarComboBox->hide();
+    }
+
+    // Group (a new name starts a new group)
+    layout->addWidget(new QLabel("Group:"));
+    groupComboBox = new QComboBox(this);
+    groupComboBox->setEditable(true);
+    groupComboBox->addItem(QString());
+    groupComboBox->addItems(groups);
+    groupComboBox->lineEdit()->setPlaceholderText("No group");
+    groupComboBox->setCurrentText(group);
+    layout->addWidget(groupComboBox);
+
+    // A disabled alarm is kept but never rings
+    enabledCheckBox = new QCheckBox("Enabled", this);
+    enabledCheckBox->setChecked(enabled);
+    layout->addWidget(enabledCheckBox);
+
     // Buttons
     modifyButton = new QPushButton("Modify Alarm", this);
     deleteButton = new QPushButton("Delete Alarm", this);
@@ -94,7 +141,9 @@ AlarmDetails::AlarmDetails(QTime time, QString repeat, QString label, QString so
 
 void AlarmDetails::modifyAlarm() {
     qDebug() << "[MODIFY ALARM WINDOW] Emitting repeat value:" << repeatComboBox->currentText();
-    emit alarmModified(timeEdit->time(), repeatComboBox->currentText(), labelEdit->text(), soundComboBox->currentText());
+    emit alarmModified(timeEdit->time(), repeatComboBox->currentText(), labelEdit->text(), soundComboBox->currentText(),
+                       calendarComboBox->currentData().toString(), groupComboBox->currentText().trimmed(),
+                       enabledCheckBox->isChecked());
     close(); // Close the dialog
 }
 
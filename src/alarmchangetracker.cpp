@@ -0,0 +1,103 @@
+/**
+ * @file alarmchangetracker.cpp
+ * @brief Implementation file for the AlarmChangeTracker class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmchangetracker.h"
+#include <algorithm>
+
+/**
+ * @brief Connects to the store's change stream.
+ * @param store The store to track.
+ * @param parent The parent object.
+ */
+AlarmChangeTracker::AlarmChangeTracker(AlarmStore *store, QObject *parent)
+    : QObject(parent), alarmStore(store) {
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(0);
+    connect(&flushTimer, &QTimer::timeout, this, &AlarmChangeTracker::flush);
+    connect(alarmStore, &AlarmStore::changed, this, &AlarmChangeTracker::track);
+}
+
+/**
+ * @brief Holds back or releases the pending batch.
+ */
+void AlarmChangeTracker::setPaused(bool paused) {
+    this->paused = paused;
+    if (paused) {
+        flushTimer.stop();
+    } else if (dirty) {
+        flushTimer.start();
+    }
+}
+
+/**
+ * @brief Merges a store change into the net change of each alarm.
+ */
+void AlarmChangeTracker::track(quint64 fromVersion, quint64, const QVector<AlarmChange> &changes) {
+    if (!dirty) {
+        baseVersion = fromVersion;
+        dirty = true;
+        if (!paused) flushTimer.start();
+    }
+
+    for (const AlarmChange &change : changes) {
+        auto it = pending.find(change.id);
+        if (it == pending.end()) {
+            pending.insert(change.id, change.kind);
+        } else if (change.kind == AlarmChange::Removed) {
+            // Added and removed within one batch: the view never needs to know
+            if (*it == AlarmChange::Added) pending.erase(it);
+            else *it = AlarmChange::Removed;
+        }
+        // Added or Updated followed by Updated keeps the first kind; ids are never reused
+    }
+}
+
+/**
+ * @brief Forgets the pending changes.
+ */
+void AlarmChangeTracker::discard() {
+    flushTimer.stop();
+    pending.clear();
+    dirty = false;
+}
+
+/**
+ * @brief Emits the pending changes as one batch.
+ */
+void AlarmChangeTracker::flush() {
+    flushTimer.stop();
+    if (!dirty) return;
+
+    const AlarmSnapshot snapshot = alarmStore->snapshot();
+    QVector<AlarmChange> removed;
+    QVector<AlarmChange> updated;
+    QVector<AlarmChange> added;
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        const int index = snapshot.indexOf(it.key());
+        switch (it.value()) {
+        case AlarmChange::Removed:
+            removed.append({AlarmChange::Removed, it.key(), -1});
+            break;
+        case AlarmChange::Updated:
+            if (index != -1) updated.append({AlarmChange::Updated, it.key(), index});
+            break;
+        case AlarmChange::Added:
+            if (index != -1) added.append({AlarmChange::Added, it.key(), index});
+            break;
+        }
+    }
+    std::sort(added.begin(), added.end(), [](const AlarmChange &a, const AlarmChange &b) {
+        return a.index < b.index;
+    });
+
+    const quint64 fromVersion = baseVersion;
+    pending.clear();
+    dirty = false;
+
+    emit changesReady(fromVersion, snapshot.version(), removed + updated + added);
+}
@@ -0,0 +1,378 @@
+/**
+ * @file alarmhistory.cpp
+ * @brief Implementation file for the AlarmHistory class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmhistory.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Header at the start of the ring file.
+ */
+struct FileHeader {
+    char magic[8];          ///< "RISEHIST".
+    quint32 formatVersion;  ///< Layout version of the file.
+    quint32 recordSize;     ///< sizeof(HistoryRecord).
+    quint32 capacity;       ///< Number of record slots.
+    char reserved[44];      ///< Zero.
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader is part of the file format");
+
+const char fileMagic[8] = {'R', 'I', 'S', 'E', 'H', 'I', 'S', 'T'};
+const quint32 fileFormatVersion = 2; ///< 2: alarm time in seconds.
+const int queueReserve = 64; ///< Records that can be queued before the queue has to grow.
+
+/**
+ * @brief Appends the UTF-8 form of a text to a fixed buffer, stopping before a character that does not fit.
+ *
+ * Encodes straight from the QString's UTF-16 data, so recording an event
+ * needs no temporary QByteArray.
+ *
+ * @return The new length of the buffer's contents.
+ */
+int appendUtf8(const QString &text, char *buffer, int length, int capacity) {
+    const QChar *chars = text.constData();
+    const int count = text.size();
+    for (int i = 0; i < count; ++i) {
+        uint code = chars[i].unicode();
+        if (QChar::isHighSurrogate(code) && i + 1 < count && QChar::isLowSurrogate(chars[i + 1].unicode())) {
+            code = QChar::surrogateToUcs4(ushort(code), chars[++i].unicode());
+        } else if (QChar::isSurrogate(code)) {
+            code = QChar::ReplacementCharacter;
+        }
+
+        char encoded[4];
+        int size;
+        if (code < 0x80) {
+            encoded[0] = char(code);
+            size = 1;
+        } else if (code < 0x800) {
+            encoded[0] = char(0xC0 | (code >> 6));
+            encoded[1] = char(0x80 | (code & 0x3F));
+            size = 2;
+        } else if (code < 0x10000) {
+            encoded[0] = char(0xE0 | (code >> 12));
+            encoded[1] = char(0x80 | ((code >> 6) & 0x3F));
+            encoded[2] = char(0x80 | (code & 0x3F));
+            size = 3;
+        } else {
+            encoded[0] = char(0xF0 | (code >> 18));
+            encoded[1] = char(0x80 | ((code >> 12) & 0x3F));
+            encoded[2] = char(0x80 | ((code >> 6) & 0x3F));
+            encoded[3] = char(0x80 | (code & 0x3F));
+            size = 4;
+        }
+        if (length + size > capacity) break;
+        std::memcpy(buffer + length, encoded, size_t(size));
+        length += size;
+    }
+    return length;
+}
+
+/**
+ * @brief A record as the 64-bit words the seqlock reads and writes.
+ *
+ * The slots sit 64 bytes into a page-aligned mapping, so every word is
+ * aligned for a lock-free atomic access.
+ */
+using RecordWord = std::atomic<quint64>;
+const int recordWords = int(sizeof(HistoryRecord) / sizeof(quint64));
+const int sequenceWord = int(offsetof(HistoryRecord, sequence) / sizeof(quint64));
+
+static_assert(sizeof(RecordWord) == sizeof(quint64) && RecordWord::is_always_lock_free,
+              "Slots are accessed as lock-free 64-bit atomics");
+static_assert(sizeof(HistoryRecord) % sizeof(quint64) == 0 && offsetof(HistoryRecord, sequence) % sizeof(quint64) == 0,
+              "HistoryRecord is made of whole words");
+
+/**
+ * @brief Returns the words of a slot in the mapping.
+ */
+RecordWord *wordsOf(HistoryRecord *slot) {
+    return reinterpret_cast<RecordWord *>(slot);
+}
+
+/**
+ * @brief FNV-1a over a byte range, continuing from hash.
+ */
+quint32 fnv1a(const char *data, size_t size, quint32 hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ quint8(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+/**
+ * @brief Returns the name of the event kind.
+ */
+QString HistoryRecord::kindName() const {
+    switch (kind) {
+    case Fired: return "Fired";
+    case Snoozed: return "Snoozed";
+    case Dismissed: return "Dismissed";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Opens the ring file and starts the writer thread.
+ * @param path Location of the ring file.
+ * @param capacity Number of records kept.
+ * @param parent The parent object.
+ */
+AlarmHistory::AlarmHistory(const QString &path, int capacity, QObject *parent)
+    : QObject(parent), slotCount(qMax(capacity, 1)) {
+    if (!open(path)) {
+        qWarning() << "[HISTORY] Not recording alarm history:" << error;
+        return;
+    }
+
+    // The queue and the writer's batch trade buffers; both start large enough for a burst of fires
+    queue.reserve(queueReserve);
+    writer = QThread::create([this]() { writeLoop(); });
+    writer->setObjectName("AlarmHistory");
+    writer->start(QThread::LowPriority);
+}
+
+/**
+ * @brief Lets the writer drain the queue, then unmaps the file.
+ */
+AlarmHistory::~AlarmHistory() {
+    if (writer) {
+        {
+            QMutexLocker locker(&queueMutex);
+            stopping = true;
+        }
+        queueReady.wakeOne();
+        writer->wait();
+        delete writer;
+    }
+    if (records) {
+        file.unmap(reinterpret_cast<uchar *>(records) - sizeof(FileHeader));
+    }
+}
+
+/**
+ * @brief Maps the ring file and finds the newest intact record.
+ */
+bool AlarmHistory::open(const QString &path) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        error = file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = qint64(sizeof(FileHeader)) + qint64(slotCount) * qint64(sizeof(HistoryRecord));
+    FileHeader header = {};
+    const bool headerRead = file.read(reinterpret_cast<char *>(&header), sizeof header) == qint64(sizeof header);
+    const bool compatible = headerRead && file.size() == fileSize
+            && std::memcmp(header.magic, fileMagic, sizeof fileMagic) == 0
+            && header.formatVersion == fileFormatVersion
+            && header.recordSize == sizeof(HistoryRecord)
+            && header.capacity == quint32(slotCount);
+
+    if (!compatible) {
+        if (file.size() > 0) {
+            qWarning() << "[HISTORY] Starting a new history in" << path << "(size or format changed)";
+        }
+        header = {};
+        std::memcpy(header.magic, fileMagic, sizeof fileMagic);
+        header.formatVersion = fileFormatVersion;
+        header.recordSize = sizeof(HistoryRecord);
+        header.capacity = quint32(slotCount);
+        // Truncating first zeroes every slot, which marks it empty
+        if (!file.resize(0) || !file.resize(fileSize) || !file.seek(0)
+                || file.write(reinterpret_cast<const char *>(&header), sizeof header) != qint64(sizeof header)
+                || !file.flush()) {
+            error = file.errorString();
+            return false;
+        }
+    }
+
+    uchar *mapping = file.map(0, fileSize);
+    if (!mapping) {
+        error = file.errorString();
+        return false;
+    }
+    records = reinterpret_cast<HistoryRecord *>(mapping + sizeof(FileHeader));
+
+    quint64 newest = 0;
+    for (int i = 0; i < slotCount; ++i) {
+        if (isIntact(records[i])) newest = qMax(newest, records[i].sequence);
+    }
+    head.store(newest, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Packs the event and hands it to the writer thread.
+ */
+void AlarmHistory::record(HistoryRecord::Kind kind, const Alarm &alarm, const QDateTime &at) {
+    if (!records) return;
+
+    HistoryRecord entry = {};
+    entry.atMSecs = at.toMSecsSinceEpoch();
+    entry.alarmId = alarm.id;
+    entry.alarmSecond = quint32(alarm.time.msecsSinceStartOfDay() / 1000);
+    entry.kind = kind;
+
+    // Same text as displayLabel(), without building it: firing must not allocate
+    int length = appendUtf8(alarm.label.toString(), entry.label, 0, int(sizeof entry.label));
+    if (alarm.snoozed) length = appendUtf8(QStringLiteral(" (Snoozed)"), entry.label, length, int(sizeof entry.label));
+    entry.labelLength = quint8(length);
+
+    {
+        QMutexLocker locker(&queueMutex);
+        queue.append(entry);
+    }
+    queueReady.wakeOne();
+}
+
+/**
+ * @brief Writes queued records into the mapping, oldest first.
+ *
+ * head is only advanced after the whole record has been written, so
+ * readers never go past what is complete.
+ */
+void AlarmHistory::writeLoop() {
+    QVector<HistoryRecord> batch;
+    batch.reserve(queueReserve);
+    forever {
+        {
+            QMutexLocker locker(&queueMutex);
+            while (queue.isEmpty() && !stopping) {
+                queueReady.wait(&queueMutex);
+            }
+            if (queue.isEmpty()) return;
+            batch.swap(queue);
+        }
+
+        quint64 sequence = head.load(std::memory_order_relaxed);
+        for (HistoryRecord &entry : batch) {
+            entry.sequence = ++sequence;
+            entry.checksum = checksumOf(entry);
+            writeSlot(entry);
+            head.store(sequence, std::memory_order_release);
+        }
+        batch.clear();
+        emit recordsWritten(sequence);
+    }
+}
+
+/**
+ * @brief Clears the slot's sequence, writes the other words, then publishes the sequence.
+ *
+ * The release fence keeps the cleared sequence ahead of the body, so a
+ * reader that copied part of the new body sees the sequence change.
+ */
+void AlarmHistory::writeSlot(const HistoryRecord &record) {
+    quint64 source[recordWords];
+    std::memcpy(source, &record, sizeof record);
+    RecordWord *target = wordsOf(slot(record.sequence));
+
+    target[sequenceWord].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < recordWords; ++i) {
+        if (i != sequenceWord) target[i].store(source[i], std::memory_order_relaxed);
+    }
+    target[sequenceWord].store(record.sequence, std::memory_order_release);
+}
+
+/**
+ * @brief Copies the slot and keeps the copy only if its sequence did not change meanwhile.
+ *
+ * The acquire load orders the copy after the sequence was seen; the acquire
+ * fence orders the second look at the sequence after the copy.
+ */
+bool AlarmHistory::readSlot(quint64 sequence, HistoryRecord *record) const {
+    RecordWord *source = wordsOf(slot(sequence));
+    if (source[sequenceWord].load(std::memory_order_acquire) != sequence) return false;
+
+    quint64 copy[recordWords];
+    for (int i = 0; i < recordWords; ++i) {
+        copy[i] = source[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (source[sequenceWord].load(std::memory_order_relaxed) != sequence) return false;
+
+    std::memcpy(record, copy, sizeof copy);
+    return true;
+}
+
+/**
+ * @brief Copies the record if its slot still holds the given sequence.
+ *
+ * The checksum still matters for records written before a crash.
+ */
+bool AlarmHistory::recordAt(quint64 sequence, HistoryRecord *record) const {
+    if (!records || sequence == 0 || sequence > lastSequence()) return false;
+    return readSlot(sequence, record) && isIntact(*record);
+}
+
+/**
+ * @brief Walks back from the newest record until an overwritten slot is reached.
+ */
+int AlarmHistory::visit(const std::function<bool(const HistoryRecord &)> &visitor) const {
+    const quint64 newest = lastSequence();
+    const quint64 oldest = newest > quint64(slotCount) ? newest - quint64(slotCount) + 1 : 1;
+    int visited = 0;
+    HistoryRecord entry;
+    for (quint64 sequence = newest; sequence >= oldest && sequence > 0; --sequence) {
+        if (!recordAt(sequence, &entry)) break; // The writer has wrapped around to here
+        ++visited;
+        if (!visitor(entry)) break;
+    }
+    return visited;
+}
+
+/**
+ * @brief Collects the sequences of the records matching the filter.
+ */
+QVector<quint64> AlarmHistory::find(const HistoryFilter &filter, int limit) const {
+    QVector<quint64> found;
+    visit([&](const HistoryRecord &entry) {
+        // Not a stopping condition: the clock may have been set back between records
+        if (entry.atMSecs < filter.fromMSecs || entry.atMSecs >= filter.toMSecs) return true;
+        if (!(filter.kinds & (1 << entry.kind))) return true;
+        if (filter.alarmId != 0 && entry.alarmId != filter.alarmId) return true;
+        if (!filter.label.isEmpty()
+                && !QByteArray::fromRawData(entry.label, entry.labelLength).contains(filter.label)) {
+            return true;
+        }
+        found.append(entry.sequence);
+        return limit < 0 || found.size() < limit;
+    });
+    return found;
+}
+
+/**
+ * @brief Checks the checksum of a non-empty slot.
+ */
+bool AlarmHistory::isIntact(const HistoryRecord &record) {
+    return record.sequence != 0 && record.labelLength <= sizeof record.label && record.checksum == checksumOf(record);
+}
+
+/**
+ * @brief Hashes every byte of the record except the checksum itself.
+ */
+quint32 AlarmHistory::checksumOf(const HistoryRecord &record) {
+    const char *bytes = reinterpret_cast<const char *>(&record);
+    const size_t checksumOffset = offsetof(HistoryRecord, checksum);
+    const quint32 hash = fnv1a(bytes, checksumOffset, 2166136261u);
+    return fnv1a(bytes + checksumOffset + sizeof record.checksum,
+                 sizeof record - checksumOffset - sizeof record.checksum, hash);
+}
@@ -0,0 +1,371 @@
+/**
+ * @file alarmprofiles.cpp
+ * @brief Implementation file for the AlarmProfiles class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmprofiles.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+const char fileMagic[8] = {'R', 'I', 'S', 'E', 'P', 'R', 'O', 'F'};
+const quint32 fileFormatVersion = 1;
+const QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+const char fileSuffix[] = ".alarms";
+const int saveDelayMs = 1000; ///< Quiet time after a change before the file is written.
+
+/**
+ * @brief Returns true if two calendars exclude the same dates.
+ */
+bool sameDates(const HolidayCalendar &a, const HolidayCalendar &b) {
+    const QVector<HolidayCalendar::Interval> &left = a.intervals();
+    const QVector<HolidayCalendar::Interval> &right = b.intervals();
+    if (left.size() != right.size()) return false;
+    for (int i = 0; i < left.size(); ++i) {
+        if (left[i].first != right[i].first || left[i].last != right[i].last) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Creates the shared calendars and loads the empty "Default" profile.
+ * @param clock The clock of the schedulers.
+ * @param parent The parent object.
+ */
+AlarmProfiles::AlarmProfiles(ClockSource *clock, QObject *parent)
+    : QObject(parent), clockSource(clock ? clock : ClockSource::system()),
+      sharedCalendars(new HolidayCalendars(this)), activeProfile("Default") {
+    connect(sharedCalendars, &HolidayCalendars::changed, this, [this]() {
+        for (AlarmScheduler *scheduler : qAsConst(loadedSchedulers)) {
+            copyCalendars(scheduler);
+        }
+    });
+    shards.insert(activeProfile, Shard());
+    load(activeProfile);
+}
+
+/**
+ * @brief Saves the loaded shards, so their files hold their latest next deadline.
+ */
+AlarmProfiles::~AlarmProfiles() {
+    for (const QString &name : shards.keys()) {
+        save(name);
+    }
+}
+
+/**
+ * @brief Lists the profile files, reading only their headers.
+ *
+ * Every shard moves to the new folder. A loaded shard with a file there
+ * takes the file's alarms in place of the ones it held; an unloaded one
+ * without a file forgets the deadline saved in its old file.
+ */
+bool AlarmProfiles::setDirectory(const QString &path) {
+    if (path.isEmpty() || !QDir().mkpath(path)) {
+        qWarning() << "[PROFILES] Cannot use profile folder" << path;
+        return false;
+    }
+    profileDirectory = QFileInfo(path).absoluteFilePath();
+    const QDir dir(profileDirectory);
+    for (auto it = shards.begin(); it != shards.end(); ++it) {
+        it->path = dir.filePath(it.key() + fileSuffix);
+        if (!it->scheduler) it->savedNextMs = -1;
+    }
+
+    const QFileInfoList entries = dir.entryInfoList({QString("*") + fileSuffix}, QDir::Files | QDir::Readable);
+    for (const QFileInfo &entry : entries) {
+        const QString name = entry.completeBaseName();
+        if (!isValidName(name)) continue;
+
+        const bool known = shards.contains(name);
+        Shard &shard = shards[name];
+        shard.path = entry.absoluteFilePath();
+        if (shard.scheduler) {
+            readFile(shard.path, shard.scheduler);
+        } else if (!readHeader(shard.path, &shard.savedNextMs)) {
+            // Without a header the next deadline is unknown, so the shard cannot wait
+            load(name);
+        }
+        if (!known) emit profileAdded(name);
+    }
+
+    updateEarliestUnloaded();
+    qDebug() << "[PROFILES]" << shards.size() << "profiles in" << profileDirectory << "," << loadedSchedulers.size() << "loaded";
+    return true;
+}
+
+/**
+ * @brief Creates the profile if needed, loads it and makes it the active one.
+ */
+bool AlarmProfiles::setActive(const QString &name) {
+    if (!isValidName(name)) return false;
+    if (name == activeProfile) return true;
+
+    if (!shards.contains(name)) {
+        Shard shard;
+        if (!profileDirectory.isEmpty()) shard.path = QDir(profileDirectory).filePath(name + fileSuffix);
+        shards.insert(name, shard);
+        emit profileAdded(name);
+    }
+    load(name);
+    activeProfile = name;
+    qDebug() << "[PROFILES] Active profile:" << name;
+    emit activeChanged(name);
+    return true;
+}
+
+/**
+ * @brief Finds the loaded shard of a scheduler.
+ */
+QString AlarmProfiles::nameOf(const AlarmScheduler *scheduler) const {
+    for (auto it = shards.cbegin(); it != shards.cend(); ++it) {
+        if (it->scheduler == scheduler) return it.key();
+    }
+    return QString();
+}
+
+/**
+ * @brief Merges the next deadlines of all shards.
+ */
+QDateTime AlarmProfiles::nextDeadline(QString *profile) const {
+    QDateTime earliest;
+    QString earliestProfile;
+    for (auto it = shards.cbegin(); it != shards.cend(); ++it) {
+        const QDateTime next = nextDeadline(it.key());
+        if (next.isValid() && (!earliest.isValid() || next < earliest)) {
+            earliest = next;
+            earliestProfile = it.key();
+        }
+    }
+    if (profile) *profile = earliestProfile;
+    return earliest;
+}
+
+/**
+ * @brief Asks a loaded shard's index, or uses the deadline saved in the file.
+ */
+QDateTime AlarmProfiles::nextDeadline(const QString &name) const {
+    const Shard shard = shards.value(name);
+    if (shard.scheduler) return shard.scheduler->nextFires()->nextDeadline();
+    return shard.savedNextMs < 0 ? QDateTime() : QDateTime::fromMSecsSinceEpoch(shard.savedNextMs);
+}
+
+/**
+ * @brief Loads the shards that will ring soon; usually a single comparison.
+ */
+int AlarmProfiles::loadDue(const QDateTime &now) {
+    const qint64 limit = now.toMSecsSinceEpoch() + loadAheadMs;
+    if (earliestUnloadedMs < 0 || earliestUnloadedMs > limit) return 0;
+
+    QStringList due;
+    for (auto it = shards.cbegin(); it != shards.cend(); ++it) {
+        if (!it->scheduler && it->savedNextMs >= 0 && it->savedNextMs <= limit) due.append(it.key());
+    }
+    for (const QString &name : due) {
+        load(name);
+    }
+    return due.size();
+}
+
+/**
+ * @brief Hands the history to every loaded scheduler and to the ones loaded later.
+ */
+void AlarmProfiles::setHistory(AlarmHistory *history) {
+    alarmHistory = history;
+    for (AlarmScheduler *scheduler : qAsConst(loadedSchedulers)) {
+        scheduler->setHistory(history);
+    }
+}
+
+/**
+ * @brief Applies the limit to every loaded scheduler and to the ones loaded later.
+ */
+void AlarmProfiles::setCapacity(int maxAlarms) {
+    capacity = maxAlarms;
+    for (AlarmScheduler *scheduler : qAsConst(loadedSchedulers)) {
+        scheduler->setCapacity(maxAlarms);
+    }
+}
+
+/**
+ * @brief Profile names double as file names, so they are kept to a safe set of characters.
+ */
+bool AlarmProfiles::isValidName(const QString &name) {
+    static const QRegularExpression pattern("^[\\w -]{1,64}$", QRegularExpression::UseUnicodePropertiesOption);
+    return name.trimmed() == name && pattern.match(name).hasMatch();
+}
+
+/**
+ * @brief Builds the shard's scheduler and service and fills the store from the file.
+ *
+ * The file is read before the save timer is connected, so loading does
+ * not write it straight back.
+ */
+void AlarmProfiles::load(const QString &name) {
+    Shard &shard = shards[name];
+    if (shard.scheduler) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    shard.scheduler = new AlarmScheduler(clockSource, this);
+    shard.scheduler->setCapacity(capacity);
+    shard.scheduler->setHistory(alarmHistory);
+    copyCalendars(shard.scheduler);
+    if (!shard.path.isEmpty()) readFile(shard.path, shard.scheduler);
+    shard.service = new AlarmService(shard.scheduler, this);
+
+    shard.saveTimer = new QTimer(this);
+    shard.saveTimer->setSingleShot(true);
+    shard.saveTimer->setInterval(saveDelayMs);
+    connect(shard.saveTimer, &QTimer::timeout, this, [this, name]() { save(name); });
+    connect(shard.scheduler->store(), &AlarmStore::changed, shard.saveTimer, QOverload<>::of(&QTimer::start));
+
+    loadedSchedulers.append(shard.scheduler);
+    updateEarliestUnloaded();
+    qDebug() << "[PROFILES] Loaded" << name << "(" << shard.scheduler->alarms().size() << "alarms in"
+             << timer.elapsed() << "ms )";
+    emit shardLoaded(name);
+}
+
+/**
+ * @brief Reads a store file in one pass and replaces the store's alarms with it in one change.
+ *
+ * A file that cannot be read is renamed to "<file>.bad" rather than being
+ * overwritten by the next save.
+ */
+bool AlarmProfiles::readFile(const QString &path, AlarmScheduler *scheduler) {
+    QFile file(path);
+    if (!file.exists()) return true;
+
+    auto fail = [&](const QString &reason) {
+        qWarning() << "[PROFILES] Cannot read" << path << ":" << reason << "- keeping it as" << path + ".bad";
+        file.close();
+        QFile::remove(path + ".bad");
+        QFile::rename(path, path + ".bad");
+        return false;
+    };
+    if (!file.open(QIODevice::ReadOnly)) return fail(file.errorString());
+
+    QDataStream in(&file);
+    in.setVersion(streamVersion);
+    char magic[sizeof fileMagic];
+    quint32 version = 0;
+    qint64 nextMs = -1;
+    qint32 count = 0;
+    if (in.readRawData(magic, int(sizeof magic)) != int(sizeof magic) || std::memcmp(magic, fileMagic, sizeof magic) != 0) {
+        return fail("not a profile file");
+    }
+    in >> version >> nextMs >> count;
+    if (in.status() != QDataStream::Ok || version != fileFormatVersion || count < 0) return fail("unknown format");
+
+    QVector<Alarm> alarms;
+    alarms.reserve(qMin(count, 1 << 20));
+    for (qint32 i = 0; i < count; ++i) {
+        Alarm alarm;
+        QString label;
+        QString group;
+        in >> alarm.time >> alarm.originalTime >> alarm.repeat >> label >> alarm.sound >> alarm.calendar >> group
+           >> alarm.enabled >> alarm.snoozed;
+        if (in.status() != QDataStream::Ok) return fail("truncated");
+        alarm.label = label;
+        alarm.group = group;
+        alarms.append(alarm);
+    }
+    QSet<quint64> held;
+    for (const Alarm &alarm : scheduler->alarms()) {
+        held.insert(alarm.id);
+    }
+    scheduler->store()->apply(alarms, {}, held);
+    return true;
+}
+
+/**
+ * @brief Writes the shard's alarms and its next deadline; the old file stays until the new one is complete.
+ */
+void AlarmProfiles::save(const QString &name) {
+    Shard &shard = shards[name];
+    if (!shard.scheduler || shard.path.isEmpty()) return;
+    shard.saveTimer->stop();
+
+    // The header is what decides when the shard is loaded next time, so it must be current
+    NextFireIndex *index = shard.scheduler->nextFires();
+    index->sync();
+    const QDateTime next = index->nextDeadline();
+    const qint64 nextMs = next.isValid() ? next.toMSecsSinceEpoch() : -1;
+
+    QSaveFile file(shard.path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[PROFILES] Cannot write" << shard.path << ":" << file.errorString();
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+    const QVector<Alarm> &alarms = shard.scheduler->alarms();
+    out.writeRawData(fileMagic, int(sizeof fileMagic));
+    out << fileFormatVersion << nextMs << qint32(alarms.size());
+    for (const Alarm &alarm : alarms) {
+        out << alarm.time << alarm.originalTime << alarm.repeat << alarm.label.toString() << alarm.sound
+            << alarm.calendar << alarm.group.toString() << alarm.enabled << alarm.snoozed;
+    }
+    if (!file.commit()) {
+        qWarning() << "[PROFILES] Cannot write" << shard.path << ":" << file.errorString();
+        return;
+    }
+    shard.savedNextMs = nextMs;
+}
+
+/**
+ * @brief Reads the magic, the version and the saved deadline; the alarms are not touched.
+ */
+bool AlarmProfiles::readHeader(const QString &path, qint64 *nextMs) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(streamVersion);
+    char magic[sizeof fileMagic];
+    quint32 version = 0;
+    if (in.readRawData(magic, int(sizeof magic)) != int(sizeof magic) || std::memcmp(magic, fileMagic, sizeof magic) != 0) {
+        return false;
+    }
+    in >> version >> *nextMs;
+    return in.status() == QDataStream::Ok && version == fileFormatVersion;
+}
+
+/**
+ * @brief Removes, adds and replaces calendars; unchanged ones are left alone so the index is not recomputed for them.
+ */
+void AlarmProfiles::copyCalendars(AlarmScheduler *scheduler) const {
+    HolidayCalendars *target = scheduler->calendars();
+    for (const QString &name : target->names()) {
+        if (!sharedCalendars->calendar(name)) target->removeCalendar(name);
+    }
+    for (const QString &name : sharedCalendars->names()) {
+        const HolidayCalendar *source = sharedCalendars->calendar(name);
+        const HolidayCalendar *current = target->calendar(name);
+        if (!current || !sameDates(*current, *source)) target->setCalendar(name, *source);
+    }
+}
+
+/**
+ * @brief Finds the earliest saved deadline among the shards that are not loaded.
+ */
+void AlarmProfiles::updateEarliestUnloaded() {
+    earliestUnloadedMs = -1;
+    for (auto it = shards.cbegin(); it != shards.cend(); ++it) {
+        if (it->scheduler || it->savedNextMs < 0) continue;
+        if (earliestUnloadedMs < 0 || it->savedNextMs < earliestUnloadedMs) earliestUnloadedMs = it->savedNextMs;
+    }
+}
@@ -0,0 +1,442 @@
+/**
+ * @file alarmscheduler.cpp
+ * @brief Implementation file for the AlarmScheduler class.
+ *
+ * This file contains the rules that decide when an alarm rings and what
+ * happens when it is snoozed or dismissed. These rules used to live directly
+ * inside MainWindow::checkAlarms.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmscheduler.h"
+#include <QMap>
+#include <QDebug>
+
+namespace {
+
+/**
+ * @brief Maps repeat settings to the day of the week they ring on.
+ */
+const QMap<QString, Qt::DayOfWeek> &repeatMap() {
+    static const QMap<QString, Qt::DayOfWeek> map = {
+        {"Every Sunday", Qt::Sunday}, {"Every Monday", Qt::Monday},
+        {"Every Tuesday", Qt::Tuesday}, {"Every Wednesday", Qt::Wednesday},
+        {"Every Thursday", Qt::Thursday}, {"Every Friday", Qt::Friday},
+        {"Every Saturday", Qt::Saturday}
+    };
+    return map;
+}
+
+/**
+ * @brief Julian day of Monday 1970-01-05, the start of wheel minute 0.
+ */
+const qint64 wheelEpochJulianDay = 2440592;
+
+/**
+ * @brief Minutes in a day.
+ */
+const qint64 minutesPerDay = 24 * 60;
+
+/**
+ * @brief Largest clock jump (in minutes) after which missed alarms still ring late.
+ *
+ * Bigger jumps, in either direction, resynchronise the wheel instead, so a
+ * clock set back a day does not go silent and a clock set forward a week
+ * does not fire a week of alarms at once.
+ */
+const qint64 maxCatchUpMinutes = 90;
+
+/**
+ * @brief Lateness (in ms) from which an alarm counts as caught up rather than jittered.
+ *
+ * A check that comes a minute or more late means the clock jumped or the
+ * device was suspended, which says nothing about timer accuracy.
+ */
+const qint64 maxJitterMs = 60 * 1000;
+
+/**
+ * @brief Returns the minute of the day of a time.
+ */
+int minuteOfDay(const QTime &time) {
+    return time.hour() * 60 + time.minute();
+}
+
+} // namespace
+
+/**
+ * @brief Constructs the scheduler.
+ *
+ * The wheel starts one minute in the past so that alarms set for the
+ * current minute still ring on the first check.
+ *
+ * @param clock The clock to read the time from (nullptr means the system clock).
+ * @param parent The parent object.
+ */
+AlarmScheduler::AlarmScheduler(ClockSource *clock, QObject *parent)
+    : QObject(parent), clockSource(clock ? clock : ClockSource::system()),
+      alarmStore(new AlarmStore(this)),
+      holidayCalendars(new HolidayCalendars(this)),
+      occurrenceCache(new OccurrenceCache(alarmStore, clockSource, this)),
+      nextFireIndex(new NextFireIndex(alarmStore, holidayCalendars, clockSource, this)),
+      wheel(wheelMinute(clockSource->currentDateTime()) - 1) {
+    const QDateTime now = clockSource->currentDateTime();
+    lastCheckedSecond = wheelMinute(now) * 60 + now.time().second();
+    connect(alarmStore, &AlarmStore::changed, this, &AlarmScheduler::onStoreChanged);
+    occurrenceCache->setCalendars(holidayCalendars);
+}
+
+/**
+ * @brief Converts a local date and time to a timing wheel minute.
+ * @return Local minutes since Monday 1970-01-05 00:00.
+ */
+qint64 AlarmScheduler::wheelMinute(const QDateTime &local) {
+    return (local.date().toJulianDay() - wheelEpochJulianDay) * minutesPerDay + minuteOfDay(local.time());
+}
+
+/**
+ * @brief Converts a timing wheel minute to a local date and time.
+ */
+QDateTime AlarmScheduler::fromWheelMinute(qint64 minute) {
+    const qint64 day = minute >= 0 ? minute / minutesPerDay : -((-minute + minutesPerDay - 1) / minutesPerDay);
+    const int minuteInDay = int(minute - day * minutesPerDay);
+    return QDateTime(QDate::fromJulianDay(wheelEpochJulianDay + day), QTime(minuteInDay / 60, minuteInDay % 60));
+}
+
+/**
+ * @brief Looks up the weekday of a weekly repeat setting.
+ */
+int AlarmScheduler::weeklyDay(const QString &repeat) {
+    return repeatMap().value(repeat, Qt::DayOfWeek(0));
+}
+
+/**
+ * @brief Adds a new alarm to the store.
+ * @return False if the scheduler already holds maxAlarms() alarms.
+ */
+bool AlarmScheduler::addAlarm(QTime time, const QString &repeat, const QString &label, const QString &sound,
+                              const QString &calendar, const QString &group) {
+    if (capacity >= 0 && alarms().size() >= capacity) {
+        qWarning() << "[SCHEDULER] Alarm limit reached, not adding" << label;
+        return false;
+    }
+
+    Alarm alarm;
+    alarm.time = time;
+    alarm.originalTime = time;
+    alarm.repeat = repeat;
+    alarm.label = label;
+    alarm.sound = sound;
+    alarm.calendar = calendar;
+    alarm.group = group;
+    alarmStore->add(alarm);
+    return true;
+}
+
+/**
+ * @brief Checks whether an alarm must stay silent on the given day.
+ *
+ * An alarm is silent if its holiday calendar excludes the day, or if it was
+ * dismissed earlier that day. Snoozed copies are never suppressed.
+ */
+bool AlarmScheduler::isSuppressed(const Alarm &alarm, const QDate &date) const {
+    if (alarm.snoozed) return false;
+    if (holidayCalendars->excludes(alarm.calendar, date)) return true;
+    return date == dismissedDate && dismissedToday.contains(alarm.label);
+}
+
+/**
+ * @brief Advances the timing wheel to the given local time and collects what fired.
+ *
+ * Only the alarms whose wheel bucket is passed are looked at, so the cost
+ * per call does not depend on how many alarms are stored. Weekly alarms sit
+ * in their minute-of-week bucket; other alarms are one-shot entries at their
+ * next occurrence and are re-armed for the following day when they fire.
+ * A passed bucket's alarms are armed for their second and reported once
+ * that second is reached.
+ *
+ * The fired and due ids are collected in member vectors whose capacity is
+ * kept between calls, so once they have grown to the largest batch seen a
+ * call makes no heap allocation (see AllocationProbe).
+ */
+QVector<quint64> AlarmScheduler::dueAlarms(const QDateTime &now) {
+    const qint64 minute = wheelMinute(now);
+    const qint64 second = minute * 60 + now.time().second();
+    const qint64 nowMs = second * 1000 + now.time().msec();
+
+    const qint64 jump = minute - wheel.currentMinute();
+    if (jump < -maxCatchUpMinutes || jump > maxCatchUpMinutes) {
+        qDebug() << "[SCHEDULER] Clock jumped by" << jump << "minutes, resynchronising";
+        rebuildWheel(minute - 1);
+        nextFireIndex->recompute();
+    }
+
+    // Reading the system zone touches the file system, so only do it when an hour starts
+    if (jump != 0 && minute / 60 != wheel.currentMinute() / 60) {
+        const QTimeZone systemZone = QTimeZone::systemTimeZone();
+        if (systemZone != nextFireIndex->timeZone()) {
+            qDebug() << "[SCHEDULER] Time zone changed to" << systemZone.id();
+            nextFireIndex->setTimeZone(systemZone);
+        }
+    }
+
+    wheel.advanceTo(minute, [&](std::uint64_t id, TimingWheel::Handle) {
+        const qint64 bucket = wheel.currentMinute();
+        const Alarm *alarm = alarmStore->find(id);
+        arm(bucket * 60 + (alarm ? alarm->time.second() : 0), id);
+        if (alarm && !repeatMap().contains(alarm->repeat)) {
+            // One-shot entries are gone once fired; re-arm them for the next day
+            wheelHandles.insert(id, wheel.scheduleAt(bucket + minutesPerDay, id));
+        }
+    });
+
+    // Only alarms that came due since the previous call were checked for in time
+    const qint64 previousSecond = lastCheckedSecond;
+    lastCheckedSecond = second;
+
+    int reached = 0;
+    while (reached < armed.size() && armed[reached].second <= second) ++reached;
+    if (reached == 0) return {};
+
+    // clear() keeps the capacity unless the caller still holds the previous result
+    firedIds.clear();
+    for (int i = 0; i < reached; ++i) firedIds.append(armed[i].id);
+    nextFireIndex->markFired(firedIds);
+
+    dueIds.clear();
+    for (int i = 0; i < reached; ++i) {
+        const ArmedAlarm &entry = armed[i];
+        const Alarm *alarm = alarmStore->find(entry.id);
+        if (alarm && !isSuppressed(*alarm, now.date()) && !dueIds.contains(entry.id)) {
+            dueIds.append(entry.id);
+            if (alarmHistory) alarmHistory->record(HistoryRecord::Fired, *alarm, now);
+            const qint64 lateMs = nowMs - entry.second * 1000;
+            if (entry.second > previousSecond && lateMs < maxJitterMs) {
+                jitter.lastMs = lateMs;
+                jitter.worstMs = qMax(jitter.worstMs, jitter.lastMs);
+                jitter.totalMs += jitter.lastMs;
+                ++jitter.count;
+            }
+        }
+    }
+    armed.remove(0, reached);
+    return dueIds;
+}
+
+/**
+ * @brief Puts an alarm into the timing wheel.
+ *
+ * A disabled alarm gets no wheel entry at all, so switching a group off
+ * costs one cancel per alarm and nothing on later checks.
+ */
+void AlarmScheduler::scheduleAlarm(const Alarm &alarm) {
+    if (!alarm.enabled) return;
+    const qint64 current = wheel.currentMinute();
+    auto repeatDay = repeatMap().constFind(alarm.repeat);
+
+    TimingWheel::Handle handle;
+    qint64 next;
+    if (repeatDay != repeatMap().constEnd()) {
+        const int minuteOfWeek = int((*repeatDay - 1) * minutesPerDay) + minuteOfDay(alarm.time);
+        handle = wheel.scheduleWeekly(minuteOfWeek, alarm.id);
+        const qint64 weekStart = current - ((current % TimingWheel::MinutesPerWeek) + TimingWheel::MinutesPerWeek) % TimingWheel::MinutesPerWeek;
+        next = weekStart + minuteOfWeek;
+    } else {
+        const qint64 dayStart = current - ((current % minutesPerDay) + minutesPerDay) % minutesPerDay;
+        next = dayStart + minuteOfDay(alarm.time);
+        if (next < current) next += minutesPerDay;
+        handle = wheel.scheduleAt(next == current ? next + minutesPerDay : next, alarm.id);
+    }
+    wheelHandles.insert(alarm.id, handle);
+
+    // The wheel has already passed the current minute; arm it directly. Like the
+    // old per-minute check, an alarm whose second has passed rings right away.
+    if (next == current) {
+        arm(current * 60 + alarm.time.second(), alarm.id);
+    }
+}
+
+/**
+ * @brief Inserts after the entries of the same or an earlier second.
+ */
+void AlarmScheduler::arm(qint64 second, quint64 id) {
+    int index = armed.size();
+    while (index > 0 && armed[index - 1].second > second) --index;
+    armed.insert(index, {second, id});
+}
+
+/**
+ * @brief Removes an alarm from the timing wheel.
+ */
+void AlarmScheduler::unscheduleAlarm(quint64 id) {
+    wheel.cancel(wheelHandles.take(id));
+    for (int i = armed.size() - 1; i >= 0; --i) {
+        if (armed[i].id == id) armed.remove(i);
+    }
+}
+
+/**
+ * @brief Empties the wheel and re-adds every stored alarm at the given minute.
+ */
+void AlarmScheduler::rebuildWheel(qint64 minute) {
+    wheel.clear(minute);
+    wheelHandles.clear();
+    armed.clear();
+    for (const Alarm &alarm : alarms()) {
+        scheduleAlarm(alarm);
+    }
+}
+
+/**
+ * @brief Keeps the timing wheel in step with the alarm store.
+ */
+void AlarmScheduler::onStoreChanged(quint64, quint64, const QVector<AlarmChange> &changes) {
+    for (const AlarmChange &change : changes) {
+        switch (change.kind) {
+        case AlarmChange::Removed:
+            unscheduleAlarm(change.id);
+            break;
+        case AlarmChange::Updated:
+            unscheduleAlarm(change.id);
+            scheduleAlarm(alarms()[change.index]);
+            break;
+        case AlarmChange::Added:
+            scheduleAlarm(alarms()[change.index]);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Snoozes a single alarm for the given number of minutes.
+ */
+void AlarmScheduler::snooze(quint64 id, int minutes) {
+    snoozeAll({id}, minutes);
+}
+
+/**
+ * @brief Snoozes a batch of alarms for the given number of minutes.
+ *
+ * Old snoozed copies of the same alarms are removed so that snoozing twice
+ * never leaves two pending copies behind. All removals and new snoozed
+ * copies are applied to the store as one change.
+ */
+void AlarmScheduler::snoozeAll(const QVector<quint64> &ids, int minutes) {
+    const QDateTime now = clockSource->currentDateTime();
+    // Snoozed copies ring on a whole second, like every other alarm
+    const QTime snoozedTime = QTime::fromMSecsSinceStartOfDay(now.time().msecsSinceStartOfDay() / 1000 * 1000)
+            .addSecs(minutes * 60);
+
+    QSet<quint64> targets;
+    QSet<quint64> removed;
+    QSet<Label> repeatingLabels; // Labels whose old snoozed copies are replaced
+    QSet<Label> snoozedLabels;
+    QVector<Alarm> snoozedAlarms;
+    for (quint64 id : ids) {
+        const Alarm *found = alarmStore->find(id);
+        if (!found || targets.contains(id)) continue;
+        targets.insert(id);
+
+        const Alarm original = *found;
+        const Label &label = original.label;
+        if (alarmHistory) alarmHistory->record(HistoryRecord::Snoozed, original, now);
+        if (original.repeat == "Never" || original.snoozed) {
+            // One-time alarms and snoozed copies are replaced by their new snoozed copy
+            if (original.repeat == "Never") {
+                qDebug() << "[SNOOZE] Removing one-time alarm after snooze:" << label;
+            }
+            removed.insert(id);
+        }
+        if (original.repeat != "Never") {
+            markDismissed(original.label, now.date());
+            repeatingLabels.insert(label);
+        }
+
+        if (snoozedLabels.contains(label)) continue;
+        snoozedLabels.insert(label);
+
+        Alarm snoozedAlarm = original;
+        // The copy keeps the label's handle; only the display adds "(Snoozed)"
+        snoozedAlarm.time = snoozedTime;
+        snoozedAlarm.snoozed = true;
+        snoozedAlarms.append(snoozedAlarm);
+
+        qDebug() << "[SNOOZE] Added new snoozed alarm for" << label << "at" << snoozedTime.toString("HH:mm:ss");
+        if (original.repeat.startsWith("Every ")) {
+            QString repeatDay = original.repeat;
+            repeatDay.remove("Every ");
+            qDebug() << "[INFO] Original alarm will repeat every"
+                     << repeatDay << "at"
+                     << original.originalTime.toString("HH:mm:ss");
+        }
+    }
+    if (targets.isEmpty()) return;
+
+    // Remove all existing snoozed versions of the repeating alarms
+    if (!repeatingLabels.isEmpty()) {
+        for (const Alarm &alarm : alarms()) {
+            if (alarm.snoozed && !removed.contains(alarm.id) && repeatingLabels.contains(alarm.label)) {
+                qDebug() << "[SNOOZE] Removing old snoozed alarm:" << alarm.displayLabel();
+                removed.insert(alarm.id);
+            }
+        }
+    }
+
+    alarmStore->apply(snoozedAlarms, {}, removed);
+}
+
+/**
+ * @brief Dismisses a single alarm.
+ * @param id The id of the alarm.
+ * @return True if the alarm was removed, false if it was only suppressed for today.
+ */
+bool AlarmScheduler::dismiss(quint64 id) {
+    return dismissAll({id}) > 0;
+}
+
+/**
+ * @brief Dismisses a batch of alarms.
+ * @param ids The ids of the alarms.
+ * @return The number of alarms removed from the store.
+ */
+int AlarmScheduler::dismissAll(const QVector<quint64> &ids) {
+    const QDateTime now = clockSource->currentDateTime();
+    const QDate today = now.date();
+
+    QSet<quint64> removed;
+    for (quint64 id : ids) {
+        const Alarm *alarm = alarmStore->find(id);
+        if (!alarm) continue;
+
+        qDebug() << "[DISMISS] Alarm dismissed:" << alarm->label;
+        if (alarmHistory) alarmHistory->record(HistoryRecord::Dismissed, *alarm, now);
+
+        // Handle non-repeating and repeating alarms only on dismiss
+        if (alarm->repeat == "Never" || alarm->snoozed) {
+            removed.insert(id);
+            continue;
+        }
+
+        markDismissed(alarm->label, today);
+        if (repeatMap().contains(alarm->repeat)) {
+            QDateTime nextAlarmDateTime(today.addDays(7), alarm->time);
+            qDebug() << "[DEBUG] Dismissed repeat alarm:" << alarm->label
+                     << "— next scheduled for" << nextAlarmDateTime.toString();
+        }
+    }
+
+    alarmStore->apply({}, {}, removed);
+    return removed.size();
+}
+
+/**
+ * @brief Records a dismissal, forgetting dismissals from earlier days.
+ */
+void AlarmScheduler::markDismissed(const Label &label, const QDate &date) {
+    if (date != dismissedDate) {
+        dismissedToday.clear();
+        dismissedDate = date;
+    }
+    dismissedToday.insert(label);
+}
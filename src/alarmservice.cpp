@@ -0,0 +1,233 @@
+/**
+ * @file alarmservice.cpp
+ * @brief Implementation file for the AlarmService class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmservice.h"
+#include <QThread>
+#include <functional>
+#include <limits>
+#include <thread>
+
+/**
+ * @brief Looks an alarm up by id.
+ */
+const Alarm *AlarmServiceSnapshot::find(quint64 id) const {
+    const int index = store.indexOf(id);
+    return index == -1 ? nullptr : &store.alarms()[index];
+}
+
+/**
+ * @brief Looks up the next fire instant of an alarm.
+ */
+QDateTime AlarmServiceSnapshot::nextFire(quint64 id) const {
+    const qint64 at = fires ? fires->fireAtOf(id) : NextFireTable::NoFire;
+    return at == NextFireTable::NoFire ? QDateTime() : QDateTime::fromMSecsSinceEpoch(at, zone);
+}
+
+/**
+ * @brief Returns the earliest next fire instant.
+ */
+QDateTime AlarmServiceSnapshot::nextAlarmTime() const {
+    const qint64 at = fires ? fires->earliest : NextFireTable::NoFire;
+    return at == NextFireTable::NoFire ? QDateTime() : QDateTime::fromMSecsSinceEpoch(at, zone);
+}
+
+/**
+ * @brief Publishes the scheduler's alarms and follows its changes.
+ * @param scheduler The scheduler whose alarms are served.
+ * @param parent The parent object.
+ */
+AlarmService::AlarmService(AlarmScheduler *scheduler, QObject *parent)
+    : QObject(parent), alarmScheduler(scheduler) {
+    reclaimTimer.setSingleShot(true);
+    reclaimTimer.setInterval(100);
+    connect(&reclaimTimer, &QTimer::timeout, this, &AlarmService::reclaim);
+    connect(alarmScheduler->store(), &AlarmStore::changed, this, &AlarmService::publish);
+    connect(alarmScheduler->nextFires(), &NextFireIndex::tableChanged, this, &AlarmService::publish);
+    publishedVersion.store(alarmScheduler->store()->version(), std::memory_order_release);
+}
+
+/**
+ * @brief Frees the published and the replaced snapshots.
+ */
+AlarmService::~AlarmService() {
+    for (const auto &entry : retired) {
+        delete entry.second;
+    }
+    delete current.load();
+}
+
+/**
+ * @brief Reads the current state on the service's thread, or copies the published snapshot out.
+ *
+ * Another thread announces its epoch in a reader slot while it copies.
+ * Claiming a slot is a single compare-and-swap and threads start at
+ * different slots; when every slot is taken the reader yields after each
+ * full pass instead of spinning.
+ */
+AlarmServiceSnapshot AlarmService::snapshot() const {
+    if (QThread::currentThread() == thread()) return build();
+
+    static thread_local const size_t firstSlot = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    ReaderSlot *slot = nullptr;
+    for (size_t i = firstSlot;; ++i) {
+        quint64 expected = 0;
+        if (readers[i % ReaderSlots].epoch.compare_exchange_strong(expected, epoch.load())) {
+            slot = &readers[i % ReaderSlots];
+            break;
+        }
+        if ((i - firstSlot) % ReaderSlots == ReaderSlots - 1) QThread::yieldCurrentThread();
+    }
+
+    // The state cannot be deleted while the slot holds an epoch from before it was replaced
+    const State *state = current.load();
+    const AlarmServiceSnapshot result = state ? state->snapshot : AlarmServiceSnapshot();
+    slot->epoch.store(0, std::memory_order_release);
+    return result;
+}
+
+/**
+ * @brief Publishes for the first reader, waiting for the service's thread if needed.
+ */
+void AlarmService::attachReader() {
+    if (QThread::currentThread() == thread()) return;
+
+    QMutexLocker locker(&attachMutex);
+    if (attachedReaders.fetch_add(1) == 0) {
+        QMetaObject::invokeMethod(this, &AlarmService::publish, Qt::BlockingQueuedConnection);
+    }
+}
+
+/**
+ * @brief Asks the service's thread to stop publishing once the last reader is gone.
+ */
+void AlarmService::detachReader() {
+    if (QThread::currentThread() == thread()) return;
+
+    QMutexLocker locker(&attachMutex);
+    if (attachedReaders.fetch_sub(1) == 1) {
+        QMetaObject::invokeMethod(this, &AlarmService::unpin, Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Copies the store's snapshot and the table into a value.
+ */
+AlarmServiceSnapshot AlarmService::build() const {
+    AlarmServiceSnapshot snapshot;
+    snapshot.store = alarmScheduler->store()->snapshot();
+    snapshot.fires = alarmScheduler->nextFires()->table();
+    snapshot.zone = alarmScheduler->nextFires()->timeZone();
+    return snapshot;
+}
+
+/**
+ * @brief Publishes for the attached readers; with none, keeps nothing that would pin the store's list.
+ */
+void AlarmService::publish() {
+    const quint64 version = alarmScheduler->store()->version();
+    publishedVersion.store(version, std::memory_order_release);
+    swapIn(attachedReaders.load() > 0 ? new State{build()} : nullptr);
+    emit published(version);
+}
+
+/**
+ * @brief Runs after the last detachReader(); a reader attached since then keeps publishing.
+ */
+void AlarmService::unpin() {
+    if (attachedReaders.load() == 0) swapIn(nullptr);
+}
+
+/**
+ * @brief Swaps the published state and retires the old one.
+ */
+void AlarmService::swapIn(const State *state) {
+    const State *old = current.exchange(state);
+    if (old) {
+        // Readers that announced this epoch or an older one may still be copying old
+        retired.append({epoch.fetch_add(1), old});
+    }
+    reclaim();
+}
+
+/**
+ * @brief Frees retired snapshots older than every announced epoch.
+ */
+void AlarmService::reclaim() {
+    quint64 oldestReader = std::numeric_limits<quint64>::max();
+    for (const ReaderSlot &slot : readers) {
+        const quint64 readerEpoch = slot.epoch.load();
+        if (readerEpoch != 0) oldestReader = qMin(oldestReader, readerEpoch);
+    }
+
+    int kept = 0;
+    for (int i = 0; i < retired.size(); ++i) {
+        if (retired[i].first < oldestReader) {
+            delete retired[i].second;
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+
+    if (!retired.isEmpty() && !reclaimTimer.isActive()) reclaimTimer.start();
+}
+
+/**
+ * @brief Runs the mutation now on the service's thread, or queues it there.
+ */
+void AlarmService::post(std::function<void()> mutation) {
+    if (QThread::currentThread() == thread()) {
+        mutation();
+    } else {
+        QMetaObject::invokeMethod(this, std::move(mutation), Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Adds an alarm through the scheduler.
+ */
+void AlarmService::addAlarm(QTime time, const QString &repeat, const QString &label, const QString &sound,
+                            const QString &calendar, const QString &group) {
+    post([=]() { alarmScheduler->addAlarm(time, repeat, label, sound, calendar, group); });
+}
+
+/**
+ * @brief Replaces an alarm in the store.
+ */
+void AlarmService::updateAlarm(const Alarm &alarm) {
+    post([=]() { alarmScheduler->store()->update(alarm); });
+}
+
+/**
+ * @brief Removes an alarm from the store.
+ */
+void AlarmService::removeAlarm(quint64 id) {
+    post([=]() { alarmScheduler->store()->remove(id); });
+}
+
+/**
+ * @brief Switches a group's alarms through the store, as one change.
+ */
+void AlarmService::setGroupEnabled(const QString &group, bool enabled) {
+    post([=]() { alarmScheduler->store()->setGroupEnabled(group, enabled); });
+}
+
+/**
+ * @brief Snoozes an alarm through the scheduler.
+ */
+void AlarmService::snooze(quint64 id, int minutes) {
+    post([=]() { alarmScheduler->snooze(id, minutes); });
+}
+
+/**
+ * @brief Dismisses an alarm through the scheduler.
+ */
+void AlarmService::dismiss(quint64 id) {
+    post([=]() { alarmScheduler->dismiss(id); });
+}
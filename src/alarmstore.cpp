@@ -0,0 +1,170 @@
+/**
+ * @file alarmstore.cpp
+ * @brief Implementation file for the AlarmStore class.
+ *
+ * This file contains the copy-on-write mutation logic of the alarm store and
+ * the generation of the change deltas sent to views.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "alarmstore.h"
+
+/**
+ * @brief Constructs an empty snapshot.
+ */
+AlarmSnapshot::AlarmSnapshot() : d(new Data) {
+}
+
+/**
+ * @brief Constructs an empty store.
+ * @param parent The parent object.
+ */
+AlarmStore::AlarmStore(QObject *parent) : QObject(parent) {
+}
+
+/**
+ * @brief Looks up an alarm by id.
+ * @return Pointer into the current list (valid until the next mutation), or nullptr.
+ */
+const Alarm *AlarmStore::find(quint64 id) const {
+    const int index = current.indexOf(id);
+    return index == -1 ? nullptr : &current.alarms()[index];
+}
+
+/**
+ * @brief Adds a single alarm.
+ * @return The id of the new alarm.
+ */
+quint64 AlarmStore::add(const Alarm &alarm) {
+    return apply({alarm}, {}, {}).value(0);
+}
+
+/**
+ * @brief Replaces a single alarm.
+ * @return False if the alarm does not exist.
+ */
+bool AlarmStore::update(const Alarm &alarm) {
+    if (current.indexOf(alarm.id) == -1) return false;
+    apply({}, {alarm}, {});
+    return true;
+}
+
+/**
+ * @brief Removes a single alarm.
+ * @return False if the alarm does not exist.
+ */
+bool AlarmStore::remove(quint64 id) {
+    if (current.indexOf(id) == -1) return false;
+    apply({}, {}, {id});
+    return true;
+}
+
+/**
+ * @brief Applies a batch of changes as one new version.
+ *
+ * The list is modified in place; it is only copied if a snapshot of the
+ * previous version is still held somewhere.
+ */
+QVector<quint64> AlarmStore::apply(const QVector<Alarm> &added, const QVector<Alarm> &updated, const QSet<quint64> &removed) {
+    QVector<AlarmChange> changes;
+    QVector<quint64> addedIds;
+    const quint64 fromVersion = current.version();
+
+    // Non-const access detaches the snapshot if someone still holds the old one
+    const AlarmSnapshot::Data *shared = current.d.constData();
+    AlarmSnapshot::Data &data = *current.d;
+    if (&data != shared) ++detaches;
+    QVector<Alarm> &list = data.alarms;
+
+    if (!removed.isEmpty()) {
+        int kept = 0;
+        for (int i = 0; i < list.size(); ++i) {
+            if (removed.contains(list[i].id)) {
+                changes.append({AlarmChange::Removed, list[i].id, -1});
+                unindexGroup(list[i]);
+                data.indexById.remove(list[i].id);
+                continue;
+            }
+            if (kept != i) {
+                list[kept] = std::move(list[i]);
+                data.indexById.insert(list[kept].id, kept);
+            }
+            ++kept;
+        }
+        list.resize(kept);
+    }
+
+    for (const Alarm &alarm : updated) {
+        const int index = current.indexOf(alarm.id);
+        if (index == -1) continue;
+        if (list[index].group != alarm.group) {
+            unindexGroup(list[index]);
+            indexGroup(alarm);
+        }
+        list[index] = alarm;
+        changes.append({AlarmChange::Updated, alarm.id, index});
+    }
+
+    for (Alarm alarm : added) {
+        alarm.id = nextId++;
+        indexGroup(alarm);
+        list.append(alarm);
+        data.indexById.insert(alarm.id, list.size() - 1);
+        addedIds.append(alarm.id);
+        changes.append({AlarmChange::Added, alarm.id, list.size() - 1});
+    }
+
+    if (changes.isEmpty()) return addedIds;
+
+    data.version = fromVersion + 1;
+    emit changed(fromVersion, data.version, changes);
+    return addedIds;
+}
+
+/**
+ * @brief Lists the indexed groups in alphabetical order.
+ */
+QStringList AlarmStore::groupNames() const {
+    QStringList names;
+    names.reserve(groupIndex.size());
+    for (auto it = groupIndex.constBegin(); it != groupIndex.constEnd(); ++it) {
+        names.append(it.key().toString());
+    }
+    names.sort(Qt::CaseInsensitive);
+    return names;
+}
+
+/**
+ * @brief Collects the alarms whose flag differs and updates them in one batch.
+ */
+int AlarmStore::setEnabled(const QSet<quint64> &ids, bool enabled) {
+    QVector<Alarm> updated;
+    for (quint64 id : ids) {
+        const Alarm *alarm = find(id);
+        if (!alarm || alarm->enabled == enabled) continue;
+        updated.append(*alarm);
+        updated.last().enabled = enabled;
+    }
+    if (!updated.isEmpty()) apply({}, updated, {});
+    return updated.size();
+}
+
+/**
+ * @brief Records an alarm under its group; alarms without a group are not indexed.
+ */
+void AlarmStore::indexGroup(const Alarm &alarm) {
+    if (!alarm.group.isEmpty()) groupIndex[alarm.group].insert(alarm.id);
+}
+
+/**
+ * @brief Forgets an alarm's group membership, dropping groups that become empty.
+ */
+void AlarmStore::unindexGroup(const Alarm &alarm) {
+    if (alarm.group.isEmpty()) return;
+    auto members = groupIndex.find(alarm.group);
+    if (members == groupIndex.end()) return;
+    members->remove(alarm.id);
+    if (members->isEmpty()) groupIndex.erase(members);
+}
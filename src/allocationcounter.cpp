@@ -0,0 +1,62 @@
+/**
+ * @file allocationcounter.cpp
+ * @brief Implementation of the heap allocation counters.
+ *
+ * Only the counters live here; nothing in this file replaces the allocator,
+ * so linking alarmcore leaves malloc alone. The counters move only in
+ * programs that also link the allocation hooks (allocationhooks.cpp).
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "allocationcounter.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<bool> hooked{false}; ///< Set once the allocation hooks are linked in.
+std::atomic<quint64> allocated{0}; ///< Blocks allocated by all threads.
+std::atomic<quint64> freed{0}; ///< Blocks freed by all threads.
+
+#if defined(__GNUC__) && !defined(_WIN32)
+/**
+ * @brief Blocks allocated by each thread.
+ *
+ * Initial-exec TLS never allocates on access, which matters inside malloc.
+ */
+__thread quint64 threadAllocated __attribute__((tls_model("initial-exec"))) = 0;
+#else
+thread_local quint64 threadAllocated = 0;
+#endif
+
+} // namespace
+
+bool AllocationCounter::isAvailable() {
+    return hooked.load(std::memory_order_relaxed);
+}
+
+quint64 AllocationCounter::allocations() {
+    return allocated.load(std::memory_order_relaxed);
+}
+
+quint64 AllocationCounter::frees() {
+    return freed.load(std::memory_order_relaxed);
+}
+
+quint64 AllocationCounter::threadAllocations() {
+    return threadAllocated;
+}
+
+void AllocationCounter::setAvailable() noexcept {
+    hooked.store(true, std::memory_order_relaxed);
+}
+
+void AllocationCounter::countAllocation() noexcept {
+    allocated.fetch_add(1, std::memory_order_relaxed);
+    ++threadAllocated;
+}
+
+void AllocationCounter::countFree() noexcept {
+    freed.fetch_add(1, std::memory_order_relaxed);
+}
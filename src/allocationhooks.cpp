@@ -0,0 +1,115 @@
+/**
+ * @file allocationhooks.cpp
+ * @brief Allocation hooks that feed the heap allocation counters.
+ *
+ * With glibc, every entry point glibc documents for replacing malloc
+ * (malloc, calloc, realloc, free and the aligned ones) is defined here and
+ * forwards to glibc's own implementation after counting. Definitions in the
+ * executable take precedence over the C library's, so Qt's containers and
+ * operator new are counted too, in every thread.
+ *
+ * This replaces the process allocator, which clashes with sanitizers and
+ * other allocators, so it is not part of alarmcore: only programs that add
+ * this file through alarmcore/allocationhooks.pri are affected.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "allocationcounter.h"
+#include <cerrno>
+#include <cstddef>
+
+#if defined(__GLIBC__) && defined(__GNUC__)
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+}
+
+namespace {
+
+[[maybe_unused]] const bool registered = (AllocationCounter::setAvailable(), true);
+
+/**
+ * @brief Counts a block returned by an allocating entry point.
+ */
+inline void *counted(void *block) {
+    if (block) AllocationCounter::countAllocation();
+    return block;
+}
+
+/**
+ * @brief Returns true if an alignment is a power of two.
+ */
+inline bool isPowerOfTwo(size_t alignment) {
+    return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+} // namespace
+
+extern "C" {
+
+void *malloc(size_t size) {
+    return counted(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size) {
+    return counted(__libc_calloc(count, size));
+}
+
+void *realloc(void *pointer, size_t size) {
+    void *block = __libc_realloc(pointer, size);
+    if (!pointer) return counted(block);
+    // A resized block is a new block and a freed one, even when it grew in place;
+    // a failed resize leaves the old block alone
+    if (block) {
+        AllocationCounter::countAllocation();
+        AllocationCounter::countFree();
+    } else if (size == 0) {
+        AllocationCounter::countFree();
+    }
+    return block;
+}
+
+void free(void *pointer) {
+    if (pointer) AllocationCounter::countFree();
+    __libc_free(pointer);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    return counted(__libc_memalign(alignment, size));
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    if (!isPowerOfTwo(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return counted(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+    if (!isPowerOfTwo(alignment) || alignment % sizeof(void *) != 0) return EINVAL;
+    void *block = counted(__libc_memalign(alignment, size));
+    if (!block) return ENOMEM;
+    *result = block;
+    return 0;
+}
+
+void *valloc(size_t size) {
+    return counted(__libc_valloc(size));
+}
+
+void *pvalloc(size_t size) {
+    return counted(__libc_pvalloc(size));
+}
+
+} // extern "C"
+
+#endif
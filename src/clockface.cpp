@@ -0,0 +1,252 @@
+/**
+ * @file clockface.cpp
+ * @brief Implementation file for the ClockFace class.
+ *
+ * This file contains the seven-segment rendering of the clock digits into a
+ * glyph atlas and the paint logic that copies glyphs only into the cells that
+ * need repainting.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "clockface.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPixmapCache>
+#include <QPolygonF>
+#include <QtMath>
+
+namespace {
+
+/**
+ * @brief Segments lit for each digit, bit 0 = a (top) ... bit 6 = g (middle).
+ */
+const unsigned char segmentMasks[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+/**
+ * @brief Maps each of the eight cells to its digit slot (-1 for colons).
+ */
+const int digitForCell[8] = {0, 1, -1, 2, 3, -1, 4, 5};
+
+/**
+ * @brief Maps each digit slot to the cell that shows it.
+ */
+const int cellForDigit[6] = {0, 1, 3, 4, 6, 7};
+
+/**
+ * @brief Width of a digit relative to its height.
+ */
+const qreal digitAspect = 0.6;
+
+/**
+ * @brief Builds a hexagonal segment running from a to b with the given thickness.
+ */
+QPolygonF segment(const QPointF &a, const QPointF &b, qreal thickness) {
+    const qreal length = qSqrt((b.x() - a.x()) * (b.x() - a.x()) + (b.y() - a.y()) * (b.y() - a.y()));
+    const QPointF along = (b - a) / length * (thickness / 2);
+    const QPointF across(-along.y(), along.x());
+
+    QPolygonF polygon;
+    polygon << a << a + along + across << b - along + across
+            << b << b - along - across << a + along - across;
+    return polygon;
+}
+
+/**
+ * @brief Paints one seven-segment digit into the given rectangle.
+ */
+void paintDigit(QPainter &painter, const QRectF &rect, int digit) {
+    const qreal thickness = qMax<qreal>(2.0, rect.width() / 6);
+    const qreal margin = thickness / 2 + 1;
+    const qreal gap = thickness * 0.2;
+    const qreal left = rect.left() + margin;
+    const qreal right = rect.right() - margin;
+    const qreal top = rect.top() + margin;
+    const qreal bottom = rect.bottom() - margin;
+    const qreal middle = rect.center().y();
+
+    const QPointF ends[7][2] = {
+        {{left + gap, top}, {right - gap, top}},         // a
+        {{right, top + gap}, {right, middle - gap}},     // b
+        {{right, middle + gap}, {right, bottom - gap}},  // c
+        {{left + gap, bottom}, {right - gap, bottom}},   // d
+        {{left, middle + gap}, {left, bottom - gap}},    // e
+        {{left, top + gap}, {left, middle - gap}},       // f
+        {{left + gap, middle}, {right - gap, middle}}    // g
+    };
+
+    for (int s = 0; s < 7; ++s) {
+        if (segmentMasks[digit] & (1 << s)) {
+            painter.drawPolygon(segment(ends[s][0], ends[s][1], thickness));
+        }
+    }
+}
+
+/**
+ * @brief Paints the two dots of a colon into the given rectangle.
+ */
+void paintColon(QPainter &painter, const QRectF &rect) {
+    const qreal radius = qMax<qreal>(1.0, rect.width() / 5);
+    painter.drawEllipse(QPointF(rect.center().x(), rect.top() + rect.height() / 3), radius, radius);
+    painter.drawEllipse(QPointF(rect.center().x(), rect.top() + rect.height() * 2 / 3), radius, radius);
+}
+
+} // namespace
+
+/**
+ * @brief Constructs the clock face.
+ * @param parent The parent widget (default is nullptr).
+ */
+ClockFace::ClockFace(QWidget *parent) : QWidget(parent) {
+    // Every paint event fills its own region, so Qt does not need to erase it first
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+/**
+ * @brief Updates the displayed time.
+ *
+ * Only the cells whose digit differs from what is on screen are invalidated,
+ * so a normal tick repaints one or two small rectangles.
+ */
+void ClockFace::setTime(int hour, int minute, int second) {
+    const int newDigits[6] = {hour / 10, hour % 10, minute / 10, minute % 10, second / 10, second % 10};
+
+    for (int i = 0; i < 6; ++i) {
+        if (digits[i] != newDigits[i]) {
+            digits[i] = newDigits[i];
+            update(cells[cellForDigit[i]]);
+        }
+    }
+}
+
+/**
+ * @brief Returns the preferred size of the clock face.
+ */
+QSize ClockFace::sizeHint() const {
+    return QSize(280, 80);
+}
+
+/**
+ * @brief Returns the smallest useful size of the clock face.
+ */
+QSize ClockFace::minimumSizeHint() const {
+    return QSize(70, 20);
+}
+
+/**
+ * @brief Copies cached glyphs into every cell that intersects the dirty region.
+ */
+void ClockFace::paintEvent(QPaintEvent *event) {
+    if (atlas.isNull() || atlasRatio != devicePixelRatioF()) {
+        rebuildAtlas();
+    }
+
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().window());
+
+    if (atlas.isNull()) return;
+
+    for (int cell = 0; cell < CellCount; ++cell) {
+        if (!event->region().intersects(cells[cell])) continue;
+
+        const int glyph = glyphForCell(cell);
+        const QSize size = glyph == ColonGlyph ? colonSize : digitSize;
+        const QRectF source(glyph * digitSize.width() * atlasRatio, 0,
+                            size.width() * atlasRatio, size.height() * atlasRatio);
+        painter.drawPixmap(QRectF(cells[cell]), atlas, source);
+    }
+}
+
+/**
+ * @brief Lays out the cells and drops the atlas when the size changes.
+ */
+void ClockFace::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    layoutCells();
+    atlas = QPixmap();
+}
+
+/**
+ * @brief Drops the atlas when the palette changes so glyphs are recoloured.
+ */
+void ClockFace::changeEvent(QEvent *event) {
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange) {
+        atlas = QPixmap();
+        update();
+    }
+    QWidget::changeEvent(event);
+}
+
+/**
+ * @brief Fits six digits and two half-width colons into the widget, centred.
+ */
+void ClockFace::layoutCells() {
+    const QRect area = contentsRect();
+    const int digitWidth = qMax(0, qMin(int(area.width() / 7), int(area.height() * digitAspect)));
+    const int digitHeight = int(digitWidth / digitAspect);
+    digitSize = QSize(digitWidth, digitHeight);
+    colonSize = QSize(digitWidth / 2, digitHeight);
+
+    int x = area.left() + (area.width() - 6 * digitWidth - 2 * colonSize.width()) / 2;
+    const int y = area.top() + (area.height() - digitHeight) / 2;
+    for (int cell = 0; cell < CellCount; ++cell) {
+        const QSize size = digitForCell[cell] == -1 ? colonSize : digitSize;
+        cells[cell] = QRect(QPoint(x, y), size);
+        x += size.width();
+    }
+}
+
+/**
+ * @brief Renders digits 0-9 and the colon side by side into the atlas.
+ */
+void ClockFace::rebuildAtlas() {
+    atlasRatio = devicePixelRatioF();
+    if (digitSize.isEmpty()) {
+        atlas = QPixmap();
+        return;
+    }
+
+    const QString key = atlasKey();
+    if (QPixmapCache::find(key, &atlas)) return;
+
+    const QSize logicalSize(10 * digitSize.width() + colonSize.width(), digitSize.height());
+    atlas = QPixmap(logicalSize * atlasRatio);
+    atlas.setDevicePixelRatio(atlasRatio);
+    atlas.fill(palette().color(QPalette::Window));
+
+    QPainter painter(&atlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(palette().color(QPalette::WindowText));
+
+    for (int digit = 0; digit < 10; ++digit) {
+        paintDigit(painter, QRectF(QPointF(digit * digitSize.width(), 0), QSizeF(digitSize)), digit);
+    }
+    paintColon(painter, QRectF(QPointF(ColonGlyph * digitSize.width(), 0), QSizeF(colonSize)));
+    painter.end();
+
+    QPixmapCache::insert(key, atlas);
+}
+
+/**
+ * @brief Builds the cache key from everything that affects the rendered glyphs.
+ */
+QString ClockFace::atlasKey() const {
+    return QString("riseclockface:%1x%2:%3:%4:%5")
+            .arg(digitSize.width())
+            .arg(digitSize.height())
+            .arg(atlasRatio)
+            .arg(palette().color(QPalette::Window).rgba(), 0, 16)
+            .arg(palette().color(QPalette::WindowText).rgba(), 0, 16);
+}
+
+/**
+ * @brief Returns the atlas glyph for a cell.
+ * @return A digit 0-9, or ColonGlyph.
+ */
+int ClockFace::glyphForCell(int cell) const {
+    const int slot = digitForCell[cell];
+    return slot == -1 ? int(ColonGlyph) : digits[slot];
+}
@@ -0,0 +1,75 @@
+/**
+ * @file clocksource.cpp
+ * @brief Implementation file for the ClockSource classes.
+ *
+ * This file contains the implementation of the system clock and of the
+ * virtual clock used to replay alarms without waiting in real time.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "clocksource.h"
+#include <QElapsedTimer>
+
+/**
+ * @brief Returns the shared system clock.
+ * @return Pointer to a process-wide SystemClock instance.
+ */
+ClockSource *ClockSource::system() {
+    static SystemClock systemClock;
+    return &systemClock;
+}
+
+/**
+ * @brief Reads the real system time.
+ * @return The current date and time in UTC.
+ */
+QDateTime SystemClock::currentDateTimeUtc() const {
+    return QDateTime::currentDateTimeUtc();
+}
+
+/**
+ * @brief Reads the monotonic clock.
+ * @return Milliseconds since the first call in this process.
+ */
+qint64 SystemClock::monotonicMSecs() const {
+    static const QElapsedTimer start = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return start.elapsed();
+}
+
+/**
+ * @brief Constructs the virtual clock at the given instant.
+ * @param start The initial date and time.
+ */
+VirtualClock::VirtualClock(const QDateTime &start) : msecsSinceEpoch(start.toMSecsSinceEpoch()) {
+}
+
+/**
+ * @brief Returns the virtual instant in UTC.
+ * @return The current virtual date and time.
+ */
+QDateTime VirtualClock::currentDateTimeUtc() const {
+    return QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch, Qt::UTC);
+}
+
+/**
+ * @brief Jumps the virtual clock to a new instant.
+ * @param dateTime The new current date and time.
+ */
+void VirtualClock::setCurrentDateTime(const QDateTime &dateTime) {
+    msecsSinceEpoch = dateTime.toMSecsSinceEpoch();
+}
+
+/**
+ * @brief Advances the virtual clock.
+ * @param msecs Milliseconds to add to the current instant.
+ */
+void VirtualClock::advance(qint64 msecs) {
+    msecsSinceEpoch += msecs;
+    if (msecs > 0) monotonic += msecs;
+}
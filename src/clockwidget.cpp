@@ -10,28 +10,37 @@
  */
 
 #include "clockwidget.h"
+#include "slotprofiler.h"
 
 /**
  * @brief Constructs the ClockWidget.
  * Initializes the clock display, timezone selector, and updates the time periodically.
+ * @param clock The clock to read the time from (nullptr means the system clock).
  * @param parent The parent widget (default is nullptr).
  */
 
-ClockWidget::ClockWidget(QWidget *parent) : QWidget(parent), currentTimeZone(QTimeZone::systemTimeZone()) {
+ClockWidget::ClockWidget(ClockSource *clock, QWidget *parent)
+    : QWidget(parent), currentTimeZone(QTimeZone::systemTimeZone()),
+      clockSource(clock ? clock : ClockSource::system()) {
+    zoneOffsets.addZone(currentTimeZone);
+
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->setSpacing(0);   // Removes extra space between widgets
     layout->setContentsMargins(0, 0, 0, 0); // Removes margins around the layout
 
     // Clock Display
-    clockDisplay = new QLCDNumber(this);
-    clockDisplay->setDigitCount(8);
+    clockDisplay = new ClockFace(this);
     layout->addWidget(clockDisplay);
 
+    timezoneLabel = nullptr;
+    timezoneSelector = nullptr;
+#ifndef RISE_KIOSK
     // Label for Timezone Selector
     timezoneLabel = new QLabel("Change Time Zone:", this);
     layout->addWidget(timezoneLabel);
 
-    // Timezone Selector
+    // Timezone Selector (the kiosk build always shows the system zone and skips
+    // loading the list of every known zone)
     timezoneSelector = new QComboBox(this);
     QStringList timezones;
     for (const QByteArray &tzId : QTimeZone::availableTimeZoneIds()) {
@@ -40,11 +49,12 @@ ClockWidget::ClockWidget(QWidget *parent) : QWidget(parent), currentTimeZone(QTi
     timezoneSelector->addItems(timezones);
     timezoneSelector->setCurrentText(QString(currentTimeZone.id())); // Set default timezone
     layout->addWidget(timezoneSelector);
+    connect(timezoneSelector, &QComboBox::currentTextChanged, this, &ClockWidget::changeTimezone);
+#endif
 
     // Timer for Clock Update
     QTimer *timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &ClockWidget::updateTime);
-    connect(timezoneSelector, &QComboBox::currentTextChanged, this, &ClockWidget::changeTimezone);
 
     timer->start(1000);
     updateTime();
@@ -52,10 +62,15 @@ ClockWidget::ClockWidget(QWidget *parent) : QWidget(parent), currentTimeZone(QTi
 
 /**
  * @brief Updates the clock display based on the selected timezone.
+ *
+ * The zone database is only consulted when the cached offset expires.
  */
 void ClockWidget::updateTime() {
-    QDateTime currentTime = QDateTime::currentDateTimeUtc().toTimeZone(currentTimeZone);
-    clockDisplay->display(currentTime.toString("hh:mm:ss"));
+    RISE_PROFILE_SLOT("ClockWidget::updateTime");
+    const qint64 utc = clockSource->currentDateTimeUtc().toMSecsSinceEpoch();
+    zoneOffsets.update(utc);
+    const ZoneOffsetTable::LocalTime local = zoneOffsets.localTime(0, utc);
+    clockDisplay->setTime(local.hour, local.minute, local.second);
 }
 
 /**
@@ -65,5 +80,7 @@ void ClockWidget::updateTime() {
  */
 void ClockWidget::changeTimezone(const QString &timezoneId) {
     currentTimeZone = QTimeZone(timezoneId.toUtf8());
+    zoneOffsets.removeZone(0);
+    zoneOffsets.addZone(currentTimeZone);
     updateTime(); // Immediately update the time display
 }
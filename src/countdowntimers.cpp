@@ -0,0 +1,142 @@
+/**
+ * @file countdowntimers.cpp
+ * @brief Implementation file for the CountdownTimers class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "countdowntimers.h"
+#include <QDebug>
+
+/**
+ * @brief Follows the scheduler's expired deadlines.
+ * @param scheduler Scheduler the deadlines are kept in.
+ * @param parent The parent object.
+ */
+CountdownTimers::CountdownTimers(DeadlineScheduler *scheduler, QObject *parent)
+    : QObject(parent), deadlineScheduler(scheduler) {
+    connect(deadlineScheduler, &DeadlineScheduler::expired, this, &CountdownTimers::onExpired);
+}
+
+/**
+ * @brief Looks a timer up by id.
+ */
+const CountdownTimer *CountdownTimers::find(quint64 id) const {
+    const int index = indexOf(id);
+    return index == -1 ? nullptr : &list[index];
+}
+
+/**
+ * @brief Appends a stopped timer set to its full length.
+ */
+quint64 CountdownTimers::add(const QString &label, qint64 durationMs) {
+    if (durationMs <= 0) return 0;
+
+    CountdownTimer timer;
+    timer.id = ++lastId;
+    timer.label = label;
+    timer.durationMs = durationMs;
+    timer.remainingMs = durationMs;
+    list.append(timer);
+    emit added(timer.id);
+    return timer.id;
+}
+
+/**
+ * @brief Turns the time left into a deadline.
+ */
+void CountdownTimers::start(quint64 id) {
+    const int index = indexOf(id);
+    if (index == -1 || list[index].isRunning()) return;
+
+    CountdownTimer &timer = list[index];
+    if (timer.finished || timer.remainingMs <= 0) {
+        timer.remainingMs = timer.durationMs;
+        timer.finished = false;
+    }
+    timer.deadline = clock()->monotonicMSecs() + timer.remainingMs;
+    timer.handle = deadlineScheduler->schedule(timer.deadline);
+    byHandle.insert(timer.handle, id);
+    qDebug() << "[TIMER] Started" << timer.label << "with" << timer.remainingMs << "ms left";
+    emit stateChanged(id);
+}
+
+/**
+ * @brief Turns the deadline back into the time left.
+ */
+void CountdownTimers::pause(quint64 id) {
+    const int index = indexOf(id);
+    if (index == -1 || !list[index].isRunning()) return;
+
+    CountdownTimer &timer = list[index];
+    timer.remainingMs = timer.remainingAt(clock()->monotonicMSecs());
+    deadlineScheduler->cancel(timer.handle);
+    byHandle.remove(timer.handle);
+    timer.handle = 0;
+    emit stateChanged(id);
+}
+
+/**
+ * @brief Stops a timer and restores its full length.
+ */
+void CountdownTimers::reset(quint64 id) {
+    const int index = indexOf(id);
+    if (index == -1) return;
+
+    CountdownTimer &timer = list[index];
+    if (timer.isRunning()) {
+        deadlineScheduler->cancel(timer.handle);
+        byHandle.remove(timer.handle);
+        timer.handle = 0;
+    }
+    timer.remainingMs = timer.durationMs;
+    timer.finished = false;
+    emit stateChanged(id);
+}
+
+/**
+ * @brief Cancels a timer's deadline and drops it from the list.
+ */
+void CountdownTimers::remove(quint64 id) {
+    const int index = indexOf(id);
+    if (index == -1) return;
+
+    if (list[index].isRunning()) {
+        deadlineScheduler->cancel(list[index].handle);
+        byHandle.remove(list[index].handle);
+    }
+    list.remove(index);
+    emit removed(id);
+}
+
+/**
+ * @brief Marks the timer of a reached deadline as finished.
+ *
+ * The scheduler is shared, so deadlines that belong to someone else are
+ * ignored.
+ */
+void CountdownTimers::onExpired(quint64 handle) {
+    const quint64 id = byHandle.take(handle);
+    const int index = indexOf(id);
+    if (index == -1) return;
+
+    CountdownTimer &timer = list[index];
+    timer.handle = 0;
+    timer.remainingMs = 0;
+    timer.finished = true;
+    qDebug() << "[TIMER] Finished" << timer.label;
+    emit stateChanged(id);
+    emit finished(id);
+}
+
+/**
+ * @brief Searches the list; there are only ever a few dozen timers.
+ */
+int CountdownTimers::indexOf(quint64 id) const {
+    if (id == 0) return -1;
+    for (int i = 0; i < list.size(); ++i) {
+        if (list[i].id == id) return i;
+    }
+    return -1;
+}
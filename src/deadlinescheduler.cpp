@@ -0,0 +1,84 @@
+/**
+ * @file deadlinescheduler.cpp
+ * @brief Implementation file for the DeadlineScheduler class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "deadlinescheduler.h"
+#include <QVector>
+#include <limits>
+
+const qint64 DeadlineScheduler::NoDeadline = std::numeric_limits<qint64>::max();
+
+/**
+ * @brief Sets up the shared timer.
+ * @param clock Clock whose monotonic time the deadlines are in.
+ * @param parent The parent object.
+ */
+DeadlineScheduler::DeadlineScheduler(ClockSource *clock, QObject *parent)
+    : QObject(parent), clockSource(clock ? clock : ClockSource::system()) {
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &DeadlineScheduler::poll);
+}
+
+/**
+ * @brief Inserts a deadline and re-arms the timer if it is the new earliest one.
+ */
+quint64 DeadlineScheduler::schedule(qint64 deadline) {
+    const quint64 handle = ++lastHandle;
+    const bool earliest = deadline < nextDeadline();
+    queue.insert({deadline, handle});
+    deadlines.insert(handle, deadline);
+    if (earliest) rearm();
+    return handle;
+}
+
+/**
+ * @brief Removes a deadline; the timer is only touched if it was the earliest one.
+ */
+bool DeadlineScheduler::cancel(quint64 handle) {
+    const auto it = deadlines.find(handle);
+    if (it == deadlines.end()) return false;
+
+    const bool earliest = it.value() == nextDeadline();
+    queue.erase({it.value(), handle});
+    deadlines.erase(it);
+    if (earliest) rearm();
+    return true;
+}
+
+/**
+ * @brief Takes the reached deadlines off the queue before reporting them.
+ *
+ * Receivers may schedule and cancel from expired(); they see a queue that
+ * no longer holds the deadlines being reported.
+ */
+void DeadlineScheduler::poll() {
+    const qint64 now = clockSource->monotonicMSecs();
+    QVector<quint64> reached;
+    while (!queue.empty() && queue.begin()->first <= now) {
+        reached.append(queue.begin()->second);
+        deadlines.remove(queue.begin()->second);
+        queue.erase(queue.begin());
+    }
+    rearm();
+
+    for (quint64 handle : reached) {
+        emit expired(handle);
+    }
+}
+
+/**
+ * @brief Waits for the earliest deadline.
+ */
+void DeadlineScheduler::rearm() {
+    if (queue.empty()) {
+        timer.stop();
+        return;
+    }
+    const qint64 wait = queue.begin()->first - clockSource->monotonicMSecs();
+    timer.start(int(qBound<qint64>(0, wait, std::numeric_limits<int>::max())));
+}
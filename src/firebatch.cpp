@@ -0,0 +1,104 @@
+/**
+ * @file firebatch.cpp
+ * @brief Implementation file for the FireBatch class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "firebatch.h"
+
+namespace {
+
+/**
+ * @brief Appends a non-negative number without going through a temporary string.
+ */
+void appendNumber(QString &text, int value) {
+    char digits[12];
+    int begin = sizeof(digits);
+    do {
+        digits[--begin] = char('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    text.append(QLatin1String(digits + begin, int(sizeof(digits)) - begin));
+}
+
+} // namespace
+
+/**
+ * @brief Copies each loaded scheduler's due ids into the reused parts, then builds the texts.
+ *
+ * The ids are copied one by one rather than assigned, so the parts never
+ * share the scheduler's result buffer (which would make its next
+ * dueAlarms() call copy it) and keep their own capacity.
+ */
+int FireBatch::collect(AlarmProfiles &profiles, const QDateTime &now) {
+    profiles.loadDue(now);
+    usedParts = 0;
+    dueCount = 0;
+    for (AlarmScheduler *scheduler : profiles.loaded()) {
+        const QVector<quint64> due = scheduler->dueAlarms(now);
+        if (due.isEmpty()) continue;
+        if (usedParts == parts.size()) parts.append(Part());
+        Part &part = parts[usedParts++];
+        part.scheduler = scheduler;
+        part.ids.clear();
+        for (quint64 id : due) part.ids.append(id);
+        dueCount += due.size();
+    }
+
+    messageText.resize(0);
+    detailText.resize(0);
+    if (!dueCount) return 0;
+
+    // Name the profile as soon as more than one can ring
+    const bool showProfiles = profiles.loaded().size() > 1;
+    if (dueCount > 1) {
+        appendNumber(messageText, dueCount);
+        messageText.append(QLatin1String(" alarms have gone off:"));
+    }
+    int listed = 0;
+    for (const Part &part : *this) {
+        const QString prefix = showProfiles ? profiles.nameOf(part.scheduler) : QString();
+        for (quint64 id : part.ids) {
+            const Alarm *alarm = part.scheduler->store()->find(id);
+            if (!alarm) continue;
+            if (dueCount == 1) {
+                appendLabel(messageText, prefix, *alarm);
+                messageText.append(QLatin1String(" has gone off!"));
+                return dueCount;
+            }
+            if (listed < ShownLabels) {
+                messageText.append(QLatin1Char('\n'));
+                appendLabel(messageText, prefix, *alarm);
+            }
+            if (dueCount > ShownLabels) {
+                if (listed > 0) detailText.append(QLatin1Char('\n'));
+                appendLabel(detailText, prefix, *alarm);
+            }
+            ++listed;
+        }
+    }
+    if (dueCount > ShownLabels) {
+        messageText.append(QLatin1String("\n...and "));
+        appendNumber(messageText, dueCount - ShownLabels);
+        messageText.append(QLatin1String(" more"));
+    }
+    return dueCount;
+}
+
+const Alarm *FireBatch::first() const {
+    return usedParts ? parts[0].scheduler->store()->find(parts[0].ids.first()) : nullptr;
+}
+
+/**
+ * @brief Appends "profile: label" (with " (Snoozed)" for snoozed alarms), as Alarm::displayLabel() reads.
+ */
+void FireBatch::appendLabel(QString &text, const QString &prefix, const Alarm &alarm) const {
+    if (!prefix.isEmpty()) {
+        text.append(prefix);
+        text.append(QLatin1String(": "));
+    }
+    text.append(alarm.label.toString());
+    if (alarm.snoozed) text.append(QLatin1String(" (Snoozed)"));
+}
@@ -0,0 +1,158 @@
+/**
+ * @file historyview.cpp
+ * @brief Implementation file for the HistoryView and HistoryModel classes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "historyview.h"
+#include "slotprofiler.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QTableView>
+#include <QVBoxLayout>
+
+/**
+ * @brief Constructs an empty history model.
+ * @param history The history to read records from.
+ * @param parent The parent object.
+ */
+HistoryModel::HistoryModel(AlarmHistory *history, QObject *parent)
+    : QAbstractTableModel(parent), alarmHistory(history) {
+}
+
+/**
+ * @brief Replaces every row at once.
+ */
+void HistoryModel::setSequences(const QVector<quint64> &sequences) {
+    beginResetModel();
+    rows = sequences;
+    endResetModel();
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int HistoryModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : 4;
+}
+
+/**
+ * @brief Formats one cell from the mapped record.
+ */
+QVariant HistoryModel::data(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid()) return QVariant();
+
+    // The ring may have wrapped since the query
+    HistoryRecord record;
+    if (!alarmHistory->recordAt(rows[index.row()], &record)) {
+        return index.column() == 0 ? QVariant("(overwritten)") : QVariant();
+    }
+
+    switch (index.column()) {
+    case 0: return record.dateTime().toString("ddd dd MMM  HH:mm:ss");
+    case 1: return record.kindName();
+    case 2: return record.labelText();
+    case 3: return record.alarmTime().toString("HH:mm:ss");
+    }
+    return QVariant();
+}
+
+QVariant HistoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    switch (section) {
+    case 0: return "When";
+    case 1: return "Event";
+    case 2: return "Label";
+    case 3: return "Alarm Time";
+    }
+    return QVariant();
+}
+
+/**
+ * @brief Builds the history tab.
+ * @param history The history to show.
+ * @param parent The parent widget.
+ */
+HistoryView::HistoryView(AlarmHistory *history, QWidget *parent)
+    : QWidget(parent), alarmHistory(history) {
+    kindSelector = new QComboBox(this);
+    kindSelector->addItem("All events", 0xFF);
+    kindSelector->addItem("Fired", 1 << HistoryRecord::Fired);
+    kindSelector->addItem("Snoozed", 1 << HistoryRecord::Snoozed);
+    kindSelector->addItem("Dismissed", 1 << HistoryRecord::Dismissed);
+
+    rangeSelector = new QComboBox(this);
+    rangeSelector->addItem("Last 24 hours", 1);
+    rangeSelector->addItem("Last 7 days", 7);
+    rangeSelector->addItem("Everything", 0);
+
+    labelFilter = new QLineEdit(this);
+    labelFilter->setPlaceholderText("Label");
+    labelFilter->setClearButtonEnabled(true);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(kindSelector);
+    filterLayout->addWidget(rangeSelector);
+    filterLayout->addWidget(labelFilter, 1);
+
+    model = new HistoryModel(alarmHistory, this);
+    QTableView *table = new QTableView(this);
+    table->setModel(model);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->hide();
+    table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->horizontalHeader()->resizeSection(0, 160);
+
+    summaryLabel = new QLabel(this);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(table);
+    mainLayout->addWidget(summaryLabel);
+
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(500);
+    connect(&refreshTimer, &QTimer::timeout, this, &HistoryView::refresh);
+    connect(kindSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &HistoryView::refresh);
+    connect(rangeSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &HistoryView::refresh);
+    connect(labelFilter, &QLineEdit::textChanged, this, &HistoryView::refresh);
+    // Emitted on the writer thread; the connection queues it to this one
+    connect(alarmHistory, &AlarmHistory::recordsWritten, this, [this]() {
+        if (isVisible() && !refreshTimer.isActive()) refreshTimer.start();
+    });
+}
+
+/**
+ * @brief Shows the latest records whenever the tab is opened.
+ */
+void HistoryView::showEvent(QShowEvent *event) {
+    refresh();
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Queries the history for the current filters.
+ */
+void HistoryView::refresh() {
+    RISE_PROFILE_SLOT("HistoryView::refresh");
+    if (!isVisible()) return;
+
+    HistoryFilter filter;
+    filter.kinds = kindSelector->currentData().toInt();
+    filter.label = labelFilter->text().toUtf8();
+    const int days = rangeSelector->currentData().toInt();
+    if (days > 0) {
+        filter.fromMSecs = QDateTime::currentMSecsSinceEpoch() - qint64(days) * 24 * 60 * 60 * 1000;
+    }
+
+    model->setSequences(alarmHistory->find(filter));
+    summaryLabel->setText(QString("%1 events shown, the last %2 are kept")
+                              .arg(model->rowCount())
+                              .arg(alarmHistory->capacity()));
+}
@@ -0,0 +1,138 @@
+/**
+ * @file holidaycalendar.cpp
+ * @brief Implementation file for the HolidayCalendar and HolidayCalendars classes.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "holidaycalendar.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+
+/**
+ * @brief Adds a range, merging it with every range it touches.
+ */
+void HolidayCalendar::addRange(const QDate &first, const QDate &last) {
+    if (!first.isValid() || !last.isValid()) return;
+    Interval added{qMin(first, last).toJulianDay(), qMax(first, last).toJulianDay()};
+
+    // First range that ends on or after the day before the new one starts
+    auto begin = std::lower_bound(ranges.begin(), ranges.end(), added.first - 1,
+                                  [](const Interval &range, qint64 day) { return range.last < day; });
+    auto end = begin;
+    while (end != ranges.end() && end->first <= added.last + 1) {
+        added.first = qMin(added.first, end->first);
+        added.last = qMax(added.last, end->last);
+        ++end;
+    }
+    const int index = int(begin - ranges.begin());
+    ranges.erase(begin, end);
+    ranges.insert(index, added);
+}
+
+/**
+ * @brief Binary-searches the range that could hold the date.
+ */
+bool HolidayCalendar::contains(const QDate &date) const {
+    const qint64 day = date.toJulianDay();
+    auto it = std::lower_bound(ranges.cbegin(), ranges.cend(), day,
+                               [](const Interval &range, qint64 day) { return range.last < day; });
+    return it != ranges.cend() && it->first <= day;
+}
+
+/**
+ * @brief Constructs an empty collection.
+ * @param parent The parent object.
+ */
+HolidayCalendars::HolidayCalendars(QObject *parent) : QObject(parent) {
+}
+
+/**
+ * @brief Returns the sorted calendar names.
+ */
+QStringList HolidayCalendars::names() const {
+    QStringList names = calendars.keys();
+    names.sort();
+    return names;
+}
+
+/**
+ * @brief Looks up a calendar by name.
+ */
+const HolidayCalendar *HolidayCalendars::calendar(const QString &name) const {
+    auto it = calendars.constFind(name);
+    return it == calendars.constEnd() ? nullptr : &*it;
+}
+
+/**
+ * @brief Adds or replaces a calendar.
+ */
+void HolidayCalendars::setCalendar(const QString &name, const HolidayCalendar &calendar) {
+    calendars.insert(name, calendar);
+    emit changed();
+}
+
+/**
+ * @brief Removes a calendar.
+ */
+void HolidayCalendars::removeCalendar(const QString &name) {
+    if (calendars.remove(name)) emit changed();
+}
+
+/**
+ * @brief Checks a date against a named calendar.
+ */
+bool HolidayCalendars::excludes(const QString &name, const QDate &date) const {
+    if (name.isEmpty()) return false;
+    auto it = calendars.constFind(name);
+    return it != calendars.constEnd() && it->contains(date);
+}
+
+/**
+ * @brief Reads calendars from a file; nothing is changed if the file has an error.
+ */
+QStringList HolidayCalendars::importFile(const QString &path, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = QString("Cannot open %1: %2").arg(path, file.errorString());
+        return {};
+    }
+
+    QHash<QString, HolidayCalendar> loaded;
+    QStringList order;
+    QString current = QFileInfo(path).completeBaseName();
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        ++lineNumber;
+        const QString line = in.readLine().section('#', 0, 0).trimmed();
+        if (line.isEmpty()) continue;
+
+        if (line.startsWith('[') && line.endsWith(']')) {
+            current = line.mid(1, line.size() - 2).trimmed();
+            continue;
+        }
+
+        const QString dates = line.section(QRegularExpression("\\s+"), 0, 0);
+        const QDate first = QDate::fromString(dates.section("..", 0, 0), Qt::ISODate);
+        const QDate last = dates.contains("..") ? QDate::fromString(dates.section("..", 1, 1), Qt::ISODate) : first;
+        if (!first.isValid() || !last.isValid() || current.isEmpty()) {
+            if (error) *error = QString("%1:%2: expected a date or date range, got \"%3\"").arg(path).arg(lineNumber).arg(line);
+            return {};
+        }
+
+        if (!loaded.contains(current)) order.append(current);
+        loaded[current].addRange(first, last);
+    }
+
+    for (const QString &name : order) {
+        calendars.insert(name, loaded.value(name));
+    }
+    if (!order.isEmpty()) emit changed();
+    return order;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file labelpool.cpp
+ * @brief Implementation file for the LabelPool class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "labelpool.h"
+
+/**
+ * @brief Creates the pool on first use and never frees it.
+ */
+LabelPool &LabelPool::instance() {
+    static LabelPool *pool = new LabelPool;
+    return *pool;
+}
+
+/**
+ * @brief Finds or stores the text under the mutex and takes a reference.
+ */
+quint32 LabelPool::intern(const QString &text) {
+    if (text.isEmpty()) return 0;
+
+    QMutexLocker locker(&mutex);
+    const auto found = byText.constFind(text);
+    if (found != byText.constEnd()) {
+        entry(found.value()).refs.fetch_add(1, std::memory_order_relaxed);
+        return found.value();
+    }
+
+    quint32 handle;
+    if (!freeHandles.isEmpty()) {
+        handle = freeHandles.takeLast();
+    } else {
+        handle = nextHandle++;
+        const quint32 chunk = handle >> ChunkBits;
+        if (chunk >= quint32(MaxChunks)) qFatal("[LABELS] More than %d distinct labels", MaxChunks * int(ChunkSize));
+        if (!chunks[chunk].load(std::memory_order_relaxed)) {
+            chunks[chunk].store(new Entry[ChunkSize], std::memory_order_release);
+        }
+    }
+
+    Entry &stored = entry(handle);
+    stored.text = text;
+    // Keep a private copy: the caller's buffer may have spare capacity (e.g. from an append)
+    stored.text.squeeze();
+    stored.refs.store(1, std::memory_order_relaxed);
+    byText.insert(stored.text, handle);
+    chars += text.size();
+    return handle;
+}
+
+/**
+ * @brief Frees the text once no Label refers to it any more.
+ *
+ * Another thread may intern the same text again between the last release
+ * and taking the mutex, or free and reuse the handle; the entry is only
+ * freed if it still is unreferenced and in use.
+ */
+void LabelPool::release(quint32 handle) {
+    if (handle == 0) return;
+    if (entry(handle).refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    QMutexLocker locker(&mutex);
+    Entry &stored = entry(handle);
+    if (stored.refs.load(std::memory_order_relaxed) != 0 || stored.text.isNull()) return;
+
+    byText.remove(stored.text);
+    chars -= stored.text.size();
+    stored.text = QString();
+    freeHandles.append(handle);
+}
+
+/**
+ * @brief Reads the entry without locking; the caller's reference keeps it alive.
+ */
+const QString &LabelPool::text(quint32 handle) const {
+    return entry(handle).text;
+}
+
+/**
+ * @brief Counts the stored texts.
+ */
+int LabelPool::size() const {
+    QMutexLocker locker(&mutex);
+    return byText.size();
+}
+
+/**
+ * @brief Sums the length of the stored texts.
+ */
+qint64 LabelPool::storedChars() const {
+    QMutexLocker locker(&mutex);
+    return chars;
+}
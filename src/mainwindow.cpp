@@ -18,10 +18,13 @@
 
 #include "mainwindow.h"
 #include "setalarmwindow.h"
+#include "slotprofiler.h"
 #include "viewAlarm.h"
 #include <QDebug>
+#include <QFileDialog>
+#include <QMenuBar>
 #include <QMessageBox>
-#include <QSound>
+#include <QShortcut>
 
 /**
  * @brief Constructs the main application window.
@@ -29,35 +32,91 @@
  * Initializes the clock display, buttons for setting and viewing alarms, 
  * and a timer to check alarms every second.
  * 
+ * @param clock The clock to read the time from (nullptr means the system clock).
  * @param parent Pointer to the parent widget.
  */
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
+MainWindow::MainWindow(ClockSource *clock, QWidget *parent) : QMainWindow(parent) {
     QWidget *centralWidget = new QWidget(this);
     QVBoxLayout *layout = new QVBoxLayout(centralWidget);
-    clockWidget = new ClockWidget(this);
+    alarmProfiles = new AlarmProfiles(clock, this);
+#ifdef RISE_KIOSK
+    alarmProfiles->setCapacity(RISE_MAX_ALARMS);
+#endif
+    alarmScheduler = alarmProfiles->active();
+    alarmService = alarmProfiles->activeService();
+    connect(alarmProfiles, &AlarmProfiles::activeChanged, this, &MainWindow::showProfile);
+    soundLibrary = new SoundLibrary(this);
+    deadlineScheduler = new DeadlineScheduler(alarmScheduler->clock(), this);
+    countdownTimers = new CountdownTimers(deadlineScheduler, this);
+    connect(countdownTimers, &CountdownTimers::finished, this, &MainWindow::countdownFinished);
+    clockWidget = new ClockWidget(alarmScheduler->clock(), this);
+
+    // New names typed into the selector create a profile; the list follows the profiles
+    profileComboBox = new QComboBox(this);
+    profileComboBox->setEditable(true);
+    profileComboBox->setInsertPolicy(QComboBox::NoInsert);
+    profileComboBox->setToolTip("Profile whose alarms are shown and set (type a new name to add one)");
+    profileComboBox->addItems(alarmProfiles->names());
+    profileComboBox->setCurrentText(alarmProfiles->activeName());
+    connect(alarmProfiles, &AlarmProfiles::profileAdded, profileComboBox, [this](const QString &name) {
+        int index = 0;
+        while (index < profileComboBox->count() && profileComboBox->itemText(index) < name) ++index;
+        profileComboBox->insertItem(index, name);
+    });
+    connect(profileComboBox, &QComboBox::textActivated, this, [this](const QString &name) {
+        if (!alarmProfiles->setActive(name.trimmed())) {
+            QMessageBox::warning(this, "Invalid Profile Name",
+                                 "Profile names are 1 to 64 letters, digits, spaces, '_' or '-'.");
+            profileComboBox->setCurrentText(alarmProfiles->activeName());
+        }
+    });
 
     // Create buttons for setting a new alarm and viewing the alarms
     setAlarmButton = new QPushButton("Set Alarm", this);
     viewAlarmsButton = new QPushButton("View Alarms", this);
+    agendaButton = new QPushButton("Agenda", this);
+    worldClockButton = new QPushButton("World Clock", this);
+    timersButton = new QPushButton("Timers", this);
 
     setAlarmButton->setMinimumHeight(40);
     viewAlarmsButton->setMinimumHeight(40);
+    agendaButton->setMinimumHeight(40);
+    worldClockButton->setMinimumHeight(40);
+    timersButton->setMinimumHeight(40);
 
     // Initialize the viewAlarmWindow pointer to nullptr (it's used later for displaying active alarms)
     viewAlarmWindow = nullptr;
 
     // Add the clock widget and buttons to the layout
+    layout->addWidget(profileComboBox);
     layout->addWidget(clockWidget);
     layout->addWidget(setAlarmButton);
     layout->addWidget(viewAlarmsButton);
+    layout->addWidget(agendaButton);
+    layout->addWidget(worldClockButton);
+    layout->addWidget(timersButton);
 
     connect(setAlarmButton, &QPushButton::clicked, this, &MainWindow::openSetAlarm);
     connect(viewAlarmsButton, &QPushButton::clicked, this, &MainWindow::openViewAlarms);
+    connect(agendaButton, &QPushButton::clicked, this, &MainWindow::openAgenda);
+    connect(worldClockButton, &QPushButton::clicked, this, &MainWindow::openWorldClock);
+    connect(timersButton, &QPushButton::clicked, this, &MainWindow::openTimers);
 
+    // Single-shot and re-armed by checkAlarms() to land just after each whole second
     alarmCheckTimer = new QTimer(this);
+    alarmCheckTimer->setSingleShot(true);
+    alarmCheckTimer->setTimerType(Qt::PreciseTimer);
     connect(alarmCheckTimer, &QTimer::timeout, this, &MainWindow::checkAlarms);
-    alarmCheckTimer->start(1000);  // Check every second
+    alarmCheckTimer->start(0);
+
+#ifndef RISE_KIOSK
+    QMenu *fileMenu = menuBar()->addMenu("File");
+    fileMenu->addAction("Import Holiday Calendar...", this, &MainWindow::importHolidays);
+#endif
+
+    QShortcut *profilerShortcut = new QShortcut(QKeySequence("Ctrl+Shift+P"), this);
+    connect(profilerShortcut, &QShortcut::activated, this, &MainWindow::toggleProfilerOverlay);
 
     setCentralWidget(centralWidget);
     this->resize(400, 300);
@@ -70,11 +129,41 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
  * a new alarm, including the time, label, repeat settings, and sound.
  */
 void MainWindow::openSetAlarm() {
-    SetAlarmWindow *setAlarmDialog = new SetAlarmWindow(this);
+    RISE_PROFILE_SLOT("MainWindow::openSetAlarm");
+    SetAlarmWindow *setAlarmDialog = new SetAlarmWindow(alarmScheduler->calendars()->names(),
+                                                        alarmScheduler->store()->groupNames(), soundLibrary, this);
+    setAlarmDialog->setAttribute(Qt::WA_DeleteOnClose); // One dialog per click, so free it afterwards
     connect(setAlarmDialog, &SetAlarmWindow::alarmSet, this, &MainWindow::handleAlarmSet);
     setAlarmDialog->exec();
 }
 
+/**
+ * @brief Switches the windows to the active profile's shard.
+ *
+ * The profile is already loaded; its store is in memory and only the
+ * windows that display it are rebuilt, when they are next opened.
+ */
+void MainWindow::showProfile(const QString &name) {
+    RISE_PROFILE_SLOT("MainWindow::showProfile");
+    alarmScheduler = alarmProfiles->active();
+    alarmService = alarmProfiles->activeService();
+    profileComboBox->setCurrentText(name);
+
+    const bool alarmsShown = viewAlarmWindow && viewAlarmWindow->isVisible();
+    const bool agendaShown = agendaWindow && agendaWindow->isVisible();
+    const bool overlayShown = profilerOverlay && profilerOverlay->isVisible();
+    // A click in one of them may have led here, so they are not deleted on the spot
+    if (viewAlarmWindow) viewAlarmWindow->deleteLater();
+    if (agendaWindow) agendaWindow->deleteLater();
+    if (profilerOverlay) profilerOverlay->deleteLater();
+    viewAlarmWindow = nullptr;
+    agendaWindow = nullptr;
+    profilerOverlay = nullptr;
+    if (alarmsShown) openViewAlarms();
+    if (agendaShown) openAgenda();
+    if (overlayShown) toggleProfilerOverlay();
+}
+
 /**
  * @brief Handles the event when an alarm is set.
  * 
@@ -84,27 +173,69 @@ void MainWindow::openSetAlarm() {
  * @param repeat The repeat setting of the alarm.
  * @param label A label/name for the alarm.
  * @param sound The sound file associated with the alarm.
+ * @param calendar The holiday calendar the alarm skips.
+ * @param group The group the alarm belongs to.
  */
-void MainWindow::handleAlarmSet(QTime time, QString repeat, QString label, QString sound) {
-    qDebug() << "Alarm set for:" << time.toString("HH:mm")
+void MainWindow::handleAlarmSet(QTime time, QString repeat, QString label, QString sound, QString calendar, QString group) {
+    qDebug() << "Alarm set for:" << time.toString("HH:mm:ss")
              << "| Repeat:" << repeat
              << "| Label:" << label
-             << "| Sound:" << sound;
-
-    alarms.append(time);
-    originalAlarmTimes.append(time);
-    alarmLabels.append(label);
-    alarmRepeats.append(repeat);
-    alarmSounds.append(sound);
-    alarmIsSnoozed.append(false);
+             << "| Sound:" << sound
+             << "| Skips:" << calendar
+             << "| Group:" << group;
 
+    if (!alarmScheduler->addAlarm(time, repeat, label, sound, calendar, group)) {
+        QMessageBox::warning(this, "Alarm Limit Reached",
+                             QString("Only %1 alarms can be stored on this device.").arg(alarmScheduler->maxAlarms()));
+    }
+}
 
-    if (viewAlarmWindow) {
-        viewAlarmWindow->updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
+/**
+ * @brief Imports holiday calendars from a file chosen by the user.
+ *
+ * See HolidayCalendars::importFile() for the file format. Imported
+ * calendars can then be picked in the Set Alarm and Modify Alarm dialogs.
+ */
+void MainWindow::importHolidays() {
+    const QString path = QFileDialog::getOpenFileName(this, "Import Holiday Calendar", QString(),
+                                                      "Holiday calendars (*.txt *.holidays);;All files (*)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    const QStringList imported = alarmProfiles->calendars()->importFile(path, &error);
+    if (imported.isEmpty()) {
+        QMessageBox::warning(this, "Import Failed", error.isEmpty() ? QString("No dates found in %1.").arg(path) : error);
+        return;
+    }
+    qDebug() << "[HOLIDAYS] Imported calendars:" << imported;
+    QMessageBox::information(this, "Holiday Calendars Imported", "Imported: " + imported.join(", "));
+}
 
+/**
+ * @brief Returns the times of all alarms.
+ * @return A QList of QTime objects representing the alarm times.
+ */
+QList<QTime> MainWindow::getAlarms() const {
+    const AlarmServiceSnapshot snapshot = alarmService->snapshot();
+    QList<QTime> times;
+    for (const Alarm &alarm : snapshot.alarms()) {
+        times.append(alarm.time);
     }
+    return times;
 }
 
+/**
+ * @brief Returns the labels of all alarms.
+ * @return A QList of QString objects representing the alarm labels.
+ */
+QList<QString> MainWindow::getAlarmLabels() const {
+    const AlarmServiceSnapshot snapshot = alarmService->snapshot();
+    QList<QString> labels;
+    for (const Alarm &alarm : snapshot.alarms()) {
+        labels.append(alarm.label.toString());
+    }
+    return labels;
+}
 
 /**
  * @brief Opens the View Alarms window.
@@ -113,261 +244,358 @@ void MainWindow::handleAlarmSet(QTime time, QString repeat, QString label, QStri
 void MainWindow::openViewAlarms() {
     qDebug() << "View Alarms button clicked!";
 
+    // The window follows the alarm store by itself, so it is only created once
     if (!viewAlarmWindow) {
-        viewAlarmWindow = new ViewAlarm(this);
-
-        // Only connect once when the window is first created
-        connect(viewAlarmWindow, &ViewAlarm::alarmDeleted, this, [=](const QString &label) {
-            int index = alarmLabels.indexOf(label);
-            if (index != -1) {
-                alarms.removeAt(index);
-                alarmLabels.removeAt(index);
-                alarmSounds.removeAt(index);
-                alarmRepeats.removeAt(index);
-            }
-        });
-
+        viewAlarmWindow = new ViewAlarm(alarmScheduler->store(), alarmScheduler->calendars(), alarmScheduler->history(),
+                                       alarmScheduler->nextFires(), alarmScheduler->clock(), soundLibrary, this);
     }
 
-    viewAlarmWindow->updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
     viewAlarmWindow->show();
 }
 
-
 /**
- * @brief Checks if any alarms match the current time and triggers an alert.
- * If an alarm matches the current system time, a message box is displayed with
- * options to snooze or dismiss the alarm.
+ * @brief Opens the Agenda window.
+ * Lists what will ring over the next day, week or month.
  */
+void MainWindow::openAgenda() {
+    if (!agendaWindow) {
+        agendaWindow = new AgendaView(alarmScheduler->occurrences(), alarmScheduler->store(), alarmScheduler->clock(), this);
+    }
 
-void MainWindow::checkAlarms() {
-    QTime currentTime = QTime::currentTime();
-    QDate currentDate = QDate::currentDate();
-    int currentHour = currentTime.hour();
-    int currentMinute = currentTime.minute();
-
-    // Check if today's the correct day for this repeating alarm
-    Qt::DayOfWeek today = static_cast<Qt::DayOfWeek>(currentDate.dayOfWeek());
-    static const QMap<QString, Qt::DayOfWeek> repeatMap = {
-        {"Every Sunday", Qt::Sunday}, {"Every Monday", Qt::Monday},
-        {"Every Tuesday", Qt::Tuesday}, {"Every Wednesday", Qt::Wednesday},
-        {"Every Thursday", Qt::Thursday}, {"Every Friday", Qt::Friday},
-        {"Every Saturday", Qt::Saturday}
-    };
-
-    for (int i = 0; i < alarms.size(); ++i) {
-
-    if (alarms[i].hour() == currentHour && alarms[i].minute() == currentMinute) {
-        QString repeatOption = alarmRepeats[i];
-        QString label = alarmLabels[i];
-        QString sound = alarmSounds[i];
-        bool isSnoozed = alarmIsSnoozed[i];
-
-        // Only check day of week if it's a repeating alarm
-        if (repeatMap.contains(repeatOption) && repeatMap[repeatOption] != today) {
-            continue;  
-        }
+    agendaWindow->show();
+    agendaWindow->raise();
+}
 
-        // Still suppress if dismissed today (one-time suppression)
-        QString uniqueKey = label + "|" + currentDate.toString("yyyy-MM-dd");
-        if (dismissedToday.contains(uniqueKey) && !isSnoozed) continue;
-
-        qDebug() << "[TRIGGER] Alarm triggered:" << label << "| Time:" << alarms[i].toString("HH:mm");
-
-        // Play sound
-        playAlarmSound(sound);
-
-        QMessageBox msgBox;
-        msgBox.setWindowTitle("Alarm Triggered");
-        msgBox.setText(label + " has gone off!");
-        QPushButton *snoozeButton = msgBox.addButton("Snooze", QMessageBox::ActionRole);
-        QPushButton *dismissButton = msgBox.addButton("Dismiss", QMessageBox::RejectRole);
-        msgBox.exec();
-
-        if (msgBox.clickedButton() == snoozeButton) {
-            stopAlarmSound();
-
-            if (alarmRepeats[i] == "Never") {
-                qDebug() << "[SNOOZE] Removing one-time alarm after snooze:" << label;
-
-                // Remove original before snoozing to prevent duplicates
-                alarms.removeAt(i);
-                alarmLabels.removeAt(i);
-                alarmRepeats.removeAt(i);
-                alarmSounds.removeAt(i);
-                alarmIsSnoozed.removeAt(i);
-                originalAlarmTimes.removeAt(i);
-
-                // Clean up label to avoid "(Snoozed) (Snoozed)" stacking
-                if (label.contains(" (Snoozed)")) {
-                    label = label.section(" (Snoozed)", 0, 0);
-                }
-
-                // Then snooze manually (since index i is now invalid)
-                QTime snoozedTime = currentTime.addSecs(300); // 5 minute snooze
-                alarms.append(snoozedTime);
-                alarmLabels.append(label + " (Snoozed)");
-                alarmRepeats.append("Never");
-                alarmSounds.append(sound);
-                alarmIsSnoozed.append(true);
-                originalAlarmTimes.append(originalAlarmTimes[i]);
-                qDebug() << "[SNOOZE] Added new snoozed alarm for" << label << "at" << snoozedTime.toString("HH:mm");
-
-                if (viewAlarmWindow) {
-                    viewAlarmWindow->updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
-                }
-
-            } else {
-                snoozeAlarm(i, 5);
-                QString uniqueKey = label + "|" + currentDate.toString("yyyy-MM-dd");
-                dismissedToday.insert(uniqueKey);
-
-                QString repeatDay = repeatOption;
-                repeatDay.remove("Every ");
-                qDebug() << "[INFO] Original alarm will repeat every"
-                        << repeatDay << "at"
-                        << originalAlarmTimes[i].toString("HH:mm");
-            }
+/**
+ * @brief Opens the World Clock window.
+ * Shows the time in several zones at once.
+ */
+void MainWindow::openWorldClock() {
+    if (!worldClockWindow) {
+        worldClockWindow = new WorldClockPanel(alarmScheduler->clock(), this);
+    }
 
-            return;
-        }
+    worldClockWindow->show();
+    worldClockWindow->raise();
+}
 
+/**
+ * @brief Opens the Timers window.
+ * Countdown timers and the stopwatch keep running while it is closed.
+ */
+void MainWindow::openTimers() {
+    if (!timersWindow) {
+        timersWindow = new TimersPanel(countdownTimers, this);
+    }
 
+    timersWindow->show();
+    timersWindow->raise();
+}
 
-        else if (msgBox.clickedButton() == dismissButton) {
-            stopAlarmSound();
-            qDebug() << "[DISMISS] Alarm dismissed:" << label;
+/**
+ * @brief Rings for a finished countdown timer.
+ *
+ * Timers are often started in batches, so finished timers share one
+ * non-modal message box that lists them all; the sound stops when it is
+ * closed. An alarm that is ringing keeps its own sound.
+ *
+ * @param id The id of the timer.
+ */
+void MainWindow::countdownFinished(quint64 id) {
+    const CountdownTimer *timer = countdownTimers->find(id);
+    if (!timer) return;
+    qDebug() << "[TIMER] Timer finished:" << timer->label;
+    finishedTimers.append(timer->label);
+
+    if (!timerBox) {
+        timerBox = new QMessageBox(QMessageBox::Information, "Timer Finished", QString(), QMessageBox::Ok, this);
+        timerBox->setAttribute(Qt::WA_DeleteOnClose);
+        timerBox->setWindowModality(Qt::NonModal);
+        connect(timerBox, &QMessageBox::finished, this, [this]() {
+            finishedTimers.clear();
+            if (!alarmFiring) stopAlarmSound();
+        });
+        if (!alarmFiring) playAlarmSound("Beep");
+        timerBox->show();
+    }
+    timerBox->setText(finishedTimers.size() == 1 ? finishedTimers.first() + " is done."
+                                                 : "These timers are done:\n" + finishedTimers.join("\n"));
+}
 
-            // Handle non-repeating and repeating alarms only on dismiss
-            if (repeatOption == "Never" || isSnoozed) {
-                alarms.removeAt(i);
-                alarmLabels.removeAt(i);
-                alarmRepeats.removeAt(i);
-                alarmSounds.removeAt(i);
-                alarmIsSnoozed.removeAt(i);
-            } else {
-                dismissedToday.insert(uniqueKey);
+namespace {
 
-                if (repeatMap.contains(repeatOption)) {
-                    QDate nextDate = currentDate.addDays(7);
-                    QDateTime nextAlarmDateTime(nextDate, alarms[i]);
-                    qDebug() << "[DEBUG] Dismissed repeat alarm:" << label
-                            << "— next scheduled for" << nextAlarmDateTime.toString();
-                }
+/**
+ * @brief Parses a timer length: plain seconds, "mm:ss" or "h:mm:ss".
+ * @return The length in ms, or 0 if the text is not a positive length.
+ */
+qint64 parseTimerLength(const QString &text) {
+    qint64 seconds = 0;
+    const QStringList parts = text.split(':');
+    if (parts.size() > 3) return 0;
+    for (const QString &part : parts) {
+        bool ok = false;
+        const int value = part.toInt(&ok);
+        if (!ok || value < 0) return 0;
+        seconds = seconds * 60 + value;
+    }
+    return seconds * 1000;
+}
 
-            }
-            
+} // namespace
 
-            if (viewAlarmWindow) {
-                viewAlarmWindow->updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
+/**
+ * @brief Runs a command forwarded by a later launch (or given to this one).
+ *
+ * The command only touches the alarm store, the timers and the windows, so
+ * a scripted launch never waits for more than the reply.
+ */
+bool MainWindow::handleCommand(const QStringList &command, QString *reply) {
+    const QString name = command.value(0, "show").toLower();
+
+    if (name == "show") {
+        showNormal();
+        raise();
+        activateWindow();
+        *reply = "Shown";
+        return true;
+    }
+    if (name == "alarms" || name == "agenda" || name == "timers") {
+        if (name == "alarms") openViewAlarms();
+        else if (name == "agenda") openAgenda();
+        else openTimers();
+        *reply = "Opened " + name;
+        return true;
+    }
+    if (name == "list") {
+        const AlarmServiceSnapshot snapshot = alarmService->snapshot();
+        QStringList lines;
+        for (const Alarm &alarm : snapshot.alarms()) {
+            const QDateTime next = snapshot.nextFire(alarm.id);
+            QString line = QString("%1  %2  %3  (next: %4)")
+                    .arg(alarm.time.toString("HH:mm:ss"), alarm.repeat, alarm.displayLabel(),
+                         !alarm.enabled ? QString("off") : next.isValid() ? next.toString("ddd dd MMM HH:mm:ss") : QString("never"));
+            if (!alarm.group.isEmpty()) line += "  [" + alarm.group.toString() + "]";
+            lines.append(line);
+        }
+        *reply = lines.isEmpty() ? QString("No alarms") : lines.join("\n");
+        return true;
+    }
+    if (name == "add") {
+        const QString timeText = command.value(1);
+        const QTime time = QTime::fromString(timeText, timeText.count(':') == 2 ? "HH:mm:ss" : "HH:mm");
+        const QString repeat = command.value(3, "Never");
+        if (!time.isValid() || (repeat != "Never" && AlarmScheduler::weeklyDay(repeat) == 0)) {
+            *reply = "Usage: add HH:mm[:ss] [label] [Never|\"Every Monday\"|...] [sound] [group]";
+            return false;
+        }
+        const QString label = command.value(2, "Alarm");
+        if (!alarmScheduler->addAlarm(time, repeat, label, command.value(4, "Classic"), QString(), command.value(5))) {
+            *reply = QString("Only %1 alarms can be stored on this device").arg(alarmScheduler->maxAlarms());
+            return false;
+        }
+        *reply = QString("Alarm \"%1\" set for %2").arg(label, time.toString("HH:mm:ss"));
+        return true;
+    }
+    if (name == "groups") {
+        const AlarmStore *store = alarmScheduler->store();
+        QStringList lines;
+        for (const QString &group : store->groupNames()) {
+            const QSet<quint64> members = store->groupMembers(group);
+            int enabled = 0;
+            for (quint64 id : members) {
+                if (store->find(id)->enabled) ++enabled;
             }
-
-            continue; 
+            lines.append(QString("%1  (%2 of %3 enabled)").arg(group).arg(enabled).arg(members.size()));
         }
-
+        *reply = lines.isEmpty() ? QString("No groups") : lines.join("\n");
+        return true;
     }
+    if (name == "enable" || name == "disable") {
+        const QString group = command.mid(1).join(' ').trimmed();
+        if (group.isEmpty() || alarmScheduler->store()->groupMembers(group).isEmpty()) {
+            *reply = group.isEmpty() ? "Usage: " + name + " <group>" : "No group \"" + group + "\"";
+            return false;
+        }
+        const int changed = alarmScheduler->store()->setGroupEnabled(group, name == "enable");
+        *reply = QString("%1 %2 alarms of \"%3\"").arg(name == "enable" ? "Enabled" : "Disabled").arg(changed).arg(group);
+        return true;
     }
+    if (name == "profiles") {
+        QStringList lines;
+        for (const QString &profile : alarmProfiles->names()) {
+            const QDateTime next = alarmProfiles->nextDeadline(profile);
+            lines.append(QString("%1%2  (%3, next: %4)")
+                         .arg(QString(profile == alarmProfiles->activeName() ? "* " : "  "), profile,
+                              QString(alarmProfiles->isLoaded(profile) ? "loaded" : "not loaded"),
+                              next.isValid() ? next.toString("ddd dd MMM HH:mm:ss") : QString("never")));
+        }
+        QString first;
+        const QDateTime next = alarmProfiles->nextDeadline(&first);
+        lines.append(next.isValid() ? QString("Next alarm: %1 (%2)").arg(next.toString("ddd dd MMM HH:mm:ss"), first)
+                                    : QString("No alarm will ring"));
+        *reply = lines.join("\n");
+        return true;
+    }
+    if (name == "profile") {
+        const QString profile = command.mid(1).join(' ').trimmed();
+        if (!alarmProfiles->setActive(profile)) {
+            *reply = profile.isEmpty() ? QString("Usage: profile <name>")
+                                       : "Invalid profile name \"" + profile + "\" (letters, digits, spaces, '_' or '-')";
+            return false;
+        }
+        *reply = QString("Profile \"%1\" is active").arg(profile);
+        return true;
+    }
+    if (name == "timer") {
+        const qint64 length = parseTimerLength(command.value(1));
+        const QString label = command.value(2, QString("Timer %1").arg(countdownTimers->timers().size() + 1));
+        const quint64 id = countdownTimers->add(label, length);
+        if (id == 0) {
+            *reply = "Usage: timer <seconds|mm:ss|h:mm:ss> [label]";
+            return false;
+        }
+        countdownTimers->start(id);
+        *reply = QString("Timer \"%1\" started").arg(label);
+        return true;
+    }
+
+    *reply = "Unknown command \"" + command.value(0) + "\" (show, alarms, agenda, timers, list, add, groups, enable, disable, profiles, profile, timer)";
+    return false;
+}
+
+/**
+ * @brief Shows or hides the profiler overlay.
+ *
+ * The overlay lists the time spent in the hot slots and the event-loop
+ * stalls recorded by the watchdog set with setStallWatchdog().
+ */
+void MainWindow::toggleProfilerOverlay() {
+    if (!profilerOverlay) {
+        profilerOverlay = new ProfilerOverlay(stallWatchdog, alarmScheduler, this);
+    }
+    profilerOverlay->setVisible(!profilerOverlay->isVisible());
 }
 
 
 /**
- * @brief Snoozes an alarm for a given number of minutes.
- * 
- * Moves the alarm forward by the specified number of minutes and updates the alarm list.
- * 
- * @param index The index of the alarm to snooze.
- * @param minutes The number of minutes to snooze for.
+ * @brief Checks if any alarms match the current time and triggers an alert.
+ *
+ * All alarms due at the same instant are fired together as one event: one
+ * sound, one message box listing every alarm, and a single snooze or dismiss
+ * applied to the whole batch so the alarm list is updated only once. Every
+ * loaded profile is checked, whichever one is shown; profiles that will ring
+ * soon are loaded first.
  */
 
-void MainWindow::snoozeAlarm(int index, int minutes) {
-    QString baseLabel = alarmLabels[index];
-    if (baseLabel.contains(" (Snoozed)")) {
-        baseLabel = baseLabel.section(" (Snoozed)", 0, 0);
-    }
+void MainWindow::checkAlarms() {
+    RISE_PROFILE_SLOT("MainWindow::checkAlarms");
 
-    // Remove all existing snoozed versions of this alarm
-    for (int i = alarms.size() - 1; i >= 0; --i) {
-        QString currentLabel = alarmLabels[i];
-        if (currentLabel.startsWith(baseLabel) && alarmIsSnoozed[i]) {
-            qDebug() << "[SNOOZE] Removing old snoozed alarm:" << currentLabel;
-            alarms.removeAt(i);
-            alarmLabels.removeAt(i);
-            alarmRepeats.removeAt(i);
-            alarmSounds.removeAt(i);
-            alarmIsSnoozed.removeAt(i);
-            originalAlarmTimes.removeAt(i); 
-        }
-    }
+    // Re-arm first so the next second is checked on time even while a message box is open
+    const QDateTime now = alarmScheduler->clock()->currentDateTime();
+    alarmCheckTimer->start(1000 - now.time().msec() + 1);
+
+    // The message box runs a nested event loop; don't stack another one on top
+    if (alarmFiring) return;
 
-    // Add the new snoozed alarm
-    QTime snoozedTime = QTime::currentTime().addSecs(minutes * 60);
+    // Each profile's shard has its own wheel; the batch is kept per shard for the snooze or dismiss
+    const int dueCount = dueBatch.collect(*alarmProfiles, now);
+    if (!dueCount) return;
+    qDebug() << "[TRIGGER]" << dueCount << "alarm(s) triggered at" << now.toString("HH:mm:ss");
 
-    alarms.append(snoozedTime);
-    alarmLabels.append(baseLabel + " (Snoozed)");
-    alarmRepeats.append(alarmRepeats[index]);
-    alarmSounds.append(alarmSounds[index]);
-    alarmIsSnoozed.append(true);
-    originalAlarmTimes.append(originalAlarmTimes[index]); 
+    alarmFiring = true;
 
-    qDebug() << "[SNOOZE] Added new snoozed alarm for" << baseLabel << "at" << snoozedTime.toString("HH:mm");
+    // Play one sound for the whole batch
+    if (const Alarm *first = dueBatch.first()) playAlarmSound(first->sound);
 
-    if (viewAlarmWindow) {
-        viewAlarmWindow->updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
+    // The box and its buttons are kept between firings; only the texts change
+    if (!alarmBox) {
+        alarmBox = new QMessageBox(this);
+        alarmBox->setWindowTitle("Alarm Triggered");
+        alarmSnoozeButton = alarmBox->addButton("Snooze", QMessageBox::ActionRole);
+        alarmDismissButton = alarmBox->addButton("Dismiss", QMessageBox::RejectRole);
     }
-    // Show [INFO] about the original repeat time if it's a repeating alarm
-    QString repeatOption = alarmRepeats[index];
-    if (repeatOption != "Never" && repeatOption.startsWith("Every ")) {
-        QString repeatDay = repeatOption;
-        repeatDay.remove("Every ");
-        qDebug() << "[INFO] Original alarm will repeat every"
-                << repeatDay << "at"
-                << originalAlarmTimes[index].toString("HH:mm");
+    alarmSnoozeButton->setText(dueCount == 1 ? "Snooze" : "Snooze All");
+    alarmDismissButton->setText(dueCount == 1 ? "Dismiss" : "Dismiss All");
+    alarmBox->setText(dueBatch.message());
+    alarmBox->setDetailedText(dueBatch.details());
+    alarmBox->exec();
+    // Hand the texts back so the next firing reuses the batch's buffers instead of copying them
+    alarmBox->setText(QString());
+    alarmBox->setDetailedText(QString());
+
+    stopAlarmSound();
+    for (const FireBatch::Part &part : dueBatch) {
+        if (alarmBox->clickedButton() == alarmSnoozeButton) {
+            part.scheduler->snoozeAll(part.ids, 5);
+        } else if (alarmBox->clickedButton() == alarmDismissButton) {
+            part.scheduler->dismissAll(part.ids);
+        }
     }
+
+    alarmFiring = false;
 }
 
-/**  
+
+/**
  * @brief Plays the alarm sound based on the provided sound name.
- * 
- * This function selects an appropriate sound file based on the given sound name 
- * and plays it in an infinite loop. If no sound is specified or an unrecognized 
- * sound name is provided, no sound will be played.
- * 
- * @param soundName The name of the alarm sound to play. Possible values are: "Classic", "Beep", and "Rooster".
+ *
+ * The sound is taken from the sound library, which decoded it in the
+ * background beforehand, and played in an infinite loop. Long tracks are
+ * streamed from their file instead, from the library's start offset and
+ * with its fade-in. The audio output and the looping device are reused from
+ * the previous alarm as long as the sample format is the same. If the sound
+ * is not (or not yet) decoded, no sound will be played.
+ *
+ * @param soundName The name of the alarm sound to play ("Classic", "Beep", "Rooster" or a user sound).
  */
 
 void MainWindow::playAlarmSound(const QString &soundName) {
-    QString soundPath;
-
-     // Determine the file path based on the provided sound name
-    if (soundName == "Classic") {
-        soundPath = "sounds/ring1.wav";
-    } else if (soundName == "Beep") {
-        soundPath = "sounds/ring2.wav";
-    } else if (soundName == "Rooster") {
-        soundPath = "sounds/ring3.wav";
-    }
-
     stopAlarmSound();
 
-    // Create a new QSound instance with the selected sound path
-    alarmPlayer = new QSound(soundPath, this);
+    const std::shared_ptr<const DecodedSound> sound = soundLibrary->sound(soundName);
+    if (!sound) {
+        qWarning() << "[SOUND] No decoded sound named" << soundName;
+        return;
+    }
+
+    QIODevice *device;
+    if (sound->isStreamed()) {
+        alarmTrack = new StreamingSoundDevice(sound, soundLibrary->trackStartMs(), soundLibrary->trackFadeInMs(), this);
+        if (!alarmTrack->open(QIODevice::ReadOnly)) {
+            delete alarmTrack;
+            alarmTrack = nullptr;
+            return;
+        }
+        device = alarmTrack;
+    } else {
+        if (!alarmStream) {
+            alarmStream = new LoopingSoundDevice(nullptr, this);
+            alarmStream->open(QIODevice::ReadOnly);
+        }
+        alarmStream->setSound(sound);
+        device = alarmStream;
+    }
 
-    alarmPlayer->setLoops(QSound::Infinite);  
-    alarmPlayer->play();
+    if (alarmOutput && alarmOutput->format() != sound->format) {
+        delete alarmOutput;
+        alarmOutput = nullptr;
+    }
+    if (!alarmOutput) alarmOutput = new QAudioOutput(sound->format, this);
+    alarmOutput->start(device);
 }
 
 /**
  * @brief Stops the currently playing alarm sound.
  * 
- * This function stops the alarm sound, deletes the sound player instance, 
- * and sets the player pointer to nullptr to release resources.
+ * This function stops the audio output and lets the looping device release
+ * the samples; both are kept for the next alarm. A streamed track's device
+ * is deleted, which closes its file.
  */
 
 void MainWindow::stopAlarmSound() {
 
-    if (alarmPlayer) {
-        alarmPlayer->stop();
-        delete alarmPlayer;
-        alarmPlayer = nullptr;
-    }
+    if (alarmOutput) alarmOutput->stop();
+    if (alarmStream) alarmStream->setSound(nullptr);
+    delete alarmTrack;
+    alarmTrack = nullptr;
 }
@@ -0,0 +1,89 @@
+/**
+ * @file memoryusage.cpp
+ * @brief Implementation of the memory footprint helpers.
+ *
+ * The RSS is read from /proc/self/statm on Linux and from the Mach task
+ * info on macOS. Open file descriptors are listed in /proc/self/fd on Linux
+ * and /dev/fd on macOS.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "memoryusage.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#endif
+
+/**
+ * @brief Reads the resident set size of this process.
+ * @return The RSS in kilobytes, or -1 on unsupported platforms.
+ */
+qint64 MemoryUsage::residentKb() {
+#if defined(Q_OS_LINUX)
+    // statm holds "size resident shared ..." in pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) return -1;
+    return fields[1].toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    return qint64(info.resident_size / 1024);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Counts the entries of the per-process descriptor directory.
+ * @return The number of open descriptors, or -1 on unsupported platforms.
+ */
+int MemoryUsage::openFileDescriptors() {
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#if defined(Q_OS_LINUX)
+    const QDir fds("/proc/self/fd");
+#else
+    const QDir fds("/dev/fd");
+#endif
+    if (!fds.exists()) return -1;
+    // Listing the directory opens one descriptor of its own
+    return qMax(0, fds.entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).size() - 1);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Constructs the reporter and starts its timer.
+ * @param intervalMs Milliseconds between samples.
+ * @param log True to print each sample.
+ * @param parent The parent object.
+ */
+RssReporter::RssReporter(int intervalMs, bool log, QObject *parent)
+    : QObject(parent), logSamples(log) {
+    connect(&timer, &QTimer::timeout, this, &RssReporter::sample);
+    timer.start(intervalMs);
+}
+
+/**
+ * @brief Samples the RSS, updates the peak and optionally logs it.
+ */
+void RssReporter::sample() {
+    last = MemoryUsage::residentKb();
+    peak = qMax(peak, last);
+    if (logSamples) {
+        qInfo() << "[MEMORY] RSS" << last << "KB | peak" << peak << "KB";
+    }
+    emit sampled(last);
+}
@@ -0,0 +1,428 @@
+/**
+ * @file nextfireindex.cpp
+ * @brief Implementation file for the NextFireIndex class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "nextfireindex.h"
+#include "alarmscheduler.h"
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+/**
+ * @brief Julian day of 1970-01-01.
+ */
+const qint64 epochJulianDay = 2440588;
+
+/**
+ * @brief How far ahead an occurrence is searched for (53 weeks).
+ *
+ * An alarm whose holiday calendar excludes every candidate day in this
+ * window is reported as never ringing again.
+ */
+const qint64 searchDays = 7 * 53;
+
+/**
+ * @brief Smallest number of alarms given to one worker.
+ */
+const int minChunkSize = 16384;
+
+} // namespace
+
+/**
+ * @brief State of a running bulk recompute.
+ *
+ * Workers only read inputs and rules and write to disjoint ranges of ids
+ * and fireAt, so they need no locking. The inputs are copied from the
+ * store when the job starts; the job holds no snapshot, so the store can
+ * change while it runs without copying its list.
+ */
+struct NextFireIndex::Job {
+    /**
+     * @brief A range of the inputs handled by one worker.
+     */
+    struct Chunk {
+        int begin;        ///< First index.
+        int end;          ///< One past the last index.
+        qint64 earliest;  ///< Smallest result in the range.
+        quint64 earliestId; ///< Alarm with the smallest result.
+    };
+
+    quint64 version = 0;     ///< Store version the inputs were copied at.
+    QVector<FireInput> inputs; ///< Alarms being computed.
+    Rules rules;             ///< Private copy of the rules.
+    QVector<Chunk> chunks;   ///< Work items.
+    QVector<quint64> ids;    ///< Result ids.
+    QVector<qint64> fireAt;  ///< Result instants.
+    QElapsedTimer timer;     ///< Started when the job was created.
+};
+
+/**
+ * @brief Binary search over the ascending ids.
+ */
+qint64 NextFireTable::fireAtOf(quint64 id) const {
+    const auto it = std::lower_bound(ids.constBegin(), ids.constEnd(), id);
+    if (it == ids.constEnd() || *it != id) return NoFire;
+    return fireAt[int(it - ids.constBegin())];
+}
+
+/**
+ * @brief Constructs the index with an empty table.
+ * @param store The alarms.
+ * @param calendars Holiday calendars the alarms can refer to.
+ * @param clock Defines the current time.
+ * @param parent The parent object.
+ */
+NextFireIndex::NextFireIndex(AlarmStore *store, HolidayCalendars *calendars, ClockSource *clock, QObject *parent)
+    : QObject(parent), alarmStore(store), holidayCalendars(calendars),
+      clockSource(clock ? clock : ClockSource::system()), zone(QTimeZone::systemTimeZone()),
+      current(std::make_shared<const NextFireTable>()) {
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(0);
+    connect(&flushTimer, &QTimer::timeout, this, &NextFireIndex::flush);
+    connect(&jobWatcher, &QFutureWatcher<void>::finished, this, &NextFireIndex::finishRecompute);
+    connect(alarmStore, &AlarmStore::changed, this, &NextFireIndex::onStoreChanged);
+    if (holidayCalendars) {
+        connect(holidayCalendars, &HolidayCalendars::changed, this, [this]() {
+            rulesValid = false;
+            recompute();
+        });
+    }
+}
+
+/**
+ * @brief Lets a running recompute finish; its workers read the job's inputs.
+ */
+NextFireIndex::~NextFireIndex() {
+    jobWatcher.waitForFinished();
+}
+
+/**
+ * @brief Loads the published table.
+ */
+std::shared_ptr<const NextFireTable> NextFireIndex::table() const {
+    return std::atomic_load(&current);
+}
+
+/**
+ * @brief Looks up an alarm in the published table.
+ */
+QDateTime NextFireIndex::nextFire(quint64 id) const {
+    const qint64 at = table()->fireAtOf(id);
+    return at == NextFireTable::NoFire ? QDateTime() : QDateTime::fromMSecsSinceEpoch(at, zone);
+}
+
+/**
+ * @brief Returns the earliest entry of the published table.
+ */
+QDateTime NextFireIndex::nextDeadline() const {
+    const qint64 at = table()->earliest;
+    return at == NextFireTable::NoFire ? QDateTime() : QDateTime::fromMSecsSinceEpoch(at, zone);
+}
+
+/**
+ * @brief Switches to another zone; every entry depends on it.
+ */
+void NextFireIndex::setTimeZone(const QTimeZone &timeZone) {
+    if (timeZone == zone) return;
+    zone = timeZone;
+    rulesValid = false;
+    recompute();
+}
+
+/**
+ * @brief Queues the fired alarms for a lookup of their following occurrence.
+ */
+void NextFireIndex::markFired(const QVector<quint64> &ids) {
+    dirtyIds.append(ids);
+    dirty = true;
+    if (!flushTimer.isActive()) flushTimer.start();
+}
+
+/**
+ * @brief Queues added and updated alarms; removed ones drop out when the table is patched.
+ */
+void NextFireIndex::onStoreChanged(quint64, quint64, const QVector<AlarmChange> &changes) {
+    for (const AlarmChange &change : changes) {
+        if (change.kind != AlarmChange::Removed) dirtyIds.append(change.id);
+    }
+    dirty = true;
+    if (!flushTimer.isActive()) flushTimer.start();
+}
+
+/**
+ * @brief Builds a new table from the published one, recomputing only the queued alarms.
+ *
+ * Store ids are handed out in ascending order and never reordered, so the
+ * old and new id lists (and the sorted queue) are merged in one pass.
+ * While a bulk recompute is running the queue is kept for when it finishes.
+ */
+void NextFireIndex::flush() {
+    flushTimer.stop();
+    if (!dirty || job) return;
+
+    const std::shared_ptr<const NextFireTable> old = table();
+    const AlarmSnapshot snapshot = alarmStore->snapshot();
+    const QVector<Alarm> &alarms = snapshot.alarms();
+    const Rules &r = currentRules();
+
+    QVector<quint64> queued;
+    queued.swap(dirtyIds);
+    std::sort(queued.begin(), queued.end());
+    queued.erase(std::unique(queued.begin(), queued.end()), queued.end());
+    dirty = false;
+
+    auto next = std::make_shared<NextFireTable>();
+    next->version = snapshot.version();
+    if (old->version == snapshot.version()) {
+        // Only fired alarms: same ids, patch a copy of the instants in place
+        next->ids = old->ids;
+        next->fireAt = old->fireAt;
+        for (quint64 id : queued) {
+            const auto it = std::lower_bound(next->ids.constBegin(), next->ids.constEnd(), id);
+            if (it == next->ids.constEnd() || *it != id) continue;
+            next->fireAt[int(it - next->ids.constBegin())] = r.fireAt(alarms[snapshot.indexOf(id)]);
+        }
+    } else {
+        next->ids.resize(alarms.size());
+        next->fireAt.resize(alarms.size());
+        int oldIndex = 0;
+        int queuedIndex = 0;
+        for (int i = 0; i < alarms.size(); ++i) {
+            const quint64 id = alarms[i].id;
+            while (oldIndex < old->ids.size() && old->ids[oldIndex] < id) ++oldIndex;
+            while (queuedIndex < queued.size() && queued[queuedIndex] < id) ++queuedIndex;
+
+            const bool known = oldIndex < old->ids.size() && old->ids[oldIndex] == id;
+            const bool changed = queuedIndex < queued.size() && queued[queuedIndex] == id;
+            next->ids[i] = id;
+            next->fireAt[i] = known && !changed ? old->fireAt[oldIndex] : r.fireAt(alarms[i]);
+        }
+    }
+    const auto earliest = std::min_element(next->fireAt.constBegin(), next->fireAt.constEnd());
+    if (earliest != next->fireAt.constEnd() && *earliest != NextFireTable::NoFire) {
+        next->earliest = *earliest;
+        next->earliestId = next->ids[int(earliest - next->fireAt.constBegin())];
+    }
+
+    // Hand the buffer back so queueing the next fires does not allocate
+    queued.clear();
+    dirtyIds.swap(queued);
+    publish(std::move(next));
+}
+
+/**
+ * @brief Splits the store into chunks and computes them on the global thread pool.
+ */
+void NextFireIndex::recompute() {
+    if (job) {
+        recomputeAgain = true;
+        return;
+    }
+
+    job = std::make_shared<Job>();
+    job->timer.start();
+    job->version = alarmStore->version();
+    const QVector<Alarm> &alarms = alarmStore->alarms();
+    job->inputs.reserve(alarms.size());
+    for (const Alarm &alarm : alarms) {
+        job->inputs.append(FireInput::of(alarm));
+    }
+    job->rules = currentRules();
+
+    // Everything queued so far is covered by the copied inputs
+    dirtyIds.clear();
+    dirty = false;
+    flushTimer.stop();
+
+    const int count = job->inputs.size();
+    job->ids.resize(count);
+    job->fireAt.resize(count);
+    const int chunkCount = qBound(1, count / minChunkSize, QThread::idealThreadCount() * 4);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        job->chunks.append({int(qint64(count) * chunk / chunkCount), int(qint64(count) * (chunk + 1) / chunkCount),
+                            NextFireTable::NoFire, 0});
+    }
+
+    const FireInput *inputs = job->inputs.constData();
+    quint64 *ids = job->ids.data();
+    qint64 *fireAt = job->fireAt.data();
+    const Rules *rules = &job->rules;
+    jobWatcher.setFuture(QtConcurrent::map(job->chunks, [inputs, ids, fireAt, rules](Job::Chunk &chunk) {
+        qint64 earliest = NextFireTable::NoFire;
+        quint64 earliestId = 0;
+        for (int i = chunk.begin; i < chunk.end; ++i) {
+            ids[i] = inputs[i].id;
+            fireAt[i] = rules->fireAt(inputs[i]);
+            if (fireAt[i] < earliest) {
+                earliest = fireAt[i];
+                earliestId = ids[i];
+            }
+        }
+        chunk.earliest = earliest;
+        chunk.earliestId = earliestId;
+    }));
+}
+
+/**
+ * @brief Runs a bulk recompute and waits for it to be published.
+ */
+void NextFireIndex::recomputeNow() {
+    recompute();
+    while (job) {
+        jobWatcher.waitForFinished();
+        finishRecompute();
+    }
+}
+
+/**
+ * @brief Waits for a running recompute and patches in everything queued.
+ */
+void NextFireIndex::sync() {
+    while (job) {
+        jobWatcher.waitForFinished();
+        finishRecompute();
+    }
+    flush();
+}
+
+/**
+ * @brief Publishes the finished job and catches up with changes made while it ran.
+ */
+void NextFireIndex::finishRecompute() {
+    // recomputeNow() may already have published this job before the queued signal arrives
+    if (!job || !jobWatcher.isFinished()) return;
+
+    auto next = std::make_shared<NextFireTable>();
+    next->version = job->version;
+    next->ids = std::move(job->ids);
+    next->fireAt = std::move(job->fireAt);
+    for (const Job::Chunk &chunk : job->chunks) {
+        if (chunk.earliest < next->earliest) {
+            next->earliest = chunk.earliest;
+            next->earliestId = chunk.earliestId;
+        }
+    }
+    const int count = next->ids.size();
+    const qint64 elapsedMs = job->timer.elapsed();
+    job.reset();
+
+    publish(std::move(next));
+    qDebug() << "[NEXTFIRE] Recomputed" << count << "alarms in" << elapsedMs << "ms";
+    emit recomputed(count, elapsedMs);
+
+    if (recomputeAgain) {
+        recomputeAgain = false;
+        recompute();
+    } else if (dirty) {
+        flush();
+    }
+}
+
+/**
+ * @brief Replaces the published table.
+ */
+void NextFireIndex::publish(std::shared_ptr<const NextFireTable> next) {
+    std::atomic_store(&current, std::move(next));
+    emit tableChanged();
+}
+
+/**
+ * @brief Returns the rules starting at the second after now.
+ */
+const NextFireIndex::Rules &NextFireIndex::currentRules() {
+    const QDateTime start = clockSource->currentDateTimeUtc().toTimeZone(zone).addSecs(1);
+    const qint64 day = start.date().toJulianDay();
+    rules.fromSecond = start.time().msecsSinceStartOfDay() / 1000;
+    if (rulesValid && day == rules.fromDay) return rules;
+
+    rules.zone = zone;
+    rules.fromDay = day;
+
+    // One offset per day covers every second except those of days with a transition
+    const int days = int(searchDays) + 9;
+    QVector<int> offsets(days + 1);
+    for (int i = 0; i <= days; ++i) {
+        offsets[i] = QDateTime(QDate::fromJulianDay(day + i), QTime(0, 0), zone).offsetFromUtc();
+    }
+    rules.midnightOffsets = offsets.mid(0, days);
+    rules.transitionDays = QVector<bool>(days, false);
+    for (int i = 0; i < days; ++i) {
+        // A transition at midnight makes the midnight offset itself unreliable, so flag both days
+        if (offsets[i] != offsets[i + 1]) {
+            rules.transitionDays[i] = true;
+            if (i + 1 < days) rules.transitionDays[i + 1] = true;
+        }
+    }
+
+    rules.calendars.clear();
+    if (holidayCalendars) {
+        for (const QString &name : holidayCalendars->names()) {
+            rules.calendars.insert(name, *holidayCalendars->calendar(name));
+        }
+    }
+    rulesValid = true;
+    return rules;
+}
+
+/**
+ * @brief Copies the id and the fields the next fire instant depends on.
+ */
+NextFireIndex::FireInput NextFireIndex::FireInput::of(const Alarm &alarm) {
+    FireInput input;
+    input.id = alarm.id;
+    input.time = alarm.time;
+    input.repeat = alarm.repeat;
+    input.calendar = alarm.calendar;
+    input.enabled = alarm.enabled;
+    input.snoozed = alarm.snoozed;
+    return input;
+}
+
+/**
+ * @brief Finds the first day, from fromDay/fromSecond on, on which the alarm rings.
+ *
+ * Weekly alarms step a week at a time from their weekday; every other alarm
+ * rings daily, like the timing wheel re-arms it. Days excluded by the
+ * alarm's holiday calendar are skipped unless the alarm is a snoozed copy.
+ */
+qint64 NextFireIndex::Rules::fireAt(const FireInput &alarm) const {
+    if (!alarm.enabled) return NextFireTable::NoFire;
+    const int second = alarm.time.msecsSinceStartOfDay() / 1000;
+
+    const HolidayCalendar *calendar = nullptr;
+    if (!alarm.snoozed && !alarm.calendar.isEmpty()) {
+        const auto it = calendars.constFind(alarm.calendar);
+        if (it != calendars.constEnd() && !it->isEmpty()) calendar = &*it;
+    }
+
+    qint64 day = fromDay + (second < fromSecond ? 1 : 0);
+    int step = 1;
+    if (const int weekday = AlarmScheduler::weeklyDay(alarm.repeat)) {
+        day += (weekday - int(day % 7) - 1 + 7) % 7; // Julian days divisible by 7 are Mondays
+        step = 7;
+    }
+
+    for (const qint64 last = fromDay + searchDays; day <= last; day += step) {
+        if (!calendar || !calendar->contains(QDate::fromJulianDay(day))) return toUtc(day, second);
+    }
+    return NextFireTable::NoFire;
+}
+
+/**
+ * @brief Converts with the day's midnight offset, or asks the zone on transition days.
+ */
+qint64 NextFireIndex::Rules::toUtc(qint64 day, int second) const {
+    const qint64 index = day - fromDay;
+    if (index >= 0 && index < midnightOffsets.size() && !transitionDays[int(index)]) {
+        return ((day - epochJulianDay) * 86400 + second - midnightOffsets[int(index)]) * 1000;
+    }
+    return QDateTime(QDate::fromJulianDay(day), QTime::fromMSecsSinceStartOfDay(second * 1000), zone).toMSecsSinceEpoch();
+}
@@ -0,0 +1,372 @@
+/**
+ * @file occurrencecache.cpp
+ * @brief Implementation file for the OccurrenceCache class.
+ *
+ * Both pattern tables and every expanded day are kept sorted by (minute,
+ * id), so a window or time-of-day filter is a binary search followed by a
+ * contiguous copy.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "occurrencecache.h"
+#include "alarmscheduler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+/**
+ * @brief Minutes in a day.
+ */
+const int minutesPerDay = 24 * 60;
+
+/**
+ * @brief Rounds a division towards minus infinity.
+ */
+qint64 floorDiv(qint64 value, qint64 divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+/**
+ * @brief Returns the minute of the day of a time.
+ */
+int minuteOfDay(const QTime &time) {
+    return time.hour() * 60 + time.minute();
+}
+
+/**
+ * @brief Orders occurrences by time, then by alarm id.
+ */
+bool occursBefore(const Occurrence &a, const Occurrence &b) {
+    return a.minute < b.minute || (a.minute == b.minute && a.alarmId < b.alarmId);
+}
+
+/**
+ * @brief Orders pattern entries by minute, then by alarm id.
+ */
+template <typename Entry>
+bool entryBefore(const Entry &a, const Entry &b) {
+    return a.minute < b.minute || (a.minute == b.minute && a.id < b.id);
+}
+
+/**
+ * @brief Share of the indexed alarms a batch may move before the tables are rebuilt instead.
+ *
+ * Each moved alarm shifts the sorted tables, so moving thousands of alarms
+ * one by one costs more than sorting once. Switching alarms on or off moves
+ * nothing.
+ */
+const int rebuildDivisor = 8;
+
+/**
+ * @brief Returns the table key of an alarm: minute of the week (>= 0), or -1 - minute of the day.
+ */
+int patternMinute(const Alarm &alarm) {
+    const int day = AlarmScheduler::weeklyDay(alarm.repeat);
+    return day ? (day - 1) * minutesPerDay + minuteOfDay(alarm.time) : -1 - minuteOfDay(alarm.time);
+}
+
+} // namespace
+
+/**
+ * @brief Converts the occurrence minute to local time.
+ */
+QDateTime Occurrence::dateTime() const {
+    return AlarmScheduler::fromWheelMinute(minute);
+}
+
+/**
+ * @brief Constructs the cache; the tables are built on the first query.
+ * @param store The store whose alarms are projected.
+ * @param clock Clock used to place one-time alarms.
+ * @param parent The parent object.
+ */
+OccurrenceCache::OccurrenceCache(AlarmStore *store, ClockSource *clock, QObject *parent)
+    : QObject(parent), alarmStore(store), clockSource(clock ? clock : ClockSource::system()) {
+    connect(alarmStore, &AlarmStore::changed, this, &OccurrenceCache::onStoreChanged);
+}
+
+/**
+ * @brief Uses the given calendars; expanded days are dropped whenever they change.
+ */
+void OccurrenceCache::setCalendars(HolidayCalendars *calendars) {
+    if (holidays) disconnect(holidays, nullptr, this, nullptr);
+    holidays = calendars;
+    if (holidays) {
+        connect(holidays, &HolidayCalendars::changed, this, [this]() { dayCache.clear(); });
+    }
+    dayCache.clear();
+}
+
+/**
+ * @brief Returns every occurrence in a window.
+ */
+QVector<Occurrence> OccurrenceCache::occurrences(const QDateTime &from, const QDateTime &to) {
+    return query(AlarmScheduler::wheelMinute(from), AlarmScheduler::wheelMinute(to), {{0, minutesPerDay}});
+}
+
+/**
+ * @brief Returns the occurrences in a window that fall within a time of day range.
+ */
+QVector<Occurrence> OccurrenceCache::occurrences(const QDateTime &from, const QDateTime &to, const QTime &dayStart, const QTime &dayEnd) {
+    const int begin = minuteOfDay(dayStart);
+    const int end = minuteOfDay(dayEnd);
+    QVector<DayRange> ranges;
+    if (begin < end) {
+        ranges.append({begin, end});
+    } else {
+        ranges.append({0, end});
+        ranges.append({begin, minutesPerDay});
+    }
+    return query(AlarmScheduler::wheelMinute(from), AlarmScheduler::wheelMinute(to), ranges);
+}
+
+/**
+ * @brief Forgets everything; the next query rebuilds from the store.
+ */
+void OccurrenceCache::clear() {
+    weekly.clear();
+    oneTime.clear();
+    patternKeys.clear();
+    disabledIds.clear();
+    dayCache.clear();
+    built = false;
+}
+
+/**
+ * @brief Collects the occurrences in [fromMinute, toMinute) within the given ranges of the day.
+ *
+ * @param ranges Sorted, non-overlapping ranges of minutes of the day.
+ */
+QVector<Occurrence> OccurrenceCache::query(qint64 fromMinute, qint64 toMinute, const QVector<DayRange> &ranges) {
+    QVector<Occurrence> result;
+    if (toMinute <= fromMinute) return result;
+    if (!built) build();
+
+    const qint64 firstDay = floorDiv(fromMinute, minutesPerDay);
+    const qint64 lastDay = floorDiv(toMinute - 1, minutesPerDay);
+
+    // Weekly alarms, day by day from the expanded cache
+    for (qint64 day = firstDay; day <= lastDay; ++day) {
+        const QVector<Occurrence> &occurrences = expandDay(day);
+        const qint64 dayStart = day * minutesPerDay;
+        for (const DayRange &range : ranges) {
+            const Occurrence low{qMax(fromMinute, dayStart + range.begin), 0};
+            const Occurrence high{qMin(toMinute, dayStart + range.end), 0};
+            if (high.minute <= low.minute) continue;
+            auto first = std::lower_bound(occurrences.cbegin(), occurrences.cend(), low, occursBefore);
+            auto last = std::lower_bound(first, occurrences.cend(), high, occursBefore);
+            if (disabledIds.isEmpty()) {
+                std::copy(first, last, std::back_inserter(result));
+            } else {
+                std::copy_if(first, last, std::back_inserter(result), [this](const Occurrence &occurrence) {
+                    return !disabledIds.contains(occurrence.alarmId);
+                });
+            }
+        }
+    }
+
+    // One-time alarms ring once, at their next occurrence
+    if (!oneTime.isEmpty()) {
+        const qint64 now = AlarmScheduler::wheelMinute(clockSource->currentDateTime());
+        const qint64 today = floorDiv(now, minutesPerDay) * minutesPerDay;
+        const int sortedUpTo = result.size();
+        for (const DayRange &range : ranges) {
+            const PatternEntry low{range.begin, 0};
+            auto first = std::lower_bound(oneTime.cbegin(), oneTime.cend(), low, entryBefore<PatternEntry>);
+            for (auto it = first; it != oneTime.cend() && it->minute < range.end; ++it) {
+                qint64 next = today + it->minute;
+                if (next < now) next += minutesPerDay;
+                if (next >= fromMinute && next < toMinute && !disabledIds.contains(it->id)
+                        && !isSkipped(it->id, floorDiv(next, minutesPerDay))) {
+                    result.append({next, it->id});
+                }
+            }
+        }
+        std::sort(result.begin() + sortedUpTo, result.end(), occursBefore);
+        std::inplace_merge(result.begin(), result.begin() + sortedUpTo, result.end(), occursBefore);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Builds both pattern tables from the store, disabled alarms included.
+ */
+void OccurrenceCache::build() {
+    weekly.clear();
+    oneTime.clear();
+    patternKeys.clear();
+    disabledIds.clear();
+    dayCache.clear();
+
+    const QVector<Alarm> &alarms = alarmStore->alarms();
+    patternKeys.reserve(alarms.size());
+    for (const Alarm &alarm : alarms) {
+        const int minute = patternMinute(alarm);
+        if (minute >= 0) {
+            weekly.append({minute, alarm.id});
+        } else {
+            oneTime.append({-1 - minute, alarm.id});
+        }
+        patternKeys.insert(alarm.id, {minute, alarm.calendar});
+        if (!alarm.enabled) disabledIds.insert(alarm.id);
+    }
+    std::sort(weekly.begin(), weekly.end(), entryBefore<PatternEntry>);
+    std::sort(oneTime.begin(), oneTime.end(), entryBefore<PatternEntry>);
+    built = true;
+}
+
+/**
+ * @brief Adds an alarm to its table and to the expanded days it rings on.
+ */
+void OccurrenceCache::addPattern(const Alarm &alarm) {
+    const int minute = patternMinute(alarm);
+    patternKeys.insert(alarm.id, {minute, alarm.calendar});
+    if (!alarm.enabled) disabledIds.insert(alarm.id);
+    if (minute < 0) {
+        const PatternEntry entry{-1 - minute, alarm.id};
+        oneTime.insert(std::upper_bound(oneTime.begin(), oneTime.end(), entry, entryBefore<PatternEntry>), entry);
+        return;
+    }
+
+    const PatternEntry entry{minute, alarm.id};
+    weekly.insert(std::upper_bound(weekly.begin(), weekly.end(), entry, entryBefore<PatternEntry>), entry);
+
+    for (auto it = dayCache.begin(); it != dayCache.end(); ++it) {
+        if (floorDiv(it.key(), 7) * 7 + entry.minute / minutesPerDay != it.key()) continue;
+        if (isSkipped(alarm.id, it.key())) continue;
+        const Occurrence occurrence{it.key() * minutesPerDay + entry.minute % minutesPerDay, alarm.id};
+        QVector<Occurrence> &occurrences = it.value();
+        occurrences.insert(std::upper_bound(occurrences.begin(), occurrences.end(), occurrence, occursBefore), occurrence);
+    }
+}
+
+/**
+ * @brief Removes an alarm from its table and from the expanded days.
+ */
+void OccurrenceCache::removePattern(quint64 id) {
+    auto key = patternKeys.find(id);
+    if (key == patternKeys.end()) return;
+    const int minute = key->minute;
+    patternKeys.erase(key);
+    disabledIds.remove(id);
+
+    if (minute < 0) {
+        const PatternEntry entry{-1 - minute, id};
+        auto it = std::lower_bound(oneTime.begin(), oneTime.end(), entry, entryBefore<PatternEntry>);
+        if (it != oneTime.end() && it->id == id) oneTime.erase(it);
+        return;
+    }
+
+    const PatternEntry entry{minute, id};
+    auto it = std::lower_bound(weekly.begin(), weekly.end(), entry, entryBefore<PatternEntry>);
+    if (it != weekly.end() && it->id == id) weekly.erase(it);
+
+    for (auto day = dayCache.begin(); day != dayCache.end(); ++day) {
+        if (floorDiv(day.key(), 7) * 7 + minute / minutesPerDay != day.key()) continue;
+        const Occurrence occurrence{day.key() * minutesPerDay + minute % minutesPerDay, id};
+        QVector<Occurrence> &occurrences = day.value();
+        auto found = std::lower_bound(occurrences.begin(), occurrences.end(), occurrence, occursBefore);
+        if (found != occurrences.end() && found->alarmId == id) occurrences.erase(found);
+    }
+}
+
+/**
+ * @brief Returns the weekly occurrences of a wheel day, expanding it if needed.
+ *
+ * Wheel day 0 is a Monday, so the day's slice of the weekly table starts at
+ * (day mod 7) * 1440.
+ */
+const QVector<Occurrence> &OccurrenceCache::expandDay(qint64 day) {
+    auto cached = dayCache.constFind(day);
+    if (cached != dayCache.constEnd()) return *cached;
+
+    if (dayCache.size() >= maxCachedDays) {
+        // Past days are the least likely to be asked for again
+        const qint64 today = floorDiv(AlarmScheduler::wheelMinute(clockSource->currentDateTime()), minutesPerDay);
+        for (auto it = dayCache.begin(); it != dayCache.end();) {
+            it = it.key() < today ? dayCache.erase(it) : it + 1;
+        }
+        if (dayCache.size() >= maxCachedDays) dayCache.clear();
+    }
+
+    const int weekday = int(day - floorDiv(day, 7) * 7);
+    const PatternEntry low{weekday * minutesPerDay, 0};
+    const PatternEntry high{(weekday + 1) * minutesPerDay, 0};
+    auto first = std::lower_bound(weekly.cbegin(), weekly.cend(), low, entryBefore<PatternEntry>);
+    auto last = std::lower_bound(first, weekly.cend(), high, entryBefore<PatternEntry>);
+
+    QVector<Occurrence> occurrences;
+    occurrences.reserve(int(last - first));
+    const qint64 dayStart = day * minutesPerDay;
+    for (auto it = first; it != last; ++it) {
+        if (isSkipped(it->id, day)) continue;
+        occurrences.append({dayStart + (it->minute - low.minute), it->id});
+    }
+    return *dayCache.insert(day, occurrences);
+}
+
+/**
+ * @brief Returns true if the alarm's holiday calendar excludes the wheel day.
+ */
+bool OccurrenceCache::isSkipped(quint64 id, qint64 day) const {
+    if (!holidays) return false;
+    const Alarm *alarm = alarmStore->find(id);
+    return alarm && !alarm->calendar.isEmpty()
+           && holidays->excludes(alarm->calendar, AlarmScheduler::fromWheelMinute(day * minutesPerDay).date());
+}
+
+/**
+ * @brief Returns true if an updated alarm has to move in the tables (its time, repeat or calendar changed).
+ */
+bool OccurrenceCache::moves(const Alarm &alarm) const {
+    const auto key = patternKeys.constFind(alarm.id);
+    return key == patternKeys.constEnd() || key->minute != patternMinute(alarm) || key->calendar != alarm.calendar;
+}
+
+/**
+ * @brief Mirrors store changes into the tables, one alarm at a time.
+ *
+ * An update that only switches an alarm on or off (a group toggle) costs
+ * one set insertion or removal; only alarms that move are patched into the
+ * sorted tables, and only a batch moving many of them drops the tables.
+ */
+void OccurrenceCache::onStoreChanged(quint64, quint64, const QVector<AlarmChange> &changes) {
+    if (!built) return;
+    const QVector<Alarm> &alarms = alarmStore->alarms();
+
+    int moved = 0;
+    for (const AlarmChange &change : changes) {
+        if (change.kind != AlarmChange::Updated || moves(alarms[change.index])) ++moved;
+    }
+    if (moved > patternKeys.size() / rebuildDivisor + 16) {
+        clear();
+        return;
+    }
+
+    for (const AlarmChange &change : changes) {
+        switch (change.kind) {
+        case AlarmChange::Removed:
+            removePattern(change.id);
+            break;
+        case AlarmChange::Updated: {
+            const Alarm &alarm = alarms[change.index];
+            if (moves(alarm)) {
+                removePattern(change.id);
+                addPattern(alarm);
+            } else if (alarm.enabled) {
+                disabledIds.remove(alarm.id);
+            } else {
+                disabledIds.insert(alarm.id);
+            }
+            break;
+        }
+        case AlarmChange::Added:
+            addPattern(alarms[change.index]);
+            break;
+        }
+    }
+}
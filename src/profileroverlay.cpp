@@ -0,0 +1,128 @@
+/**
+ * @file profileroverlay.cpp
+ * @brief Implementation file for the ProfilerOverlay class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "profileroverlay.h"
+#include "allocationcounter.h"
+#include "slotprofiler.h"
+#include <QFontDatabase>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+/**
+ * @brief Constructs the overlay as a tool window.
+ * @param watchdog Source of the stall data (may be nullptr).
+ * @param scheduler Source of the alarm lateness (may be nullptr).
+ * @param parent The parent widget.
+ */
+ProfilerOverlay::ProfilerOverlay(StallWatchdog *watchdog, AlarmScheduler *scheduler, QWidget *parent)
+    : QWidget(parent, Qt::Tool), watchdog(watchdog), scheduler(scheduler) {
+    setWindowTitle("Profiler");
+
+    const QFont fixedFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    slotTable = new QLabel(this);
+    slotTable->setFont(fixedFont);
+    slotTable->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    stallTable = new QLabel(this);
+    stallTable->setFont(fixedFont);
+    stallTable->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    jitterLine = new QLabel(this);
+    jitterLine->setFont(fixedFont);
+    heapLine = new QLabel(this);
+    heapLine->setFont(fixedFont);
+
+    QPushButton *resetButton = new QPushButton("Reset Timings", this);
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        SlotProfiler::instance().reset();
+        if (this->scheduler) this->scheduler->resetFireJitter();
+        refresh();
+    });
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(slotTable);
+    layout->addWidget(stallTable);
+    layout->addWidget(jitterLine);
+    layout->addWidget(heapLine);
+    layout->addWidget(resetButton);
+
+    connect(&refreshTimer, &QTimer::timeout, this, &ProfilerOverlay::refresh);
+}
+
+/**
+ * @brief Starts refreshing when the panel is shown.
+ */
+void ProfilerOverlay::showEvent(QShowEvent *event) {
+    refresh();
+    refreshTimer.start(500);
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Stops refreshing when the panel is hidden.
+ */
+void ProfilerOverlay::hideEvent(QHideEvent *event) {
+    refreshTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+/**
+ * @brief Rebuilds the text of the tables and the lateness line.
+ */
+void ProfilerOverlay::refresh() {
+    const auto ms = [](qint64 nsecs) { return QString::number(nsecs / 1e6, 'f', 2); };
+
+    if (scheduler) {
+        const FireJitter &jitter = scheduler->fireJitter();
+        jitterLine->setText(QString("Alarm lateness: %1 alarms, mean %2 ms, worst %3 ms, last %4 ms")
+                             .arg(jitter.count).arg(jitter.meanMs(), 0, 'f', 1).arg(jitter.worstMs).arg(jitter.lastMs));
+    } else {
+        jitterLine->setText("Alarm lateness not available");
+    }
+
+    if (AllocationCounter::isAvailable()) {
+        const quint64 allocations = AllocationCounter::allocations();
+        const qint64 elapsedMs = heapSampleTimer.isValid() ? heapSampleTimer.restart() : 0;
+        if (!heapSampleTimer.isValid()) heapSampleTimer.start();
+        const double perSecond = elapsedMs > 0 ? (allocations - heapSampleAllocations) * 1000.0 / elapsedMs : 0.0;
+        heapSampleAllocations = allocations;
+        heapLine->setText(QString("Heap: %1 blocks in use, %2 allocations/s, %3 total")
+                           .arg(qint64(allocations - AllocationCounter::frees()))
+                           .arg(perSecond, 0, 'f', 0).arg(allocations));
+    } else {
+        heapLine->setText("Heap counters not available (build with CONFIG+=heapcount on glibc)");
+    }
+
+    QString slotText = QString("%1 %2 %3 %4 %5\n")
+                        .arg("slot", -28).arg("calls", 8).arg("mean ms", 9).arg("max ms", 9).arg("last ms", 9);
+    for (const SlotProfiler::Stats &stats : SlotProfiler::instance().stats()) {
+        slotText += QString("%1 %2 %3 %4 %5\n")
+                     .arg(QString::fromLatin1(stats.name), -28)
+                     .arg(stats.calls, 8)
+                     .arg(ms(stats.totalNs / qint64(stats.calls)), 9)
+                     .arg(ms(stats.maxNs), 9)
+                     .arg(ms(stats.lastNs), 9);
+    }
+    slotTable->setText(slotText.trimmed());
+
+    if (!watchdog) {
+        stallTable->setText("Stall watchdog not running");
+        return;
+    }
+
+    QString stallText = QString("Stalls over %1 ms: %2 (worst %3 ms)\n")
+                         .arg(watchdog->threshold()).arg(watchdog->stallCount()).arg(watchdog->worstStallMs());
+    const QVector<StallWatchdog::Stall> &recent = watchdog->recentStalls();
+    const int shown = 8;
+    for (int i = recent.size() - 1; i >= 0 && i >= recent.size() - shown; --i) {
+        const StallWatchdog::Stall &stall = recent[i];
+        stallText += QString("%1 %2 ms  %3\n")
+                      .arg(stall.startedAt.toString("HH:mm:ss.zzz"))
+                      .arg(stall.durationMs, 6)
+                      .arg(stall.slot.isEmpty() ? QString("(unknown)") : stall.slot);
+    }
+    stallTable->setText(stallText.trimmed());
+}
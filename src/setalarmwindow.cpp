@@ -19,10 +19,15 @@
  * repeat options, label input, sound selection, and save button. It also connects the save 
  * button to the `saveAlarm` slot for handling the alarm saving functionality.
  *
+ * @param calendars Names of the holiday calendars to offer.
+ * @param groups Names of the existing groups to offer.
+ * @param sounds Sounds to offer; the list follows the user sound folder while the dialog is open.
  * @param parent The parent widget, default is nullptr.
  */
 
-SetAlarmWindow::SetAlarmWindow(QWidget *parent) : QDialog(parent) {
+SetAlarmWindow::SetAlarmWindow(const QStringList &calendars, const QStringList &groups, const SoundLibrary *sounds,
+                               QWidget *parent)
+    : QDialog(parent) {
     setWindowTitle("Set Alarm");
     this->resize(400, 300);
 
@@ -30,7 +35,7 @@ SetAlarmWindow::SetAlarmWindow(QWidget *parent) : QDialog(parent) {
 
     // Time Selection
     timeEdit = new QTimeEdit(this);
-    timeEdit->setDisplayFormat("HH:mm"); // 24-hour format
+    timeEdit->setDisplayFormat("HH:mm:ss"); // 24-hour format
 
     // Repeat Alarm Dropdown
     repeatComboBox = new QComboBox(this);
@@ -50,9 +55,28 @@ SetAlarmWindow::SetAlarmWindow(QWidget *parent) : QDialog(parent) {
     // Sound Selection Dropdown 
     soundComboBox = new QComboBox(this);
     // Options for sound
-    soundComboBox->addItem("Classic");
-    soundComboBox->addItem("Beep");
-    soundComboBox->addItem("Rooster");
+    if (sounds) {
+        sounds->populate(soundComboBox);
+        soundComboBox->setCurrentText("Classic");
+    } else {
+        soundComboBox->addItem("Classic");
+        soundComboBox->addItem("Beep");
+        soundComboBox->addItem("Rooster");
+    }
+
+    // Holiday calendar whose dates the alarm skips
+    calendarComboBox = new QComboBox(this);
+    calendarComboBox->addItem("None", QString());
+    for (const QString &calendar : calendars) {
+        calendarComboBox->addItem(calendar, calendar);
+    }
+
+    // Group the alarm can be switched on and off with (a new name starts a new group)
+    groupComboBox = new QComboBox(this);
+    groupComboBox->setEditable(true);
+    groupComboBox->addItem(QString());
+    groupComboBox->addItems(groups);
+    groupComboBox->lineEdit()->setPlaceholderText("No group");
 
     // Save Button
     saveButton = new QPushButton("Save Alarm", this);
@@ -71,6 +95,16 @@ SetAlarmWindow::SetAlarmWindow(QWidget *parent) : QDialog(parent) {
     
     layout->addWidget(new QLabel("Sound:"));
     layout->addWidget(soundComboBox);
+
+    if (!calendars.isEmpty()) {
+        layout->addWidget(new QLabel("Skip Dates In:"));
+        layout->addWidget(calendarComboBox);
+    } else {
+        calendarComboBox->hide();
+    }
+
+    layout->addWidget(new QLabel("Group:"));
+    layout->addWidget(groupComboBox);
     
     layout->addWidget(saveButton);
     layout->addWidget(errorLabel);
@@ -101,6 +135,7 @@ void SetAlarmWindow::saveAlarm() {
         return;
     }
 
-    emit alarmSet(selectedTime, repeatOption, alarmLabel, selectedSound); // Send all data to MainWindow
+    emit alarmSet(selectedTime, repeatOption, alarmLabel, selectedSound, calendarComboBox->currentData().toString(),
+                  groupComboBox->currentText().trimmed()); // Send all data to MainWindow
     accept(); // Close the dialog
 }
@@ -0,0 +1,155 @@
+/**
+ * @file singleinstance.cpp
+ * @brief Implementation file for the SingleInstance class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "singleinstance.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QRegularExpression>
+#include <QThread>
+
+namespace {
+
+/**
+ * @brief Serialization version of the messages; both sides are the same build.
+ */
+const QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+
+} // namespace
+
+/**
+ * @brief Derives the lock file path from the name.
+ * @param name Name of the lock file and the socket.
+ * @param parent The parent object.
+ */
+SingleInstance::SingleInstance(const QString &name, QObject *parent)
+    : QObject(parent), serverName(name), lockFile(QDir::temp().filePath(name + ".lock")) {
+    // Only a dead owner makes the lock stale; a primary may run for months
+    lockFile.setStaleLockTime(0);
+}
+
+/**
+ * @brief Closes the socket before the lock is released.
+ */
+SingleInstance::~SingleInstance() {
+    server.reset();
+}
+
+/**
+ * @brief Builds "rise-and-pi-<user>" from the login name.
+ */
+QString SingleInstance::defaultName() {
+    QString user = qEnvironmentVariable("USER", qEnvironmentVariable("USERNAME", "user"));
+    user.remove(QRegularExpression("[^A-Za-z0-9_.-]"));
+    return "rise-and-pi-" + user;
+}
+
+/**
+ * @brief Takes the lock without waiting.
+ */
+bool SingleInstance::tryPrimary() {
+    return lockFile.tryLock(0);
+}
+
+/**
+ * @brief Opens the socket, replacing one left behind by a crashed primary.
+ */
+bool SingleInstance::listen(Handler handler) {
+    commandHandler = std::move(handler);
+    server.reset(new QLocalServer());
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+
+    // Holding the lock means any existing socket file is stale
+    QLocalServer::removeServer(serverName);
+    if (!server->listen(serverName)) {
+        qWarning() << "[INSTANCE] Cannot listen on" << serverName << ":" << server->errorString();
+        server.reset();
+        return false;
+    }
+    connect(server.get(), &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    // The socket notifiers must go before the application object does
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() { server.reset(); });
+    qDebug() << "[INSTANCE] Accepting commands on" << server->fullServerName();
+    return true;
+}
+
+/**
+ * @brief Connects, sends the command and reads the reply with blocking calls.
+ *
+ * Nothing here needs a running event loop, so a forwarding launch never
+ * enters one.
+ */
+int SingleInstance::forward(const QStringList &command, QString *reply, int timeoutMs) {
+    QElapsedTimer elapsed;
+    elapsed.start();
+    auto remaining = [&]() { return qMax(1, timeoutMs - int(elapsed.elapsed())); };
+
+    QLocalSocket socket;
+    for (;;) {
+        socket.connectToServer(serverName);
+        if (socket.waitForConnected(remaining())) break;
+        if (elapsed.elapsed() >= timeoutMs) {
+            *reply = "The running instance does not answer: " + socket.errorString();
+            return 3;
+        }
+        // The primary holds the lock but has not started listening yet
+        QThread::msleep(20);
+    }
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(streamVersion);
+    out << command;
+    socket.write(message);
+
+    QDataStream in(&socket);
+    in.setVersion(streamVersion);
+    bool ok = false;
+    QString text;
+    for (;;) {
+        in.startTransaction();
+        in >> ok >> text;
+        if (in.commitTransaction()) break;
+        if (!socket.waitForReadyRead(remaining()) && socket.bytesAvailable() == 0) {
+            *reply = "The running instance did not reply";
+            return 3;
+        }
+    }
+    *reply = text;
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Serves every pending connection: one command, one reply, then disconnect.
+ */
+void SingleInstance::onNewConnection() {
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            QDataStream in(socket);
+            in.setVersion(streamVersion);
+            in.startTransaction();
+            QStringList command;
+            in >> command;
+            // Wait for the rest of a message that arrived in pieces
+            if (!in.commitTransaction()) return;
+
+            qDebug() << "[INSTANCE] Received command" << command;
+            QString reply;
+            const bool ok = commandHandler && commandHandler(command, &reply);
+
+            QDataStream out(socket);
+            out.setVersion(streamVersion);
+            out << ok << reply;
+            socket->disconnectFromServer();
+        });
+    }
+}
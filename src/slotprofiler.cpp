@@ -0,0 +1,52 @@
+/**
+ * @file slotprofiler.cpp
+ * @brief Implementation file for the SlotProfiler class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "slotprofiler.h"
+#include <cstring>
+
+/**
+ * @brief Starts timing a slot and publishes it as the running slot.
+ * @param name The slot name (must outlive the program, e.g. a literal).
+ */
+SlotProfiler::Scope::Scope(const char *name)
+    : name(name), previous(SlotProfiler::instance().active.exchange(name, std::memory_order_acq_rel)) {
+    timer.start();
+}
+
+/**
+ * @brief Records the call and restores the previously running slot.
+ */
+SlotProfiler::Scope::~Scope() {
+    SlotProfiler &profiler = SlotProfiler::instance();
+    profiler.record(name, timer.nsecsElapsed());
+    profiler.active.store(previous, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the single profiler instance.
+ */
+SlotProfiler &SlotProfiler::instance() {
+    static SlotProfiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Adds one call to the statistics of a slot.
+ */
+void SlotProfiler::record(const char *name, qint64 nsecs) {
+    for (Stats &stats : slotStats) {
+        if (stats.name == name || std::strcmp(stats.name, name) == 0) {
+            ++stats.calls;
+            stats.totalNs += nsecs;
+            stats.maxNs = qMax(stats.maxNs, nsecs);
+            stats.lastNs = nsecs;
+            return;
+        }
+    }
+    slotStats.append({name, 1, nsecs, nsecs, nsecs});
+}
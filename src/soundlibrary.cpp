@@ -0,0 +1,540 @@
+/**
+ * @file soundlibrary.cpp
+ * @brief Implementation file for the SoundLibrary class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "soundlibrary.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Built-in sound names and the resources they are decoded from.
+ */
+const QPair<const char *, const char *> builtInFiles[] = {
+    {"Classic", ":/sounds/sounds/ring1.wav"},
+    {"Beep", ":/sounds/sounds/ring2.wav"},
+    {"Rooster", ":/sounds/sounds/ring3.wav"},
+};
+
+const quint16 wavePcm = 1;           ///< WAVE_FORMAT_PCM.
+const quint16 waveFloat = 3;         ///< WAVE_FORMAT_IEEE_FLOAT.
+const quint16 waveExtensible = 0xFFFE; ///< WAVE_FORMAT_EXTENSIBLE (sub-format follows).
+
+/**
+ * @brief Scales one little-endian sample in place.
+ *
+ * Formats decodeWav() does not produce are left unchanged.
+ */
+void scaleSample(char *sample, const QAudioFormat &format, double gain) {
+    switch (format.sampleSize()) {
+    case 8: {
+        // 8-bit WAV samples are unsigned, centred on 128
+        const int centred = int(uchar(*sample)) - 128;
+        *sample = char(uchar(int(centred * gain) + 128));
+        break;
+    }
+    case 16:
+        qToLittleEndian<qint16>(qint16(qFromLittleEndian<qint16>(sample) * gain), sample);
+        break;
+    case 24: {
+        const qint32 value = qint32(uchar(sample[0])) | qint32(uchar(sample[1])) << 8 | qint32(qint8(sample[2])) * 65536;
+        const qint32 scaled = qint32(value * gain);
+        sample[0] = char(scaled & 0xFF);
+        sample[1] = char((scaled >> 8) & 0xFF);
+        sample[2] = char((scaled >> 16) & 0xFF);
+        break;
+    }
+    case 32:
+        if (format.sampleType() == QAudioFormat::Float) {
+            const quint32 bits = qFromLittleEndian<quint32>(sample);
+            float value;
+            std::memcpy(&value, &bits, sizeof value);
+            value = float(value * gain);
+            quint32 scaledBits;
+            std::memcpy(&scaledBits, &value, sizeof scaledBits);
+            qToLittleEndian<quint32>(scaledBits, sample);
+        } else {
+            qToLittleEndian<qint32>(qint32(qFromLittleEndian<qint32>(sample) * gain), sample);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Sets up the folder watcher and decodes the built-in sounds in the background.
+ * @param parent The parent object.
+ */
+SoundLibrary::SoundLibrary(QObject *parent) : QObject(parent) {
+    // Decodes are mostly file reads; two threads keep a large file from holding up the others
+    decodePool.setMaxThreadCount(2);
+
+    scanTimer.setSingleShot(true);
+    scanTimer.setInterval(500);
+    connect(&scanTimer, &QTimer::timeout, this, &SoundLibrary::scan);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &SoundLibrary::scheduleScan);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &SoundLibrary::scheduleScan);
+
+    for (const auto &file : builtInFiles) {
+        submitDecode(file.first, file.second, true, 0);
+    }
+}
+
+/**
+ * @brief Lets running decodes finish before their results' receiver goes away.
+ */
+SoundLibrary::~SoundLibrary() {
+    decodePool.clear();
+    decodePool.waitForDone();
+}
+
+/**
+ * @brief Starts watching a user sound folder.
+ * @param path The folder.
+ * @return True if the folder is watched.
+ */
+bool SoundLibrary::setDirectory(const QString &path) {
+    if (!userDirectory.isEmpty()) {
+        watcher.removePaths(watcher.files() + watcher.directories());
+        for (const QString &file : files.keys()) {
+            forgetFile(file);
+        }
+        userDirectory.clear();
+    }
+
+    if (path.isEmpty() || !QDir().mkpath(path) || !watcher.addPath(path)) {
+        qWarning() << "[SOUNDS] Cannot watch sound folder" << path;
+        return false;
+    }
+    userDirectory = QFileInfo(path).absoluteFilePath();
+    scan();
+    return true;
+}
+
+/**
+ * @brief Lists every name that has a decoded sound.
+ */
+QStringList SoundLibrary::names() const {
+    QStringList result = builtInSounds.keys();
+    for (auto it = userSounds.cbegin(); it != userSounds.cend(); ++it) {
+        if (!builtInSounds.contains(it.key())) result.append(it.key());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * @brief Looks up a sound, preferring the user's file over a built-in one.
+ */
+std::shared_ptr<const DecodedSound> SoundLibrary::sound(const QString &name) const {
+    const std::shared_ptr<const DecodedSound> user = userSounds.value(name);
+    return user ? user : builtInSounds.value(name);
+}
+
+/**
+ * @brief Stores the playback settings; they apply from the next alarm on.
+ */
+void SoundLibrary::setTrackPlayback(qint64 startMs, int fadeInMs) {
+    trackStart = qMax<qint64>(0, startMs);
+    trackFadeIn = qMax(0, fadeInMs);
+}
+
+/**
+ * @brief Adds the decoded sounds to a selector and follows later changes.
+ */
+void SoundLibrary::populate(QComboBox *comboBox) const {
+    for (const QString &name : names()) {
+        if (comboBox->findText(name) == -1) comboBox->addItem(name);
+    }
+
+    connect(this, &SoundLibrary::soundAdded, comboBox, [comboBox](const QString &name) {
+        if (comboBox->findText(name) != -1) return;
+        int index = 0;
+        while (index < comboBox->count() && comboBox->itemText(index) < name) ++index;
+        comboBox->insertItem(index, name);
+    });
+    connect(this, &SoundLibrary::soundRemoved, comboBox, [comboBox](const QString &name) {
+        const int index = comboBox->findText(name);
+        // Keep the selection of an open dialog, even if its file is gone
+        if (index != -1 && index != comboBox->currentIndex()) comboBox->removeItem(index);
+    });
+}
+
+/**
+ * @brief Remembers that something in the folder changed and waits for it to settle.
+ *
+ * Copying a large file reports many changes; restarting the timer on each
+ * one means the file is decoded once, after the copy is done.
+ */
+void SoundLibrary::scheduleScan(const QString &) {
+    scanTimer.start();
+}
+
+/**
+ * @brief Decodes the files that are new or changed and forgets the ones that are gone.
+ */
+void SoundLibrary::scan() {
+    if (userDirectory.isEmpty()) return;
+
+    const QFileInfoList entries = QDir(userDirectory).entryInfoList({"*.wav", "*.WAV"}, QDir::Files | QDir::Readable);
+    QSet<QString> present;
+    for (const QFileInfo &entry : entries) {
+        const QString path = entry.absoluteFilePath();
+        present.insert(path);
+
+        FileState &state = files[path];
+        if (state.size == entry.size() && state.modified == entry.lastModified()) continue;
+
+        if (state.name.isEmpty()) watcher.addPath(path);
+        state.name = entry.completeBaseName();
+        state.size = entry.size();
+        state.modified = entry.lastModified();
+        state.generation = ++lastGeneration;
+        submitDecode(state.name, path, false, state.generation);
+    }
+
+    for (const QString &path : files.keys()) {
+        if (!present.contains(path)) {
+            watcher.removePath(path);
+            forgetFile(path);
+        }
+    }
+}
+
+/**
+ * @brief Queues a decode on the pool; the result comes back through the event loop.
+ */
+void SoundLibrary::submitDecode(const QString &name, const QString &path, bool builtIn, quint64 generation) {
+    QtConcurrent::run(&decodePool, [this, name, path, builtIn, generation]() {
+        QString error;
+        std::shared_ptr<const DecodedSound> decoded = decodeWav(name, path, &error);
+        QMetaObject::invokeMethod(this, [=]() { finishDecode(path, builtIn, generation, decoded, error); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Publishes a finished decode and tells the selectors about a new name.
+ */
+void SoundLibrary::finishDecode(const QString &path, bool builtIn, quint64 generation,
+                                std::shared_ptr<const DecodedSound> decoded, const QString &error) {
+    QMap<QString, std::shared_ptr<const DecodedSound>> &sounds = builtIn ? builtInSounds : userSounds;
+    QString name;
+    if (builtIn) {
+        name = decoded ? decoded->name : QString();
+    } else {
+        // The file changed or went away while it was being decoded
+        const auto state = files.constFind(path);
+        if (state == files.constEnd() || state->generation != generation) return;
+        name = state->name;
+    }
+
+    if (!decoded) {
+        qWarning() << "[SOUNDS] Cannot use" << path << ":" << error;
+        if (!builtIn && sounds.remove(name) && !sound(name)) emit soundRemoved(name);
+        return;
+    }
+
+    const bool known = sound(name) != nullptr;
+    sounds.insert(name, decoded);
+    if (decoded->isStreamed()) {
+        qDebug() << "[SOUNDS] Found" << name << "in" << path << "(" << decoded->dataSize / 1024 << "KB, streamed )";
+    } else {
+        qDebug() << "[SOUNDS] Loaded" << name << "from" << path << "(" << decoded->pcm.size() / 1024 << "KB )";
+    }
+    if (!known) emit soundAdded(name);
+}
+
+/**
+ * @brief Drops a file's sound; a built-in sound of the same name takes its place again.
+ */
+void SoundLibrary::forgetFile(const QString &path) {
+    const FileState state = files.take(path);
+    if (userSounds.remove(state.name) && !sound(state.name)) {
+        emit soundRemoved(state.name);
+    }
+}
+
+/**
+ * @brief Walks the RIFF chunks of a WAV file and copies out its samples.
+ */
+std::shared_ptr<const DecodedSound> SoundLibrary::decodeWav(const QString &name, const QString &path, QString *error) {
+    auto fail = [error](const QString &reason) {
+        if (error) *error = reason;
+        return std::shared_ptr<const DecodedSound>();
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return fail(file.errorString());
+
+    char riff[12];
+    if (file.read(riff, sizeof riff) != qint64(sizeof riff) || std::memcmp(riff, "RIFF", 4) != 0
+            || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return fail("not a WAV file");
+    }
+
+    auto sound = std::make_shared<DecodedSound>();
+    sound->name = name;
+    sound->path = path;
+    bool haveFormat = false;
+
+    char chunkHeader[8];
+    while (file.read(chunkHeader, sizeof chunkHeader) == qint64(sizeof chunkHeader)) {
+        const qint64 chunkSize = qFromLittleEndian<quint32>(chunkHeader + 4);
+
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+            const QByteArray fmt = file.read(chunkSize);
+            if (fmt.size() < 16) return fail("truncated format chunk");
+            quint16 encoding = qFromLittleEndian<quint16>(fmt.constData());
+            const int channels = qFromLittleEndian<quint16>(fmt.constData() + 2);
+            const int sampleRate = int(qFromLittleEndian<quint32>(fmt.constData() + 4));
+            const int bits = qFromLittleEndian<quint16>(fmt.constData() + 14);
+            if (encoding == waveExtensible && fmt.size() >= 26) {
+                encoding = qFromLittleEndian<quint16>(fmt.constData() + 24);
+            }
+            if ((encoding != wavePcm && encoding != waveFloat) || channels == 0 || sampleRate == 0
+                    || bits == 0 || bits % 8 != 0) {
+                return fail("only uncompressed WAV files are supported");
+            }
+
+            sound->format.setCodec("audio/pcm");
+            sound->format.setByteOrder(QAudioFormat::LittleEndian);
+            sound->format.setChannelCount(channels);
+            sound->format.setSampleRate(sampleRate);
+            sound->format.setSampleSize(bits);
+            sound->format.setSampleType(encoding == waveFloat ? QAudioFormat::Float
+                                        : bits == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
+            haveFormat = true;
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            if (!haveFormat) return fail("samples before the format chunk");
+            sound->dataOffset = file.pos();
+            if (chunkSize > streamThreshold) {
+                // Long tracks stay in the file; the samples are read while they play
+                if (file.size() - sound->dataOffset < chunkSize) return fail("truncated sample data");
+                sound->dataSize = chunkSize - chunkSize % sound->format.bytesPerFrame();
+                return sound;
+            }
+            sound->pcm = file.read(chunkSize);
+            if (sound->pcm.size() != chunkSize) return fail("truncated sample data");
+            // Whole frames only, so a loop never starts in the middle of one
+            sound->pcm.chop(sound->pcm.size() % sound->format.bytesPerFrame());
+            if (sound->pcm.isEmpty()) return fail("no samples");
+            sound->dataSize = sound->pcm.size();
+            return sound;
+        } else if (!file.seek(file.pos() + chunkSize)) {
+            break;
+        }
+
+        // Chunks are padded to an even size
+        if (chunkSize % 2 == 1) file.seek(file.pos() + 1);
+    }
+    return fail("no sample data");
+}
+
+/**
+ * @brief Constructs the device over a decoded sound.
+ * @param sound The sound to repeat.
+ * @param parent The parent object.
+ */
+LoopingSoundDevice::LoopingSoundDevice(std::shared_ptr<const DecodedSound> sound, QObject *parent)
+    : QIODevice(parent), decoded(std::move(sound)) {}
+
+/**
+ * @brief Replaces the samples and rewinds.
+ */
+void LoopingSoundDevice::setSound(std::shared_ptr<const DecodedSound> sound) {
+    decoded = std::move(sound);
+    position = 0;
+}
+
+/**
+ * @brief There is always a full loop's worth of samples to read.
+ */
+qint64 LoopingSoundDevice::bytesAvailable() const {
+    return (decoded ? decoded->pcm.size() : 0) + QIODevice::bytesAvailable();
+}
+
+/**
+ * @brief Copies samples, wrapping around to the start of the sound.
+ */
+qint64 LoopingSoundDevice::readData(char *data, qint64 maxSize) {
+    const qint64 size = decoded ? decoded->pcm.size() : 0;
+    if (size == 0) return 0;
+    qint64 copied = 0;
+    while (copied < maxSize) {
+        const qint64 chunk = qMin(maxSize - copied, size - position);
+        std::memcpy(data + copied, decoded->pcm.constData() + position, size_t(chunk));
+        copied += chunk;
+        position = (position + chunk) % size;
+    }
+    return copied;
+}
+
+/**
+ * @brief The device is read-only.
+ */
+qint64 LoopingSoundDevice::writeData(const char *, qint64) {
+    return -1;
+}
+
+/**
+ * @brief Works out the start offset and the ring size; the file is opened by open().
+ * @param sound A streamed track.
+ * @param startMs Offset to start at.
+ * @param fadeInMs Duration of the fade-in.
+ * @param parent The parent object.
+ */
+StreamingSoundDevice::StreamingSoundDevice(std::shared_ptr<const DecodedSound> sound, qint64 startMs, int fadeInMs,
+                                           QObject *parent)
+    : QIODevice(parent), decoded(std::move(sound)), file(decoded->path) {
+    const QAudioFormat &format = decoded->format;
+    const int frameBytes = format.bytesPerFrame();
+    const qint64 startFrame = format.framesForDuration(qMax<qint64>(0, startMs) * 1000);
+    startOffset = decoded->dataOffset + (startFrame < decoded->dataSize / frameBytes ? startFrame * frameBytes : 0);
+    fadeFrames = format.framesForDuration(qint64(qMax(0, fadeInMs)) * 1000);
+    ring.resize(RingBytes - RingBytes % frameBytes);
+}
+
+/**
+ * @brief Opens the file and maps the first window; nothing else is read yet.
+ */
+bool StreamingSoundDevice::open(OpenMode mode) {
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "[SOUND] Cannot open" << decoded->path << ":" << file.errorString();
+        return false;
+    }
+    filePosition = startOffset;
+    decodedFrames = 0;
+    ringRead = 0;
+    ringFill = 0;
+    if (!mapWindow(filePosition)) {
+        file.close();
+        return false;
+    }
+    return QIODevice::open(mode);
+}
+
+/**
+ * @brief Releases the mapping and the file.
+ */
+void StreamingSoundDevice::close() {
+    if (window) {
+        file.unmap(window);
+        window = nullptr;
+    }
+    file.close();
+    QIODevice::close();
+}
+
+/**
+ * @brief There is always a ring's worth of samples to read, as the track loops.
+ */
+qint64 StreamingSoundDevice::bytesAvailable() const {
+    return ring.size() + QIODevice::bytesAvailable();
+}
+
+/**
+ * @brief Returns decoded samples, topping the ring up once it is half empty.
+ */
+qint64 StreamingSoundDevice::readData(char *data, qint64 maxSize) {
+    qint64 copied = 0;
+    while (copied < maxSize) {
+        if (ringFill < ring.size() / 2) refill();
+        if (ringFill == 0) break;
+        const int chunk = int(qMin<qint64>(maxSize - copied, qMin(ringFill, ring.size() - ringRead)));
+        std::memcpy(data + copied, ring.constData() + ringRead, size_t(chunk));
+        copied += chunk;
+        ringRead = (ringRead + chunk) % ring.size();
+        ringFill -= chunk;
+    }
+    return copied;
+}
+
+/**
+ * @brief The device is read-only.
+ */
+qint64 StreamingSoundDevice::writeData(const char *, qint64) {
+    return -1;
+}
+
+/**
+ * @brief Copies whole frames from the mapped window into the ring, wrapping at the end of the track.
+ *
+ * Writes start at whole frames of the ring, and windows start at whole
+ * frames of the track, so every copy holds whole frames for the fade.
+ */
+void StreamingSoundDevice::refill() {
+    const int frameBytes = decoded->format.bytesPerFrame();
+    const qint64 dataEnd = decoded->dataOffset + decoded->dataSize;
+    char *ringData = ring.data();
+    for (;;) {
+        if (filePosition >= dataEnd) filePosition = startOffset;
+        if (filePosition < windowStart || filePosition >= windowStart + windowSize) {
+            if (!mapWindow(filePosition)) return;
+        }
+
+        const int writeAt = (ringRead + ringFill) % ring.size();
+        qint64 chunk = qMin<qint64>(qMin(ring.size() - writeAt, ring.size() - ringFill),
+                                    windowStart + windowSize - filePosition);
+        chunk -= chunk % frameBytes;
+        if (chunk <= 0) return;
+
+        std::memcpy(ringData + writeAt, window + (filePosition - windowStart), size_t(chunk));
+        applyFade(ringData + writeAt, chunk / frameBytes);
+        filePosition += chunk;
+        ringFill += int(chunk);
+    }
+}
+
+/**
+ * @brief Replaces the mapping with the window around an offset.
+ */
+bool StreamingSoundDevice::mapWindow(qint64 offset) {
+    if (window) {
+        file.unmap(window);
+        window = nullptr;
+    }
+
+    const qint64 frameBytes = decoded->format.bytesPerFrame();
+    const qint64 windowBytes = WindowBytes - WindowBytes % frameBytes;
+    windowStart = decoded->dataOffset + (offset - decoded->dataOffset) / windowBytes * windowBytes;
+    windowSize = qMin(windowBytes, decoded->dataOffset + decoded->dataSize - windowStart);
+    // QFile aligns the mapping to pages itself
+    window = file.map(windowStart, windowSize);
+    if (!window) {
+        qWarning() << "[SOUND] Cannot map" << decoded->path << "at" << windowStart << ":" << file.errorString();
+        windowSize = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ramps the volume up linearly over the first fadeFrames frames.
+ */
+void StreamingSoundDevice::applyFade(char *frames, qint64 frameCount) {
+    const QAudioFormat &format = decoded->format;
+    const int frameBytes = format.bytesPerFrame();
+    const int sampleBytes = format.sampleSize() / 8;
+    for (qint64 i = 0; i < frameCount && decodedFrames < fadeFrames; ++i, ++decodedFrames) {
+        const double gain = double(decodedFrames) / double(fadeFrames);
+        char *sample = frames + i * frameBytes;
+        for (int channel = 0; channel < format.channelCount(); ++channel, sample += sampleBytes) {
+            scaleSample(sample, format, gain);
+        }
+    }
+}
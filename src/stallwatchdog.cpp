@@ -0,0 +1,121 @@
+/**
+ * @file stallwatchdog.cpp
+ * @brief Implementation file for the StallWatchdog class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "stallwatchdog.h"
+#include "slotprofiler.h"
+#include <QDebug>
+#include <QThread>
+
+/**
+ * @brief Constructs the watchdog (not started).
+ * @param thresholdMs Shortest blockage reported as a stall.
+ * @param parent The parent object.
+ */
+StallWatchdog::StallWatchdog(int thresholdMs, QObject *parent)
+    : QObject(parent), thresholdMs(thresholdMs) {
+    heartbeat.setTimerType(Qt::PreciseTimer);
+    connect(&heartbeat, &QTimer::timeout, this, &StallWatchdog::beat);
+}
+
+/**
+ * @brief Stops the watchdog before it is destroyed.
+ */
+StallWatchdog::~StallWatchdog() {
+    stop();
+}
+
+/**
+ * @brief Starts the heartbeat and the monitor thread.
+ */
+void StallWatchdog::start() {
+    if (running) return;
+
+    monotonic.start();
+    startedAt = QDateTime::currentDateTime();
+    lastBeatMs = 0;
+    running = true;
+    heartbeat.start(heartbeatMs);
+
+    monitor = QThread::create([this]() { watch(); });
+    monitor->setObjectName("StallWatchdog");
+    monitor->start(QThread::HighPriority);
+}
+
+/**
+ * @brief Stops the heartbeat and joins the monitor thread.
+ */
+void StallWatchdog::stop() {
+    if (!running) return;
+
+    running = false;
+    heartbeat.stop();
+    monitor->wait();
+    delete monitor;
+    monitor = nullptr;
+}
+
+/**
+ * @brief Records that the event loop is alive.
+ */
+void StallWatchdog::beat() {
+    lastBeatMs.store(monotonic.elapsed(), std::memory_order_release);
+}
+
+/**
+ * @brief Polls the heartbeat until stopped.
+ *
+ * A stall starts one heartbeat period after the last beat and ends at the
+ * next beat. The slot is sampled while the stall is in progress, since that
+ * is the code that is blocking the loop.
+ */
+void StallWatchdog::watch() {
+    const int pollMs = 10;
+    qint64 stallBeat = -1;          // Last beat before the stall in progress
+    const char *stallSlot = nullptr;
+
+    while (running) {
+        QThread::msleep(pollMs);
+        const qint64 beatMs = lastBeatMs.load(std::memory_order_acquire);
+        const qint64 silentMs = monotonic.elapsed() - beatMs - heartbeatMs;
+
+        if (stallBeat == -1) {
+            if (silentMs >= thresholdMs) {
+                stallBeat = beatMs;
+                stallSlot = SlotProfiler::instance().activeSlot();
+            }
+        } else if (beatMs != stallBeat) {
+            // The loop is running again; hand the stall to the GUI thread
+            const qint64 startMs = stallBeat + heartbeatMs;
+            const qint64 durationMs = beatMs - startMs;
+            const char *slot = stallSlot;
+            QMetaObject::invokeMethod(this, [this, startMs, durationMs, slot]() {
+                recordStall(startMs, durationMs, slot);
+            }, Qt::QueuedConnection);
+            stallBeat = -1;
+            stallSlot = nullptr;
+        } else if (!stallSlot) {
+            stallSlot = SlotProfiler::instance().activeSlot();
+        }
+    }
+}
+
+/**
+ * @brief Stores a finished stall and emits stallDetected().
+ */
+void StallWatchdog::recordStall(qint64 startMs, qint64 durationMs, const char *slot) {
+    Stall stall{startedAt.addMSecs(startMs), durationMs, slot ? QString::fromLatin1(slot) : QString()};
+
+    ++totalStalls;
+    worstMs = qMax(worstMs, durationMs);
+    if (stalls.size() == maxStalls) stalls.removeFirst();
+    stalls.append(stall);
+
+    qWarning() << "[WATCHDOG] Event loop stalled for" << durationMs << "ms"
+               << "in" << (stall.slot.isEmpty() ? QString("unknown slot") : stall.slot);
+    emit stallDetected(stall);
+}
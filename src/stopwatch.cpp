@@ -0,0 +1,53 @@
+/**
+ * @file stopwatch.cpp
+ * @brief Implementation file for the Stopwatch class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "stopwatch.h"
+
+/**
+ * @brief Notes the monotonic instant the run starts at.
+ */
+void Stopwatch::start() {
+    if (running) return;
+    startedAt = clockSource->monotonicMSecs();
+    running = true;
+}
+
+/**
+ * @brief Adds the current run to the accumulated time.
+ */
+void Stopwatch::stop() {
+    if (!running) return;
+    accumulatedMs += clockSource->monotonicMSecs() - startedAt;
+    running = false;
+}
+
+/**
+ * @brief Returns to zero without laps.
+ */
+void Stopwatch::reset() {
+    accumulatedMs = 0;
+    running = false;
+    lapSplits.clear();
+}
+
+/**
+ * @brief Stores the current split and returns the time since the previous one.
+ */
+qint64 Stopwatch::lap() {
+    const qint64 split = elapsedMs();
+    const qint64 length = split - (lapSplits.isEmpty() ? 0 : lapSplits.last());
+    lapSplits.append(split);
+    return length;
+}
+
+/**
+ * @brief Adds the running time to the accumulated time.
+ */
+qint64 Stopwatch::elapsedMs() const {
+    return running ? accumulatedMs + clockSource->monotonicMSecs() - startedAt : accumulatedMs;
+}
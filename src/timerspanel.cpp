@@ -0,0 +1,296 @@
+/**
+ * @file timerspanel.cpp
+ * @brief Implementation file for the TimersPanel class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "timerspanel.h"
+#include "slotprofiler.h"
+#include <QFontDatabase>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QScrollArea>
+
+/**
+ * @brief Builds the timer list, the new-timer fields and the stopwatch.
+ * @param timers The countdown timers to show.
+ * @param parent The parent widget.
+ */
+TimersPanel::TimersPanel(CountdownTimers *timers, QWidget *parent)
+    : QWidget(parent), countdownTimers(timers), stopwatch(timers->clock()) {
+    setWindowTitle("Timers");
+    setWindowFlags(Qt::Window);
+    resize(420, 560);
+
+    // Timers
+    QWidget *rowsWidget = new QWidget(this);
+    rowLayout = new QVBoxLayout(rowsWidget);
+    rowLayout->setAlignment(Qt::AlignTop);
+
+    QScrollArea *scrollArea = new QScrollArea(this);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(rowsWidget);
+
+    labelEdit = new QLineEdit(this);
+    labelEdit->setPlaceholderText("Label");
+    durationEdit = new QTimeEdit(QTime(0, 5), this);
+    durationEdit->setDisplayFormat("HH:mm:ss");
+    QPushButton *addButton = new QPushButton("Add Timer", this);
+    connect(addButton, &QPushButton::clicked, this, &TimersPanel::addTimer);
+
+    QHBoxLayout *addLayout = new QHBoxLayout();
+    addLayout->addWidget(labelEdit, 1);
+    addLayout->addWidget(durationEdit);
+    addLayout->addWidget(addButton);
+
+    QGroupBox *timersBox = new QGroupBox("Timers", this);
+    QVBoxLayout *timersLayout = new QVBoxLayout(timersBox);
+    timersLayout->addWidget(scrollArea);
+    timersLayout->addLayout(addLayout);
+
+    // Stopwatch
+    QFont bigFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    bigFont.setPointSize(24);
+    stopwatchLabel = new QLabel(this);
+    stopwatchLabel->setFont(bigFont);
+    stopwatchLabel->setAlignment(Qt::AlignCenter);
+    stopwatchButton = new QPushButton("Start", this);
+    QPushButton *lapButton = new QPushButton("Lap", this);
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    connect(stopwatchButton, &QPushButton::clicked, this, &TimersPanel::toggleStopwatch);
+    connect(lapButton, &QPushButton::clicked, this, &TimersPanel::recordLap);
+    connect(resetButton, &QPushButton::clicked, this, &TimersPanel::resetStopwatch);
+    lapList = new QListWidget(this);
+    lapList->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    QHBoxLayout *stopwatchButtons = new QHBoxLayout();
+    stopwatchButtons->addWidget(stopwatchButton);
+    stopwatchButtons->addWidget(lapButton);
+    stopwatchButtons->addWidget(resetButton);
+
+    QGroupBox *stopwatchBox = new QGroupBox("Stopwatch", this);
+    QVBoxLayout *stopwatchLayout = new QVBoxLayout(stopwatchBox);
+    stopwatchLayout->addWidget(stopwatchLabel);
+    stopwatchLayout->addLayout(stopwatchButtons);
+    stopwatchLayout->addWidget(lapList);
+
+    QPushButton *closeButton = new QPushButton("Close", this);
+    connect(closeButton, &QPushButton::clicked, this, &QWidget::close);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(timersBox, 3);
+    mainLayout->addWidget(stopwatchBox, 2);
+    mainLayout->addWidget(closeButton);
+
+    for (const CountdownTimer &timer : countdownTimers->timers()) {
+        onTimerAdded(timer.id);
+    }
+    connect(countdownTimers, &CountdownTimers::added, this, &TimersPanel::onTimerAdded);
+    connect(countdownTimers, &CountdownTimers::removed, this, &TimersPanel::onTimerRemoved);
+    connect(countdownTimers, &CountdownTimers::stateChanged, this, &TimersPanel::onTimerStateChanged);
+
+    frameTimer.setSingleShot(true);
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&frameTimer, &QTimer::timeout, this, &TimersPanel::renderFrame);
+}
+
+/**
+ * @brief Draws the current state as soon as the window appears.
+ */
+void TimersPanel::showEvent(QShowEvent *event) {
+    renderFrame();
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Stops drawing while hidden; the timers themselves keep running.
+ */
+void TimersPanel::hideEvent(QHideEvent *event) {
+    frameTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+/**
+ * @brief Reads the clock once, updates the changed texts and waits for the next change.
+ */
+void TimersPanel::renderFrame() {
+    RISE_PROFILE_SLOT("TimersPanel::renderFrame");
+    if (!isVisible()) return;
+
+    const qint64 now = countdownTimers->clock()->monotonicMSecs();
+    qint64 wait = -1;
+    for (const CountdownTimer &timer : countdownTimers->timers()) {
+        const auto row = rows.find(timer.id);
+        if (row == rows.end()) continue;
+
+        const qint64 left = timer.remainingAt(now);
+        const QString text = timer.finished ? QString("Done") : countdownText(left);
+        if (text != row->shownText) {
+            row->time->setText(text);
+            row->shownText = text;
+        }
+        // The text rounds up, so it next changes when left passes a whole second
+        if (timer.isRunning() && left > 0) {
+            const qint64 untilChange = (left - 1) % 1000 + 1;
+            wait = wait < 0 ? untilChange : qMin(wait, untilChange);
+        }
+    }
+
+    const QString text = stopwatchText(stopwatch.elapsedMs());
+    if (text != shownStopwatchText) {
+        stopwatchLabel->setText(text);
+        shownStopwatchText = text;
+    }
+    if (stopwatch.isRunning()) wait = frameMs;
+
+    if (wait >= 0) {
+        frameTimer.start(int(wait));
+    } else {
+        frameTimer.stop();
+    }
+}
+
+/**
+ * @brief Adds and starts a timer with the entered label and duration.
+ */
+void TimersPanel::addTimer() {
+    const qint64 duration = durationEdit->time().msecsSinceStartOfDay();
+    QString label = labelEdit->text().trimmed();
+    if (label.isEmpty()) label = QString("Timer %1").arg(countdownTimers->timers().size() + 1);
+
+    const quint64 id = countdownTimers->add(label, duration);
+    if (id == 0) return;
+    countdownTimers->start(id);
+    labelEdit->clear();
+}
+
+/**
+ * @brief Adds a row with the timer's name, time left and buttons.
+ */
+void TimersPanel::onTimerAdded(quint64 id) {
+    const CountdownTimer *timer = countdownTimers->find(id);
+    if (!timer || rows.contains(id)) return;
+
+    Row row;
+    row.container = new QWidget(this);
+    QLabel *name = new QLabel(timer->label, row.container);
+    row.time = new QLabel(row.container);
+    row.time->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    row.time->setMinimumWidth(row.time->fontMetrics().horizontalAdvance("00:00:00"));
+    row.time->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    row.startPause = new QPushButton(row.container);
+    QPushButton *reset = new QPushButton("Reset", row.container);
+    QPushButton *remove = new QPushButton("Remove", row.container);
+
+    connect(row.startPause, &QPushButton::clicked, this, [this, id]() {
+        const CountdownTimer *timer = countdownTimers->find(id);
+        if (timer && timer->isRunning()) countdownTimers->pause(id);
+        else countdownTimers->start(id);
+    });
+    connect(reset, &QPushButton::clicked, this, [this, id]() { countdownTimers->reset(id); });
+    connect(remove, &QPushButton::clicked, this, [this, id]() { countdownTimers->remove(id); });
+
+    QHBoxLayout *layout = new QHBoxLayout(row.container);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(name, 1);
+    layout->addWidget(row.time);
+    layout->addWidget(row.startPause);
+    layout->addWidget(reset);
+    layout->addWidget(remove);
+    rowLayout->addWidget(row.container);
+
+    rows.insert(id, row);
+    onTimerStateChanged(id);
+}
+
+/**
+ * @brief Removes a timer's row.
+ */
+void TimersPanel::onTimerRemoved(quint64 id) {
+    const Row row = rows.take(id);
+    if (!row.container) return;
+    rowLayout->removeWidget(row.container);
+    row.container->deleteLater();
+}
+
+/**
+ * @brief Relabels the start button and redraws on the next frame.
+ */
+void TimersPanel::onTimerStateChanged(quint64 id) {
+    const CountdownTimer *timer = countdownTimers->find(id);
+    const auto row = rows.find(id);
+    if (!timer || row == rows.end()) return;
+
+    row->startPause->setText(timer->isRunning() ? "Pause" : timer->finished ? "Restart" : "Start");
+    row->time->setStyleSheet(timer->finished ? "color: #c62828; font-weight: bold;" : QString());
+    requestFrame();
+}
+
+/**
+ * @brief Starts or stops the stopwatch.
+ */
+void TimersPanel::toggleStopwatch() {
+    if (stopwatch.isRunning()) {
+        stopwatch.stop();
+    } else {
+        stopwatch.start();
+    }
+    stopwatchButton->setText(stopwatch.isRunning() ? "Stop" : "Start");
+    requestFrame();
+}
+
+/**
+ * @brief Records a lap and lists it on top.
+ */
+void TimersPanel::recordLap() {
+    if (!stopwatch.isRunning()) return;
+    const qint64 length = stopwatch.lap();
+    lapList->insertItem(0, QString("Lap %1  %2  (%3)")
+                            .arg(stopwatch.splits().size(), 3)
+                            .arg(stopwatchText(length))
+                            .arg(stopwatchText(stopwatch.splits().last())));
+}
+
+/**
+ * @brief Sets the stopwatch back to zero.
+ */
+void TimersPanel::resetStopwatch() {
+    stopwatch.reset();
+    lapList->clear();
+    stopwatchButton->setText("Start");
+    requestFrame();
+}
+
+/**
+ * @brief Restarts the frame timer with no delay.
+ */
+void TimersPanel::requestFrame() {
+    if (isVisible()) frameTimer.start(0);
+}
+
+/**
+ * @brief Formats whole seconds, rounding up so a timer shows 0:00 only when it is done.
+ */
+QString TimersPanel::countdownText(qint64 ms) {
+    const qint64 seconds = (ms + 999) / 1000;
+    if (seconds >= 3600) {
+        return QString("%1:%2:%3").arg(seconds / 3600)
+                .arg(seconds / 60 % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+    }
+    return QString("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+/**
+ * @brief Formats elapsed time with hundredths of a second.
+ */
+QString TimersPanel::stopwatchText(qint64 ms) {
+    const qint64 seconds = ms / 1000;
+    const QString fraction = QString(".%1").arg(ms % 1000 / 10, 2, 10, QChar('0'));
+    if (seconds >= 3600) {
+        return QString("%1:%2:%3").arg(seconds / 3600)
+                .arg(seconds / 60 % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0')) + fraction;
+    }
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0')) + fraction;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file timingwheel.cpp
+ * @brief Implementation file for the TimingWheel class.
+ *
+ * The node array starts with one sentinel per bucket (10080 weekly buckets,
+ * then 4 levels of 64 one-shot buckets). Each bucket is a circular doubly
+ * linked list threaded through the array by index; entry nodes follow the
+ * sentinels and are recycled through a free list.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "timingwheel.h"
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Number of sentinel nodes at the start of the node array.
+ */
+constexpr std::uint32_t sentinelCount = TimingWheel::MinutesPerWeek + 4 * 64;
+
+} // namespace
+
+/**
+ * @brief Constructs an empty wheel.
+ * @param startMinute The wheel minute the wheel starts at.
+ */
+TimingWheel::TimingWheel(std::int64_t startMinute) : origin(startMinute) {
+    nodes.resize(sentinelCount);
+    for (std::uint32_t i = 0; i < sentinelCount; ++i) {
+        nodes[i].prev = i;
+        nodes[i].next = i;
+    }
+}
+
+/**
+ * @brief Pre-allocates entry nodes.
+ */
+void TimingWheel::reserve(std::size_t entries) {
+    nodes.reserve(sentinelCount + entries);
+}
+
+/**
+ * @brief Schedules a one-shot entry, clamping past minutes to the next minute.
+ */
+TimingWheel::Handle TimingWheel::scheduleAt(std::int64_t minute, std::uint64_t payload) {
+    std::int64_t relative = minute - origin;
+    if (relative <= current) relative = std::int64_t(current) + 1;
+    if (relative > std::numeric_limits<std::int32_t>::max()) relative = std::numeric_limits<std::int32_t>::max();
+
+    const std::uint32_t index = allocateNode();
+    nodes[index].payload = payload;
+    nodes[index].deadline = std::int32_t(relative);
+    place(index);
+    ++count;
+    return handleFor(index);
+}
+
+/**
+ * @brief Schedules a weekly entry in its minute-of-week bucket.
+ */
+TimingWheel::Handle TimingWheel::scheduleWeekly(int minuteOfWeek, std::uint64_t payload) {
+    const std::uint32_t index = allocateNode();
+    nodes[index].payload = payload;
+    nodes[index].deadline = -1;
+    linkBefore(weeklySentinel(minuteOfWeek), index);
+    ++count;
+    return handleFor(index);
+}
+
+/**
+ * @brief Unlinks and frees an entry.
+ */
+bool TimingWheel::cancel(Handle handle) {
+    if (!isLive(handle)) return false;
+    const std::uint32_t index = std::uint32_t(handle);
+    unlink(index);
+    freeNode(index);
+    --count;
+    return true;
+}
+
+/**
+ * @brief Frees every entry (invalidating all handles) and restarts at startMinute.
+ */
+void TimingWheel::clear(std::int64_t startMinute) {
+    for (std::uint32_t i = 0; i < sentinelCount; ++i) {
+        nodes[i].prev = i;
+        nodes[i].next = i;
+    }
+    for (std::uint32_t i = sentinelCount; i < nodes.size(); ++i) {
+        if (nodes[i].generation & 1u) freeNode(i);
+    }
+    origin = startMinute;
+    current = 0;
+    count = 0;
+}
+
+/**
+ * @brief Takes a node from the free list (or grows the array) and marks it live.
+ */
+std::uint32_t TimingWheel::allocateNode() {
+    std::uint32_t index;
+    if (freeList != Nil) {
+        index = freeList;
+        freeList = nodes[index].next;
+    } else {
+        index = std::uint32_t(nodes.size());
+        nodes.emplace_back();
+    }
+    ++nodes[index].generation; // Odd: in use
+    return index;
+}
+
+/**
+ * @brief Returns a node to the free list, invalidating its handles.
+ */
+void TimingWheel::freeNode(std::uint32_t index) {
+    ++nodes[index].generation; // Even: free
+    nodes[index].prev = Nil;
+    nodes[index].next = freeList;
+    freeList = index;
+}
+
+/**
+ * @brief Appends a node to the bucket whose sentinel is given.
+ */
+void TimingWheel::linkBefore(std::uint32_t sentinel, std::uint32_t index) {
+    const std::uint32_t last = nodes[sentinel].prev;
+    nodes[index].prev = last;
+    nodes[index].next = sentinel;
+    nodes[last].next = index;
+    nodes[sentinel].prev = index;
+}
+
+/**
+ * @brief Removes a node from whatever bucket it is in.
+ */
+void TimingWheel::unlink(std::uint32_t index) {
+    const std::uint32_t prev = nodes[index].prev;
+    const std::uint32_t next = nodes[index].next;
+    nodes[prev].next = next;
+    nodes[next].prev = prev;
+}
+
+/**
+ * @brief Puts a one-shot node into the lowest level whose range covers its deadline.
+ *
+ * Deadlines beyond the top level go into the top-level bucket visited last,
+ * and are placed again when that bucket cascades.
+ */
+void TimingWheel::place(std::uint32_t index) {
+    const std::int64_t deadline = nodes[index].deadline;
+    const std::int64_t delta = deadline - current;
+
+    for (int level = 0; level < LevelCount; ++level) {
+        if (delta < (std::int64_t(1) << (LevelBits * (level + 1)))) {
+            linkBefore(levelSentinel(level, int((deadline >> (LevelBits * level)) & (LevelSize - 1))), index);
+            return;
+        }
+    }
+
+    const int top = LevelCount - 1;
+    const int slot = int(((current >> (LevelBits * top)) + LevelSize - 1) & (LevelSize - 1));
+    linkBefore(levelSentinel(top, slot), index);
+}
+
+/**
+ * @brief Redistributes the current bucket of a level into lower levels.
+ */
+void TimingWheel::cascade(int level) {
+    const std::uint32_t sentinel = levelSentinel(level, int((current >> (LevelBits * level)) & (LevelSize - 1)));
+
+    // Detach the whole list first so that re-placing into the same bucket cannot loop
+    std::uint32_t index = nodes[sentinel].next;
+    nodes[nodes[sentinel].prev].next = Nil;
+    nodes[sentinel].prev = sentinel;
+    nodes[sentinel].next = sentinel;
+
+    while (index != sentinel && index != Nil) {
+        const std::uint32_t next = nodes[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+/**
+ * @brief Moves to the next minute and collects every entry due in it into scratch.
+ */
+void TimingWheel::collectNextMinute() {
+    scratch.clear();
+    ++current;
+
+    // Higher levels first, so their entries can land in the buckets cascaded next
+    for (int level = LevelCount - 1; level >= 1; --level) {
+        if ((current & ((std::int64_t(1) << (LevelBits * level)) - 1)) == 0) {
+            cascade(level);
+        }
+    }
+
+    const std::uint32_t oneShots = levelSentinel(0, int(current & (LevelSize - 1)));
+    while (nodes[oneShots].next != oneShots) {
+        const std::uint32_t index = nodes[oneShots].next;
+        unlink(index);
+        scratch.push_back({nodes[index].payload, handleFor(index), false});
+        freeNode(index);
+        --count;
+    }
+
+    const std::uint32_t weekly = weeklySentinel(origin + current);
+    for (std::uint32_t index = nodes[weekly].next; index != weekly; index = nodes[index].next) {
+        scratch.push_back({nodes[index].payload, handleFor(index), true});
+    }
+}
+
+/**
+ * @brief Checks whether a handle still refers to a scheduled entry.
+ */
+bool TimingWheel::isLive(Handle handle) const {
+    const std::uint32_t index = std::uint32_t(handle);
+    return index >= sentinelCount && index < nodes.size()
+           && (nodes[index].generation & 1u)
+           && nodes[index].generation == std::uint32_t(handle >> 32);
+}
+
+/**
+ * @brief Builds the handle of a live node.
+ */
+TimingWheel::Handle TimingWheel::handleFor(std::uint32_t index) const {
+    return (Handle(nodes[index].generation) << 32) | index;
+}
+
+/**
+ * @brief Returns the sentinel of the weekly bucket for a wheel minute.
+ */
+std::uint32_t TimingWheel::weeklySentinel(std::int64_t minute) const {
+    return std::uint32_t(((minute % MinutesPerWeek) + MinutesPerWeek) % MinutesPerWeek);
+}
+
+/**
+ * @brief Returns the sentinel of a one-shot bucket.
+ */
+std::uint32_t TimingWheel::levelSentinel(int level, int slot) const {
+    return std::uint32_t(MinutesPerWeek + level * LevelSize + slot);
+}
@@ -11,190 +11,385 @@
 
 #include "viewAlarm.h"
 #include "alarm_details.h"
+#include "historyview.h"
+#include "slotprofiler.h"
 #include <QHBoxLayout>
+#include <QPainter>
+#include <QTabWidget>
+#include <QVariant>
 #include <QDebug>
+#include <algorithm>
 
 /**
- * @brief Constructs a ViewAlarm window.
- * Initializes the window with a scrollable list of alarms and a close button.
- * @param parent The parent widget (default is nullptr).
+ * @brief Constructs the model and reads the ids of the store's alarms.
  */
+AlarmListModel::AlarmListModel(AlarmStore *store, NextFireIndex *nextFires, ClockSource *clock, QObject *parent)
+    : QAbstractListModel(parent), alarmStore(store), nextFireIndex(nextFires),
+      clockSource(clock ? clock : ClockSource::system()) {
+    reload();
+}
 
-ViewAlarm::ViewAlarm(QWidget *parent) : QWidget(parent) {
-    setWindowTitle("View Alarms");
-    this->resize(400, 300);
-    
-    setWindowFlags(Qt::Window);
-
-    QVBoxLayout *mainLayout = new QVBoxLayout(this);
-
-    QLabel *titleLabel = new QLabel("Active Alarms:", this);
-    mainLayout->addWidget(titleLabel);
-
-    // Scrollable area to hold buttons
-    QScrollArea *scrollArea = new QScrollArea(this);
-    scrollArea->setWidgetResizable(true);
-
-    QWidget *scrollWidget = new QWidget();
-    alarmsLayout = new QVBoxLayout(scrollWidget);
-    scrollWidget->setLayout(alarmsLayout);
-
-    scrollArea->setWidget(scrollWidget);
-    mainLayout->addWidget(scrollArea);
-
-    // Close button
-    QPushButton *closeButton = new QPushButton("Close", this);
-    mainLayout->addWidget(closeButton);
-    connect(closeButton, &QPushButton::clicked, this, &QWidget::close);
-
-    setLayout(mainLayout);
+int AlarmListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rowIds.size();
 }
 
 /**
- * @brief Updates the displayed alarm list, replacing each alarm with a button.
- * 
- * This method clears the existing alarm buttons and repopulates the list based on the
- * provided newAlarms and newLabels.
- * 
- * @param newAlarms A list of QTime objects representing the alarm times.
- * @param newLabels A list of QString objects representing the alarm labels.
- */
-void ViewAlarm::updateAlarmList(const QList<QTime> &newAlarms, const QList<QString> &newLabels, const QList<QString> &newRepeats, const QList<bool> &isSnoozed) {
-    alarms = newAlarms;
-    alarmLabels = newLabels;
-    alarmRepeats = newRepeats;
-    alarmIsSnoozed = isSnoozed;
-
-    // Clear old buttons
-    QLayoutItem *child;
-    while ((child = alarmsLayout->takeAt(0)) != nullptr) {
-        if (child->widget()) {
-            child->widget()->deleteLater();
-        }
-        delete child;
+ * @brief Reads a row's alarm from the store, and its countdown from the current NextFireTable.
+ *
+ * An alarm removed from the store since the last batch has no data; its
+ * row goes with the next batch.
+ */
+QVariant AlarmListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowIds.size()) return QVariant();
+    const quint64 id = rowIds[index.row()];
+    if (role == AlarmIdRole) return id;
+
+    const Alarm *alarm = alarmStore->find(id);
+    if (!alarm) return QVariant();
+    switch (role) {
+    case Qt::DisplayRole:
+        return alarmText(*alarm);
+    case EnabledRole:
+        return alarm->enabled;
+    case CountdownRole: {
+        if (!nextFireIndex) return QString();
+        const qint64 fireAt = nextFireIndex->table()->fireAtOf(id);
+        if (fireAt == NextFireTable::NoFire) return QString();
+        return countdownText(fireAt - clockSource->currentDateTimeUtc().toMSecsSinceEpoch());
+    }
+    default:
+        return QVariant();
     }
-    alarmButtons.clear();
+}
 
+/**
+ * @brief Takes the ids of the store's current alarms as the rows.
+ */
+void AlarmListModel::reload() {
+    beginResetModel();
+    const QVector<Alarm> &alarms = alarmStore->alarms();
+    rowIds.resize(alarms.size());
     for (int i = 0; i < alarms.size(); ++i) {
-        QString alarmText = alarmLabels[i];
-
-        // Only add (Snoozed) if not already in the label
-        if (isSnoozed[i] && !alarmText.contains("(Snoozed)")) {
-            alarmText += " (Snoozed)";
-        }
-
-        alarmText += " - " + alarms[i].toString("HH:mm");
-
-
-        QPushButton *alarmButton = new QPushButton(alarmText, this);
-        alarmButton->setStyleSheet("QPushButton { background-color: #bb86fc; color: white; border-radius: 5px; padding: 10px; }");
-        connect(alarmButton, &QPushButton::clicked, this, &ViewAlarm::handleAlarmClick);
-
-        alarmButtons.insert(alarmButton, alarmLabels[i]);
-        alarmsLayout->addWidget(alarmButton);
+        rowIds[i] = alarms[i].id;
     }
+    shownVersion = alarmStore->version();
+    endResetModel();
 }
 
-
-
 /**
- * @brief Handles alarm button clicks by opening a new window with alarm details.
- * 
- * This method retrieves the clicked alarm's details and opens an AlarmDetails
- * dialog, allowing the user to modify or delete the alarm.
+ * @brief Turns store deltas into row insertions, removals and data changes.
+ *
+ * New alarms get the highest ids so far, so inserting each one at its
+ * place among the ascending ids reproduces the store order.
  */
+void AlarmListModel::applyChanges(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes) {
+    // Resetting is cheaper than announcing most of the list one row at a time
+    if (fromVersion != shownVersion || changes.size() > rowIds.size() / 2 + 16) {
+        reload();
+        return;
+    }
 
-void ViewAlarm::handleAlarmClick() {
+    for (const AlarmChange &change : changes) {
+        switch (change.kind) {
+        case AlarmChange::Removed: {
+            const int row = rowOf(change.id);
+            if (row < 0) break;
+            beginRemoveRows(QModelIndex(), row, row);
+            rowIds.remove(row);
+            endRemoveRows();
+            break;
+        }
+        case AlarmChange::Updated: {
+            const int row = rowOf(change.id);
+            if (row >= 0) emit dataChanged(index(row), index(row));
+            break;
+        }
+        case AlarmChange::Added: {
+            const int row = int(std::lower_bound(rowIds.cbegin(), rowIds.cend(), change.id) - rowIds.cbegin());
+            beginInsertRows(QModelIndex(), row, row);
+            rowIds.insert(row, change.id);
+            endInsertRows();
+            break;
+        }
+        }
+    }
+    shownVersion = toVersion;
+}
 
-    QPushButton *senderButton = qobject_cast<QPushButton*>(sender());
+void AlarmListModel::refreshCountdowns(int first, int last) {
+    if (first > last) return;
+    emit dataChanged(index(first), index(last), {CountdownRole});
+}
 
-    if (senderButton && alarmButtons.contains(senderButton)) {
-        QString alarmLabel = alarmButtons.value(senderButton);
-        qDebug() << "Alarm clicked:" << alarmLabel;
+int AlarmListModel::rowOf(quint64 id) const {
+    const auto it = std::lower_bound(rowIds.cbegin(), rowIds.cend(), id);
+    return it != rowIds.cend() && *it == id ? int(it - rowIds.cbegin()) : -1;
+}
 
-        int index = alarmLabels.indexOf(alarmLabel);
-        if (index == -1) return; // If alarm is not found, return
+/**
+ * @brief Builds the "label - HH:mm:ss [group]" text of an alarm row.
+ */
+QString AlarmListModel::alarmText(const Alarm &alarm) {
+    QString text = alarm.displayLabel() + " - " + alarm.time.toString("HH:mm:ss");
+    if (!alarm.group.isEmpty()) text += " [" + alarm.group.toString() + "]";
+    if (!alarm.enabled) text += " (Off)";
+    return text;
+}
 
-        QTime alarmTime = alarms[index];
+/**
+ * @brief Formats the time left until an alarm rings.
+ */
+QString AlarmListModel::countdownText(qint64 msecs) {
+    if (msecs <= 0) return "now";
+    if (msecs <= 60000) return QString("in %1s").arg((msecs + 999) / 1000);
+
+    const qint64 minutes = (msecs + 59999) / 60000;
+    if (minutes < 60) return QString("in %1m").arg(minutes);
+    if (minutes < 24 * 60) return QString("in %1h %2m").arg(minutes / 60).arg(minutes % 60);
+    return QString("in %1d %2h").arg(minutes / (24 * 60)).arg(minutes % (24 * 60) / 60);
+}
 
-        // Open AlarmDetails with real alarm values
-        QString repeat = alarmRepeats[index];
-        AlarmDetails *detailsWindow = new AlarmDetails(alarmTime, repeat, alarmLabel, "Default", this);
+/**
+ * @brief Paints the rounded background, the label at the left and the countdown at the right.
+ *
+ * Rows look like the app's buttons: white text with 10 px padding on
+ * purple, or on grey for a disabled alarm.
+ */
+void AlarmItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    const QRect box = option.rect.adjusted(0, 2, 0, -2);
+    QColor background(index.data(AlarmListModel::EnabledRole).toBool() ? "#bb86fc" : "#9e9e9e");
+    if (option.state & QStyle::State_MouseOver) background = background.lighter(110);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(background);
+    painter->drawRoundedRect(box, 5, 5);
+
+    painter->setPen(Qt::white);
+    painter->setFont(option.font);
+    QRect textRect = box.adjusted(10, 0, -10, 0);
+    const QString countdown = index.data(AlarmListModel::CountdownRole).toString();
+    if (!countdown.isEmpty()) {
+        painter->drawText(textRect, Qt::AlignRight | Qt::AlignVCenter, countdown);
+        textRect.setRight(textRect.right() - option.fontMetrics.horizontalAdvance(countdown) - 10);
+    }
+    const QString label = option.fontMetrics.elidedText(index.data().toString(), Qt::ElideRight, textRect.width());
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, label);
+    painter->restore();
+}
 
-        // Connect modifications
-        connect(detailsWindow, &AlarmDetails::alarmModified, this, [=, &index](QTime newTime, QString newRepeat, QString newLabel, QString newSound) {
-            qDebug() << "[VIEW ALARM] Received newRepeat:" << newRepeat;
+/**
+ * @brief Returns the same height for every row: one line of text with its padding.
+ */
+QSize AlarmItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const {
+    return QSize(200, option.fontMetrics.height() + 24);
+}
 
-            alarms[index] = newTime;
-            alarmRepeats[index] = newRepeat;
-            alarmLabels[index] = newLabel;
+/**
+ * @brief Constructs a ViewAlarm window.
+ * Initializes the window with a scrollable list of alarms and a close button.
+ * @param store The alarm store to display and edit.
+ * @param calendars Holiday calendars offered in the details dialog.
+ * @param history Event history for the History tab (may be nullptr).
+ * @param nextFires Next fire instants for the countdowns (may be nullptr).
+ * @param clock Clock the countdowns run against.
+ * @param sounds Sounds offered in the details dialog (may be nullptr).
+ * @param parent The parent widget (default is nullptr).
+ */
 
-            qDebug() << "[VIEW ALARM] alarmRepeats[" << index << "] after update:" << alarmRepeats[index];
-            qDebug() << "[VIEW ALARM] Full alarmRepeats list:" << alarmRepeats;
+ViewAlarm::ViewAlarm(AlarmStore *store, HolidayCalendars *calendars, AlarmHistory *history,
+                     NextFireIndex *nextFires, ClockSource *clock, const SoundLibrary *sounds, QWidget *parent)
+    : QWidget(parent), alarmStore(store), holidayCalendars(calendars), nextFireIndex(nextFires), soundLibrary(sounds) {
+    setWindowTitle("View Alarms");
+    this->resize(400, 300);
+    
+    setWindowFlags(Qt::Window);
 
-            QString oldLabel = alarmLabels[index];
-            alarmLabels[index] = newLabel;
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
 
-            alarms[index] = newTime;
-            alarmRepeats[index] = newRepeat;
-            alarmLabels[index] = newLabel;
+    QWidget *alarmsTab = new QWidget(this);
+    QVBoxLayout *alarmsTabLayout = new QVBoxLayout(alarmsTab);
+    alarmsTabLayout->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *titleLabel = new QLabel("Active Alarms:", alarmsTab);
+    alarmsTabLayout->addWidget(titleLabel);
+
+    // Switches whole groups without opening every alarm
+    groupBar = new QWidget(alarmsTab);
+    QHBoxLayout *groupLayout = new QHBoxLayout(groupBar);
+    groupLayout->setContentsMargins(0, 0, 0, 0);
+    groupComboBox = new QComboBox(groupBar);
+    QPushButton *enableGroupButton = new QPushButton("Enable Group", groupBar);
+    QPushButton *disableGroupButton = new QPushButton("Disable Group", groupBar);
+    connect(enableGroupButton, &QPushButton::clicked, this, [this]() { setSelectedGroupEnabled(true); });
+    connect(disableGroupButton, &QPushButton::clicked, this, [this]() { setSelectedGroupEnabled(false); });
+    groupLayout->addWidget(groupComboBox, 1);
+    groupLayout->addWidget(enableGroupButton);
+    groupLayout->addWidget(disableGroupButton);
+    groupBar->hide();
+    alarmsTabLayout->addWidget(groupBar);
+
+    // One view over a model instead of a widget per alarm; only the visible rows are painted
+    alarmModel = new AlarmListModel(alarmStore, nextFireIndex, clock, this);
+    alarmList = new QListView(alarmsTab);
+    alarmList->setModel(alarmModel);
+    alarmList->setItemDelegate(new AlarmItemDelegate(alarmList));
+    alarmList->setUniformItemSizes(true);
+    alarmList->setSelectionMode(QAbstractItemView::NoSelection);
+    alarmList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    alarmList->setMouseTracking(true);
+    connect(alarmList, &QListView::clicked, this, &ViewAlarm::handleAlarmClick);
+    alarmsTabLayout->addWidget(alarmList);
+
+    if (history) {
+        QTabWidget *tabs = new QTabWidget(this);
+        tabs->addTab(alarmsTab, "Alarms");
+        tabs->addTab(new HistoryView(history, tabs), "History");
+        mainLayout->addWidget(tabs);
+    } else {
+        mainLayout->addWidget(alarmsTab);
+    }
 
-            // Update the button-to-label mapping
-            for (auto it = alarmButtons.begin(); it != alarmButtons.end(); ++it) {
-                if (it.value() == oldLabel) {
-                    alarmButtons[it.key()] = newLabel;
-                    break;
-                }
-            }
+    // Close button
+    QPushButton *closeButton = new QPushButton("Close", this);
+    mainLayout->addWidget(closeButton);
+    connect(closeButton, &QPushButton::clicked, this, &QWidget::close);
 
-            // Re-render the UI
-            updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
+    setLayout(mainLayout);
 
-            emit alarmModified(index, newTime, newRepeat, newLabel, newSound);
+    changeTracker = new AlarmChangeTracker(alarmStore, this);
+    changeTracker->setPaused(true);
+    connect(changeTracker, &AlarmChangeTracker::changesReady, this, &ViewAlarm::applyChanges);
 
-        });
+    if (nextFireIndex) {
+        // Rows scrolled into view read their countdown as they are painted; the timer moves the visible ones on
+        countdownTimer.setInterval(1000);
+        connect(&countdownTimer, &QTimer::timeout, this, &ViewAlarm::updateVisibleCountdowns);
+        connect(nextFireIndex, &NextFireIndex::tableChanged, this, &ViewAlarm::updateVisibleCountdowns);
+    }
+    updateGroupBar();
+}
 
+/**
+ * @brief Brings the list up to date before the window appears.
+ */
+void ViewAlarm::showEvent(QShowEvent *event) {
+    changeTracker->flush();
+    changeTracker->setPaused(false);
+    if (nextFireIndex) countdownTimer.start();
+    QWidget::showEvent(event);
+    updateVisibleCountdowns();
+}
 
+/**
+ * @brief Stops updating the list while nobody can see it.
+ */
+void ViewAlarm::hideEvent(QHideEvent *event) {
+    changeTracker->setPaused(true);
+    countdownTimer.stop();
+    QWidget::hideEvent(event);
+}
 
-        // Connect deletions
-        connect(detailsWindow, &AlarmDetails::alarmDeleted, this, &ViewAlarm::removeAlarm);
+/**
+ * @brief Hands the deltas to the model and refreshes the group bar.
+ */
+void ViewAlarm::applyChanges(quint64 fromVersion, quint64 toVersion, const QVector<AlarmChange> &changes) {
+    RISE_PROFILE_SLOT("ViewAlarm::applyChanges");
+    alarmModel->applyChanges(fromVersion, toVersion, changes);
+    updateGroupBar();
+}
 
-        detailsWindow->exec();
+/**
+ * @brief Lists the store's groups in the group bar, keeping the current selection.
+ */
+void ViewAlarm::updateGroupBar() {
+    const QStringList groups = alarmStore->groupNames();
+    if (groups != shownGroups) {
+        const QString selected = groupComboBox->currentText();
+        groupComboBox->clear();
+        groupComboBox->addItems(groups);
+        groupComboBox->setCurrentIndex(qMax(0, groups.indexOf(selected)));
+        shownGroups = groups;
     }
+    groupBar->setVisible(!groups.isEmpty());
 }
 
-
 /**
- * @brief Removes an alarm from the UI and the stored list.
- * This method deletes the alarm from both the UI and the internal alarm list
- * when the user chooses to remove an alarm.
- * @param alarmLabel The label of the alarm to be removed.
+ * @brief Writes the new state of the selected group's alarms to the store in one change.
  */
+void ViewAlarm::setSelectedGroupEnabled(bool enabled) {
+    const QString group = groupComboBox->currentText();
+    if (group.isEmpty()) return;
+    const int changed = alarmStore->setGroupEnabled(group, enabled);
+    qDebug() << "[VIEW ALARM]" << (enabled ? "Enabled" : "Disabled") << changed << "alarms of group" << group;
+}
 
-void ViewAlarm::removeAlarm(const QString &alarmLabel) {
-    qDebug() << "Removing alarm:" << alarmLabel;
+/**
+ * @brief Reports the rows between the viewport's top and bottom edges as changed.
+ */
+void ViewAlarm::updateVisibleCountdowns() {
+    if (!nextFireIndex || !isVisible()) return;
+    RISE_PROFILE_SLOT("ViewAlarm::updateVisibleCountdowns");
+
+    const int rows = alarmModel->rowCount();
+    if (rows == 0) return;
+    const QModelIndex top = alarmList->indexAt(QPoint(0, 0));
+    const QModelIndex bottom = alarmList->indexAt(QPoint(0, alarmList->viewport()->height() - 1));
+    alarmModel->refreshCountdowns(top.isValid() ? top.row() : 0, bottom.isValid() ? bottom.row() : rows - 1);
+}
 
-    // Find the index of the alarm in the list
-    int index = alarmLabels.indexOf(alarmLabel);
-    if (index == -1) return;
 
-    // Remove alarm details from lists
-    alarms.removeAt(index);
-    alarmLabels.removeAt(index);
-    alarmRepeats.removeAt(index);  
 
-    // Remove the corresponding button from the UI
-    for (auto it = alarmButtons.begin(); it != alarmButtons.end(); ++it) {
-        if (it.value() == alarmLabel) {
-            delete it.key(); 
-            alarmButtons.erase(it);
-            break;
-        }
-    }
+/**
+ * @brief Handles alarm row clicks by opening a new window with alarm details.
+ * 
+ * This method retrieves the clicked alarm's details and opens an AlarmDetails
+ * dialog, allowing the user to modify or delete the alarm. Changes are
+ * written to the store, which notifies every view (including this one).
+ */
 
-    emit alarmDeleted(alarmLabel); 
-    
-    // Refresh the UI with the updated alarm list
-    updateAlarmList(alarms, alarmLabels, alarmRepeats, alarmIsSnoozed);
+void ViewAlarm::handleAlarmClick(const QModelIndex &index) {
+    RISE_PROFILE_SLOT("ViewAlarm::handleAlarmClick");
+
+    const quint64 alarmId = index.data(AlarmListModel::AlarmIdRole).toULongLong();
+    const Alarm *alarm = alarmStore->find(alarmId);
+    if (!alarm) return; // If alarm is not found, return
+
+    qDebug() << "Alarm clicked:" << alarm->label;
+
+    // Open AlarmDetails with real alarm values
+    AlarmDetails *detailsWindow = new AlarmDetails(alarm->time, alarm->repeat, alarm->label.toString(), alarm->sound, alarm->calendar,
+                                                   alarm->group.toString(), alarm->enabled,
+                                                   holidayCalendars ? holidayCalendars->names() : QStringList(),
+                                                   alarmStore->groupNames(), soundLibrary, this);
+    detailsWindow->setAttribute(Qt::WA_DeleteOnClose); // One dialog per click, so free it afterwards
+
+    // Connect modifications
+    connect(detailsWindow, &AlarmDetails::alarmModified, this, [=](QTime newTime, QString newRepeat, QString newLabel, QString newSound, QString newCalendar,
+                                                                   QString newGroup, bool newEnabled) {
+        qDebug() << "[VIEW ALARM] Received newRepeat:" << newRepeat;
+
+        const Alarm *current = alarmStore->find(alarmId);
+        if (!current) return;
+
+        Alarm modified = *current;
+        modified.time = newTime;
+        modified.originalTime = newTime;
+        modified.repeat = newRepeat;
+        modified.label = newLabel;
+        modified.sound = newSound;
+        modified.calendar = newCalendar;
+        modified.group = newGroup;
+        modified.enabled = newEnabled;
+        alarmStore->update(modified);
+    });
+
+    // Connect deletions
+    connect(detailsWindow, &AlarmDetails::alarmDeleted, this, [=](const QString &alarmLabel) {
+        qDebug() << "Removing alarm:" << alarmLabel;
+        alarmStore->remove(alarmId);
+    });
+
+    detailsWindow->exec();
 }
-
@@ -0,0 +1,207 @@
+/**
+ * @file worldclockpanel.cpp
+ * @brief Implementation file for the WorldClockPanel class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "worldclockpanel.h"
+#include "slotprofiler.h"
+#include <QDebug>
+#include <QHBoxLayout>
+#include <QScrollArea>
+#include <QVBoxLayout>
+
+/**
+ * @brief Builds the window and adds a few well-known zones.
+ * @param clock Clock to read the time from.
+ * @param parent The parent widget.
+ */
+WorldClockPanel::WorldClockPanel(ClockSource *clock, QWidget *parent)
+    : QWidget(parent), clockSource(clock ? clock : ClockSource::system()) {
+    setWindowTitle("World Clock");
+    setWindowFlags(Qt::Window);
+    resize(460, 480);
+
+    offsets.addZone(QTimeZone::systemTimeZone());
+
+    QWidget *rowsWidget = new QWidget(this);
+    grid = new QGridLayout(rowsWidget);
+    grid->setColumnStretch(1, 1);
+    grid->setAlignment(Qt::AlignTop);
+
+    QScrollArea *scrollArea = new QScrollArea(this);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(rowsWidget);
+
+    zonePicker = new QComboBox(this);
+    QPushButton *addButton = new QPushButton("Add", this);
+    connect(addButton, &QPushButton::clicked, this, &WorldClockPanel::addSelectedZone);
+#ifdef RISE_KIOSK
+    // Like the ClockWidget, the kiosk build does not load the list of every known zone
+    zonePicker->hide();
+    addButton->hide();
+#else
+    for (const QByteArray &zoneId : QTimeZone::availableTimeZoneIds()) {
+        zonePicker->addItem(QString(zoneId));
+    }
+#endif
+
+    QHBoxLayout *pickerLayout = new QHBoxLayout();
+    pickerLayout->addWidget(zonePicker, 1);
+    pickerLayout->addWidget(addButton);
+
+    QPushButton *closeButton = new QPushButton("Close", this);
+    connect(closeButton, &QPushButton::clicked, this, &QWidget::close);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(scrollArea);
+    mainLayout->addLayout(pickerLayout);
+    mainLayout->addWidget(closeButton);
+
+    for (const char *zoneId : {"UTC", "America/Los_Angeles", "America/New_York", "Europe/London",
+                               "Europe/Berlin", "Asia/Kolkata", "Asia/Tokyo", "Australia/Sydney"}) {
+        addZone(zoneId);
+    }
+
+    tickTimer.setTimerType(Qt::CoarseTimer);
+    connect(&tickTimer, &QTimer::timeout, this, &WorldClockPanel::tick);
+}
+
+/**
+ * @brief Adds a row for a zone.
+ */
+bool WorldClockPanel::addZone(const QByteArray &zoneId) {
+    const QTimeZone zone(zoneId);
+    if (!zone.isValid()) return false;
+    for (const Row &row : rows) {
+        if (row.zoneId == zoneId) return false;
+    }
+
+    Row row;
+    row.zoneId = zoneId;
+    const int slash = zoneId.lastIndexOf('/');
+    row.name = new QLabel(QString(zoneId.mid(slash + 1)).replace('_', ' '), this);
+    row.name->setToolTip(QString(zoneId));
+    row.face = new ClockFace(this);
+    row.face->setFixedHeight(36);
+    row.detail = new QLabel(this);
+    row.remove = new QPushButton("Remove", this);
+    connect(row.remove, &QPushButton::clicked, this, [this, zoneId]() { removeZone(zoneId); });
+
+    const int line = rows.size();
+    grid->addWidget(row.name, line, 0);
+    grid->addWidget(row.face, line, 1);
+    grid->addWidget(row.detail, line, 2);
+    grid->addWidget(row.remove, line, 3);
+
+    offsets.addZone(zone);
+    rows.append(row);
+    if (isVisible()) tick();
+    return true;
+}
+
+/**
+ * @brief Removes the row of a zone and moves the rows below it up.
+ */
+void WorldClockPanel::removeZone(const QByteArray &zoneId) {
+    int index = 0;
+    while (index < rows.size() && rows[index].zoneId != zoneId) ++index;
+    if (index == rows.size()) return;
+
+    for (QWidget *widget : {static_cast<QWidget *>(rows[index].name), static_cast<QWidget *>(rows[index].face),
+                            static_cast<QWidget *>(rows[index].detail), static_cast<QWidget *>(rows[index].remove)}) {
+        grid->removeWidget(widget);
+        widget->deleteLater();
+    }
+    rows.remove(index);
+    offsets.removeZone(index + 1);
+
+    // QGridLayout cannot delete a line, so re-add the rows below it one line up
+    for (int line = index; line < rows.size(); ++line) {
+        const Row &row = rows[line];
+        grid->addWidget(row.name, line, 0);
+        grid->addWidget(row.face, line, 1);
+        grid->addWidget(row.detail, line, 2);
+        grid->addWidget(row.remove, line, 3);
+    }
+}
+
+/**
+ * @brief Returns the shown zone ids.
+ */
+QList<QByteArray> WorldClockPanel::zones() const {
+    QList<QByteArray> ids;
+    for (const Row &row : rows) {
+        ids.append(row.zoneId);
+    }
+    return ids;
+}
+
+/**
+ * @brief Starts ticking when shown.
+ */
+void WorldClockPanel::showEvent(QShowEvent *event) {
+    tick();
+    tickTimer.start(1000);
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Stops ticking while hidden.
+ */
+void WorldClockPanel::hideEvent(QHideEvent *event) {
+    tickTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+/**
+ * @brief Reads the clock once and updates every row from it.
+ */
+void WorldClockPanel::tick() {
+    RISE_PROFILE_SLOT("WorldClockPanel::tick");
+    const qint64 utc = clockSource->currentDateTimeUtc().toMSecsSinceEpoch();
+    const int recomputed = offsets.update(utc);
+    if (recomputed > 0) {
+        qDebug() << "[WORLDCLOCK] Refreshed offsets of" << recomputed << "zones";
+    }
+
+    const qint64 localDay = offsets.localTime(0, utc).julianDay;
+    for (int i = 0; i < rows.size(); ++i) {
+        Row &row = rows[i];
+        const ZoneOffsetTable::LocalTime local = offsets.localTime(i + 1, utc);
+        row.face->setTime(local.hour, local.minute, local.second);
+
+        const int offset = offsets.offsetSeconds(i + 1);
+        const qint64 dayDelta = local.julianDay - localDay;
+        if (offset != row.shownOffset || dayDelta != row.shownDayDelta) {
+            row.detail->setText(caption(dayDelta, offset));
+            row.shownOffset = offset;
+            row.shownDayDelta = dayDelta;
+        }
+    }
+}
+
+/**
+ * @brief Adds the zone selected in the picker.
+ */
+void WorldClockPanel::addSelectedZone() {
+    addZone(zonePicker->currentText().toUtf8());
+}
+
+/**
+ * @brief Formats the day difference and UTC offset of a zone.
+ */
+QString WorldClockPanel::caption(qint64 dayDelta, int offsetSeconds) {
+    QString day = "Today";
+    if (dayDelta == 1) day = "Tomorrow";
+    else if (dayDelta == -1) day = "Yesterday";
+
+    const int minutes = qAbs(offsetSeconds) / 60;
+    return QString("%1, UTC%2%3:%4")
+            .arg(day)
+            .arg(offsetSeconds < 0 ? '-' : '+')
+            .arg(minutes / 60, 2, 10, QChar('0'))
+            .arg(minutes % 60, 2, 10, QChar('0'));
+}
@@ -0,0 +1,93 @@
+/**
+ * @file zoneoffsettable.cpp
+ * @brief Implementation file for the ZoneOffsetTable class.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include "zoneoffsettable.h"
+#include <QDateTime>
+
+namespace {
+
+/**
+ * @brief Julian day of 1970-01-01.
+ */
+const qint64 epochJulianDay = 2440588;
+
+/**
+ * @brief Re-check interval for zones whose backend cannot list transitions.
+ */
+const qint64 fallbackValidityMSecs = 60 * 60 * 1000;
+
+/**
+ * @brief Rounds a division towards minus infinity.
+ */
+qint64 floorDiv(qint64 value, qint64 divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+} // namespace
+
+/**
+ * @brief Adds a zone; its offset is looked up on the next update().
+ */
+int ZoneOffsetTable::addZone(const QTimeZone &zone) {
+    Entry entry;
+    entry.zone = zone;
+    entries.append(entry);
+    return entries.size() - 1;
+}
+
+/**
+ * @brief Removes a zone.
+ */
+void ZoneOffsetTable::removeZone(int index) {
+    entries.remove(index);
+}
+
+/**
+ * @brief Refreshes the zones whose cached interval does not cover the instant.
+ */
+int ZoneOffsetTable::update(qint64 utcMSecs) {
+    int recomputed = 0;
+    for (Entry &entry : entries) {
+        if (utcMSecs >= entry.validFrom && utcMSecs < entry.validUntil) continue;
+        recompute(entry, utcMSecs);
+        ++recomputed;
+    }
+    return recomputed;
+}
+
+/**
+ * @brief Applies the cached offset and splits the result into date and time.
+ */
+ZoneOffsetTable::LocalTime ZoneOffsetTable::localTime(int index, qint64 utcMSecs) const {
+    const qint64 localSecs = floorDiv(utcMSecs, 1000) + entries[index].offset;
+    const qint64 day = floorDiv(localSecs, 86400);
+    const int secondOfDay = int(localSecs - day * 86400);
+    return {epochJulianDay + day, secondOfDay / 3600, (secondOfDay / 60) % 60, secondOfDay % 60};
+}
+
+/**
+ * @brief Asks the zone database for the offset and the surrounding transitions.
+ */
+void ZoneOffsetTable::recompute(Entry &entry, qint64 utcMSecs) {
+    const QDateTime instant = QDateTime::fromMSecsSinceEpoch(utcMSecs, Qt::UTC);
+    entry.offset = entry.zone.offsetFromUtc(instant);
+
+    if (entry.zone.hasTransitions()) {
+        const QTimeZone::OffsetData next = entry.zone.nextTransition(instant);
+        // previousTransition() is strictly before its argument; include a transition at this very instant
+        const QTimeZone::OffsetData previous = entry.zone.previousTransition(instant.addMSecs(1));
+        entry.validUntil = next.atUtc.isValid() ? next.atUtc.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+        entry.validFrom = previous.atUtc.isValid() ? previous.atUtc.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    } else if (entry.zone.hasDaylightTime()) {
+        entry.validFrom = utcMSecs;
+        entry.validUntil = utcMSecs + fallbackValidityMSecs;
+    } else {
+        entry.validFrom = std::numeric_limits<qint64>::min();
+        entry.validUntil = std::numeric_limits<qint64>::max();
+    }
+}
@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds the kiosk configuration and checks its steady-state memory footprint
+# on the offscreen platform. Intended for CI.
+#
+# Usage: tools/kiosk-footprint.sh [budget-KB] [seconds]
+set -e
+
+BUDGET_KB=${1:-40960}
+SECONDS_TO_RUN=${2:-30}
+BUILD_DIR=${BUILD_DIR:-build-kiosk}
+
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+mkdir -p "$BUILD_DIR"
+cd "$BUILD_DIR"
+qmake CONFIG+=kiosk "$SOURCE_DIR/Alarm.pro"
+make -j"$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 2)"
+
+ls -l Alarm-kiosk
+QT_QPA_PLATFORM=offscreen ./Alarm-kiosk --standalone --report-rss 5 --run-for "$SECONDS_TO_RUN" --rss-budget "$BUDGET_KB"
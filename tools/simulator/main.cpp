@@ -0,0 +1,220 @@
+/**
+ * @file main.cpp
+ * @brief Entry point for the alarm simulator (alarm-sim).
+ *
+ * The simulator loads an alarm set, drives an AlarmScheduler with a
+ * VirtualClock through an arbitrary span of time (a full year, DST
+ * transitions, clock jumps) as fast as the CPU allows, and records every
+ * alarm that fires. The fire log can be compared between releases.
+ *
+ * Usage:
+ *     alarm-sim --alarms alarms.txt --days 365 --tz Europe/Berlin --log fires.log
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include "alarmscheduler.h"
+#include "clocksource.h"
+
+namespace {
+
+/**
+ * @brief A scheduled jump of the virtual clock.
+ */
+struct ClockJump {
+    QDateTime at; ///< Virtual instant at which the jump happens.
+    QDateTime to; ///< Instant the clock jumps to.
+};
+
+/**
+ * @brief Drops qDebug() output so logging does not dominate the run time.
+ */
+void quietMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message) {
+    if (type == QtDebugMsg || type == QtInfoMsg) return;
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+/**
+ * @brief Loads alarms from a file with one "HH:mm[:ss]|Repeat|Label|Sound[|Calendar[|Group]]" entry per line.
+ * @return True if the file could be read.
+ */
+bool loadAlarms(const QString &path, AlarmScheduler &scheduler) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QStringList fields = line.split('|');
+        const QString timeText = fields.value(0).trimmed();
+        const QTime time = QTime::fromString(timeText, timeText.count(':') == 2 ? "HH:mm:ss" : "HH:mm");
+        if (fields.size() < 3 || !time.isValid()) {
+            qWarning("%s:%d: expected HH:mm[:ss]|Repeat|Label|Sound[|Calendar[|Group]]", qPrintable(path), lineNumber);
+            continue;
+        }
+        scheduler.addAlarm(time, fields[1].trimmed(), fields[2].trimmed(), fields.value(3, "Classic").trimmed(),
+                           fields.value(4).trimmed(), fields.value(5).trimmed());
+    }
+    return true;
+}
+
+/**
+ * @brief Formats a local instant with its UTC offset so DST folds stay unambiguous.
+ */
+QString formatInstant(const QDateTime &local) {
+    return local.toOffsetFromUtc(local.offsetFromUtc()).toString(Qt::ISODate);
+}
+
+} // namespace
+
+/**
+ * @brief Runs the simulation described by the command line.
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments.
+ * @return 0 on success, 1 on invalid arguments.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("alarm-sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays an alarm set against a virtual clock and logs every fire.");
+    parser.addHelpOption();
+    parser.addOption({"alarms", "Alarm set to load (HH:mm[:ss]|Repeat|Label|Sound[|Calendar[|Group]] per line).", "file"});
+    parser.addOption({"holidays", "Holiday calendar file the alarms can refer to. Repeatable.", "file"});
+    parser.addOption({"start", "Local start instant, ISO 8601 (default: today 00:00).", "datetime"});
+    parser.addOption({"days", "Number of days to simulate (default: 365).", "days", "365"});
+    parser.addOption({"step", "Virtual seconds between scheduler checks (default: 60; use 1 for alarms set to the second).", "seconds", "60"});
+    parser.addOption({"action", "How fired alarms are answered: dismiss, or snooze once then dismiss (default: dismiss).", "action", "dismiss"});
+    parser.addOption({"jump", "Jump the clock at one local instant to another, e.g. 2025-03-10T07:00=2025-03-10T09:00. Repeatable.", "from=to"});
+    parser.addOption({"tz", "Time zone to simulate in, e.g. Europe/Berlin (default: system zone).", "zone"});
+    parser.addOption({"log", "Write the fire log to this file instead of stdout.", "file"});
+    parser.addOption({"verbose", "Keep the scheduler's debug output."});
+    parser.process(app);
+
+    // The scheduler works in local time, so switch the process zone before any conversion
+    if (parser.isSet("tz")) {
+        qputenv("TZ", parser.value("tz").toUtf8());
+        tzset();
+    }
+    if (!parser.isSet("verbose")) {
+        qInstallMessageHandler(quietMessageHandler);
+    }
+
+    QDateTime start = QDateTime(QDate::currentDate(), QTime(0, 0));
+    if (parser.isSet("start")) {
+        start = QDateTime::fromString(parser.value("start"), Qt::ISODate);
+    }
+    const int days = parser.value("days").toInt();
+    const qint64 stepMs = parser.value("step").toLongLong() * 1000;
+    const bool snoozeFirst = parser.value("action") == "snooze";
+
+    if (!start.isValid() || days <= 0 || stepMs <= 0 || !parser.isSet("alarms")) {
+        parser.showHelp(1);
+    }
+
+    QList<ClockJump> jumps;
+    for (const QString &jump : parser.values("jump")) {
+        const QStringList ends = jump.split('=');
+        ClockJump clockJump{QDateTime::fromString(ends.value(0), Qt::ISODate),
+                            QDateTime::fromString(ends.value(1), Qt::ISODate)};
+        if (!clockJump.at.isValid() || !clockJump.to.isValid()) {
+            fprintf(stderr, "Invalid --jump %s\n", qPrintable(jump));
+            return 1;
+        }
+        jumps.append(clockJump);
+    }
+    std::sort(jumps.begin(), jumps.end(), [](const ClockJump &a, const ClockJump &b) { return a.at < b.at; });
+
+    VirtualClock clock(start);
+    AlarmScheduler scheduler(&clock);
+    for (const QString &path : parser.values("holidays")) {
+        QString error;
+        if (scheduler.calendars()->importFile(path, &error).isEmpty()) {
+            fprintf(stderr, "%s\n", qPrintable(error.isEmpty() ? path + ": no dates found" : error));
+            return 1;
+        }
+    }
+    if (!loadAlarms(parser.value("alarms"), scheduler)) {
+        fprintf(stderr, "Cannot read %s\n", qPrintable(parser.value("alarms")));
+        return 1;
+    }
+
+    QFile logFile;
+    if (parser.isSet("log")) {
+        logFile.setFileName(parser.value("log"));
+        if (!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            fprintf(stderr, "Cannot write %s\n", qPrintable(parser.value("log")));
+            return 1;
+        }
+    } else {
+        logFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    QTextStream log(&logFile);
+
+    const qint64 endMs = start.addDays(days).toMSecsSinceEpoch();
+    qint64 ticks = 0;
+    qint64 fires = 0;
+    int nextJump = 0;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    while (clock.currentMSecsSinceEpoch() < endMs) {
+        if (nextJump < jumps.size() && clock.currentMSecsSinceEpoch() >= jumps[nextJump].at.toMSecsSinceEpoch()) {
+            log << formatInstant(clock.currentDateTime()) << "\tJUMP\t" << formatInstant(jumps[nextJump].to.toLocalTime()) << '\n';
+            clock.setCurrentDateTime(jumps[nextJump].to);
+            ++nextJump;
+        }
+
+        const QDateTime now = clock.currentDateTime();
+        const QVector<quint64> due = scheduler.dueAlarms(now);
+        if (!due.isEmpty()) {
+            // Like the app, all alarms due at once are answered as one batch. With
+            // --action snooze a batch is snoozed once and dismissed when it comes back.
+            bool snooze = snoozeFirst;
+            QList<const Alarm *> fired;
+            for (quint64 id : due) {
+                fired.append(scheduler.store()->find(id));
+                snooze = snooze && !fired.last()->snoozed;
+            }
+
+            for (const Alarm *alarm : fired) {
+                log << formatInstant(now) << '\t' << alarm->displayLabel() << '\t' << alarm->repeat << '\t'
+                    << (snooze ? "snooze" : "dismiss") << '\n';
+            }
+            fires += due.size();
+
+            if (snooze) {
+                scheduler.snoozeAll(due, 5);
+            } else {
+                scheduler.dismissAll(due);
+            }
+        }
+
+        clock.advance(stepMs);
+        ++ticks;
+    }
+
+    log.flush();
+    const qint64 elapsedMs = wallClock.elapsed();
+    fprintf(stderr, "Simulated %d days (%lld ticks) in %lld ms: %lld fires, %.0f ticks/s\n",
+            days, ticks, elapsedMs, fires, elapsedMs > 0 ? ticks * 1000.0 / elapsedMs : double(ticks));
+    return 0;
+}
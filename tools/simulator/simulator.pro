@@ -0,0 +1,10 @@
+QT = core
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = alarm-sim
+
+include(../../alarmcore/alarmcore.pri)
+
+SOURCES += main.cpp
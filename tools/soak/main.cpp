@@ -0,0 +1,278 @@
+/**
+ * @file main.cpp
+ * @brief Entry point for the soak test (alarm-soak).
+ *
+ * The soak test runs the real MainWindow on the offscreen platform against a
+ * VirtualClock and replays weeks of use in minutes: alarms are added, edited
+ * and removed, the Set Alarm, View Alarms, Alarm Details and Agenda windows
+ * are opened and closed, and every alarm that rings is snoozed or dismissed
+ * through its message box. Once per simulated day it samples the RSS, the
+ * number of live QObjects and widgets, and the open file descriptors. The
+ * growth between the end of the warm-up and the end of the run is compared
+ * against a budget, so a slow leak fails the run instead of a device in the
+ * field.
+ *
+ * Usage:
+ *     alarm-soak --days 28 --alarms 200 --rss-growth 4096 --object-growth 100
+ *
+ * Exit status: 0 within budget, 2 over budget, 1 on invalid arguments.
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include <QAbstractButton>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QListView>
+#include <QMessageBox>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <cstdio>
+#include <random>
+#include "agendaview.h"
+#include "alarmhistory.h"
+#include "clocksource.h"
+#include "mainwindow.h"
+#include "memoryusage.h"
+#include "viewAlarm.h"
+
+namespace {
+
+/**
+ * @brief Resource usage at one point of the run.
+ */
+struct Sample {
+    int day = 0;        ///< Simulated days since the start.
+    qint64 rssKb = -1;  ///< Resident set size.
+    int objects = 0;    ///< Live QObjects reachable from the application and its windows.
+    int widgets = 0;    ///< Live widgets.
+    int fds = -1;       ///< Open file descriptors.
+};
+
+/**
+ * @brief Drops qDebug() output so logging does not dominate the run time.
+ */
+void quietMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message) {
+    if (type == QtDebugMsg || type == QtInfoMsg) return;
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+/**
+ * @brief Counts the application object, its children and every parentless window with its children.
+ *
+ * Dialogs parented to the main window are found as its children, so one that
+ * is closed but never deleted shows up here.
+ */
+int countObjects() {
+    int objects = 1 + qApp->findChildren<QObject *>().size();
+    for (QWidget *window : QApplication::topLevelWidgets()) {
+        if (!window->parent()) objects += 1 + window->findChildren<QObject *>().size();
+    }
+    return objects;
+}
+
+/**
+ * @brief Samples every tracked resource.
+ */
+Sample takeSample(int day) {
+    Sample sample;
+    sample.day = day;
+    sample.rssKb = MemoryUsage::residentKb();
+    sample.objects = countObjects();
+    sample.widgets = QApplication::allWidgets().size();
+    sample.fds = MemoryUsage::openFileDescriptors();
+    return sample;
+}
+
+/**
+ * @brief Prints one row of the sample table.
+ */
+void printSample(const Sample &sample) {
+    printf("%5d %10lld %8d %8d %5d\n", sample.day, sample.rssKb, sample.objects, sample.widgets, sample.fds);
+    fflush(stdout);
+}
+
+/**
+ * @brief Prints the growth of one resource and returns true if it exceeds the budget.
+ */
+bool overBudget(const char *name, qint64 growth, qint64 budget) {
+    const bool over = growth > budget;
+    fprintf(stderr, "%-8s grew by %lld (budget %lld): %s\n", name, growth, budget, over ? "OVER BUDGET" : "ok");
+    return over;
+}
+
+} // namespace
+
+/**
+ * @brief Runs the soak test described by the command line.
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments.
+ * @return 0 within budget, 2 over budget, 1 on invalid arguments.
+ */
+int main(int argc, char *argv[]) {
+    // Nothing is meant to appear on screen
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("alarm-soak");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Drives the alarm clock through weeks of virtual time and checks for leaks.");
+    parser.addHelpOption();
+    parser.addOption({"days", "Number of days to simulate (default: 28).", "days", "28"});
+    parser.addOption({"warmup", "Days before the baseline sample is taken (default: 2).", "days", "2"});
+    parser.addOption({"alarms", "Number of alarms kept in the store (default: 200).", "count", "200"});
+    parser.addOption({"seed", "Seed of the random workload (default: 1).", "seed", "1"});
+    parser.addOption({"start", "Local start instant, ISO 8601 (default: today 00:00).", "datetime"});
+    parser.addOption({"rss-growth", "Allowed RSS growth after the warm-up in KB (default: 4096).", "KB", "4096"});
+    parser.addOption({"object-growth", "Allowed growth of live QObjects (default: 100).", "count", "100"});
+    parser.addOption({"fd-growth", "Allowed growth of open file descriptors (default: 4).", "count", "4"});
+    parser.addOption({"verbose", "Keep the application's debug output."});
+    parser.process(app);
+
+    if (!parser.isSet("verbose")) {
+        qInstallMessageHandler(quietMessageHandler);
+    }
+
+    QDateTime start = QDateTime(QDate::currentDate(), QTime(0, 0));
+    if (parser.isSet("start")) {
+        start = QDateTime::fromString(parser.value("start"), Qt::ISODate);
+    }
+    const int days = parser.value("days").toInt();
+    const int warmupDays = parser.value("warmup").toInt();
+    const int population = parser.value("alarms").toInt();
+    if (!start.isValid() || days <= warmupDays || warmupDays < 0 || population <= 0) {
+        parser.showHelp(1);
+    }
+
+    // Records go to a throwaway ring file, so the writer thread and the mapping are part of the run
+    QTemporaryDir scratch;
+    AlarmHistory history(scratch.filePath("history.ring"), 4096);
+
+    VirtualClock clock(start);
+    MainWindow mainWindow(&clock);
+    mainWindow.profiles()->setHistory(history.isOpen() ? &history : nullptr);
+    mainWindow.show();
+
+    AlarmScheduler *scheduler = mainWindow.scheduler();
+    AlarmStore *store = scheduler->store();
+    std::mt19937 random(parser.value("seed").toUInt());
+    const QStringList repeats = {"Never", "Every Sunday", "Every Monday", "Every Tuesday", "Every Wednesday",
+                                 "Every Thursday", "Every Friday", "Every Saturday"};
+    const QStringList sounds = {"Classic", "Beep", "Rooster"};
+    qint64 labelCounter = 0;
+
+    auto randomTime = [&]() { return QTime(int(random() % 24), int(random() % 60)); };
+    auto randomAlarm = [&]() -> const Alarm * {
+        const QVector<Alarm> &alarms = store->alarms();
+        return alarms.isEmpty() ? nullptr : &alarms[int(random() % quint32(alarms.size()))];
+    };
+
+    // Answer every modal dialog the app opens, the way a user would
+    qint64 answered = 0;
+    QTimer responder;
+    responder.setInterval(0);
+    QObject::connect(&responder, &QTimer::timeout, [&]() {
+        QWidget *modal = QApplication::activeModalWidget();
+        if (QMessageBox *box = qobject_cast<QMessageBox *>(modal)) {
+            // "Snooze" or "Dismiss"
+            const QList<QAbstractButton *> buttons = box->buttons();
+            if (!buttons.isEmpty()) buttons[int(random() % quint32(buttons.size()))]->click();
+            ++answered;
+        } else if (QDialog *dialog = qobject_cast<QDialog *>(modal)) {
+            dialog->reject();
+            ++answered;
+        }
+    });
+    responder.start();
+
+    // One simulated hour per pass of the event loop, so deferred deletions run as in the app
+    const qint64 endMs = start.addDays(days).toMSecsSinceEpoch();
+    QVector<Sample> samples;
+    bool stepping = false;
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    printf("  day     rss_kb  objects  widgets   fds\n");
+    samples.append(takeSample(0));
+    printSample(samples.last());
+
+    QTimer stepTimer;
+    stepTimer.setInterval(0);
+    QObject::connect(&stepTimer, &QTimer::timeout, [&]() {
+        // The message boxes run nested event loops, in which this timer fires too
+        if (stepping) return;
+        stepping = true;
+
+        for (int minute = 0; minute < 60; ++minute) {
+            clock.advance(60 * 1000);
+            QMetaObject::invokeMethod(&mainWindow, "checkAlarms");
+        }
+
+        while (store->alarms().size() < population) {
+            scheduler->addAlarm(randomTime(), repeats[int(random() % quint32(repeats.size()))],
+                                QString("Soak %1").arg(++labelCounter), sounds[int(random() % quint32(sounds.size()))]);
+        }
+
+        switch (random() % 6) {
+        case 0:
+            if (const Alarm *alarm = randomAlarm()) {
+                Alarm edited = *alarm;
+                edited.time = edited.originalTime = randomTime();
+                edited.label = QString("Soak %1").arg(++labelCounter);
+                store->update(edited);
+            }
+            break;
+        case 1:
+            if (const Alarm *alarm = randomAlarm()) store->remove(alarm->id);
+            break;
+        case 2:
+            QMetaObject::invokeMethod(&mainWindow, "openSetAlarm");
+            break;
+        case 3:
+            QMetaObject::invokeMethod(&mainWindow, "openViewAlarms");
+            if (ViewAlarm *view = mainWindow.findChild<ViewAlarm *>()) {
+                // Opens the Alarm Details dialog of one alarm
+                QListView *list = view->findChild<QListView *>();
+                const int rows = list ? list->model()->rowCount() : 0;
+                if (rows > 0) emit list->clicked(list->model()->index(int(random() % quint32(rows)), 0));
+                view->close();
+            }
+            break;
+        case 4:
+            QMetaObject::invokeMethod(&mainWindow, "openAgenda");
+            if (AgendaView *agenda = mainWindow.findChild<AgendaView *>()) agenda->close();
+            break;
+        default:
+            break;
+        }
+
+        const int day = int((clock.currentMSecsSinceEpoch() - start.toMSecsSinceEpoch()) / (24 * 3600 * 1000));
+        if (day > samples.last().day) {
+            samples.append(takeSample(day));
+            printSample(samples.last());
+        }
+
+        stepping = false;
+        if (clock.currentMSecsSinceEpoch() >= endMs) app.quit();
+    });
+    stepTimer.start();
+
+    app.exec();
+
+    const Sample &baseline = samples[qMin(warmupDays, samples.size() - 1)];
+    const Sample &last = samples.last();
+    fprintf(stderr, "Simulated %d days in %lld ms, %lld dialogs answered, %d alarms stored\n",
+            days, wallClock.elapsed(), answered, store->alarms().size());
+
+    bool over = false;
+    over |= baseline.rssKb >= 0 && overBudget("RSS KB", last.rssKb - baseline.rssKb, parser.value("rss-growth").toLongLong());
+    over |= overBudget("QObjects", last.objects - baseline.objects, parser.value("object-growth").toLongLong());
+    over |= baseline.fds >= 0 && overBudget("FDs", last.fds - baseline.fds, parser.value("fd-growth").toLongLong());
+    return over ? 2 : 0;
+}
@@ -0,0 +1,11 @@
+QT += core gui widgets multimedia
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = alarm-soak
+
+include(../../alarmcore/alarmcore.pri)
+include(../../app/app.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,743 @@
+/**
+ * @file main.cpp
+ * @brief Entry point for the timing wheel benchmark (wheelbench).
+ *
+ * The benchmark fills a TimingWheel with a mix of weekly and one-shot
+ * entries, then measures the cost of inserting, advancing the wheel through
+ * a full week minute by minute, and cancelling every entry. It is used to
+ * check that the per-tick cost stays flat as the number of alarms grows.
+ * It also times agenda queries on the OccurrenceCache and bulk recomputes
+ * of the NextFireIndex, and the memory taken by alarms whose labels repeat.
+ * With --fire-allocs it checks that firing alarms (collecting them across
+ * profiles and building their announcement, as the main window does) makes
+ * no heap allocation once warmed up, and fails if it does. With --check-wheel
+ * it runs random steps on a wheel and fails if what it fires ever differs
+ * from a brute-force scan of the same entries. With --store-check it counts
+ * the full copies of the alarm list that store changes cause, and fails if
+ * a change copies it without a reason; it also times a group toggle at two
+ * store sizes.
+ *
+ * Usage:
+ *     wheelbench --entries 1000000,10000000 --weekly 0.8 --agenda 100000 --recompute 1000000 --labels 1000000
+ *     wheelbench --entries 1000 --agenda 0 --recompute 0 --labels 0 --fire-allocs 3000
+ *     wheelbench --entries 1000 --agenda 0 --recompute 0 --labels 0 --check-wheel 20000
+ *     wheelbench --entries 1000 --agenda 0 --recompute 0 --labels 0 --store-check 100000
+ *
+ * @author Group 27
+ * @date Sunday, October 19
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "alarmhistory.h"
+#include "alarmscheduler.h"
+#include "alarmservice.h"
+#include "alarmstore.h"
+#include "allocationcounter.h"
+#include "clocksource.h"
+#include "firebatch.h"
+#include "labelpool.h"
+#include "memoryusage.h"
+#include "nextfireindex.h"
+#include "occurrencecache.h"
+#include "timingwheel.h"
+
+namespace {
+
+/**
+ * @brief Results of one benchmark run.
+ */
+struct BenchResult {
+    qint64 entries = 0;       ///< Number of entries scheduled.
+    double insertNs = 0;      ///< Mean cost of one schedule call.
+    double cancelNs = 0;      ///< Mean cost of one cancel call.
+    double tickMeanUs = 0;    ///< Mean cost of advancing one minute.
+    double tickMaxUs = 0;     ///< Worst cost of advancing one minute.
+    qint64 fired = 0;         ///< Entries fired during the simulated week.
+    qint64 rssKb = 0;         ///< RSS growth while the wheel was full.
+};
+
+/**
+ * @brief Runs the benchmark for one wheel size.
+ * @param entries Number of entries to schedule.
+ * @param weeklyShare Fraction of entries that repeat weekly.
+ * @param seed Seed for the random alarm times.
+ */
+BenchResult run(qint64 entries, double weeklyShare, quint64 seed) {
+    BenchResult result;
+    result.entries = entries;
+
+    const std::int64_t start = 2900000; // Any minute will do; this one is in 1975
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> minuteOfWeek(0, int(TimingWheel::MinutesPerWeek) - 1);
+    std::uniform_int_distribution<int> oneShotDelay(1, 30 * 24 * 60);
+    std::bernoulli_distribution isWeekly(weeklyShare);
+
+    // Draw the times up front so that only the wheel is timed
+    std::vector<int> times(size_t(entries));
+    std::vector<bool> weekly(size_t(entries));
+    for (qint64 i = 0; i < entries; ++i) {
+        weekly[size_t(i)] = isWeekly(random);
+        times[size_t(i)] = weekly[size_t(i)] ? minuteOfWeek(random) : oneShotDelay(random);
+    }
+
+    const qint64 rssBefore = MemoryUsage::residentKb();
+    TimingWheel wheel(start);
+    wheel.reserve(size_t(entries));
+    std::vector<TimingWheel::Handle> handles(size_t(entries));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; i < entries; ++i) {
+        handles[size_t(i)] = weekly[size_t(i)]
+                ? wheel.scheduleWeekly(times[size_t(i)], std::uint64_t(i))
+                : wheel.scheduleAt(start + times[size_t(i)], std::uint64_t(i));
+    }
+    result.insertNs = double(timer.nsecsElapsed()) / double(entries);
+    result.rssKb = MemoryUsage::residentKb() - rssBefore;
+
+    // One-shots that fire are re-armed four weeks later, like a real alarm population
+    qint64 totalNs = 0;
+    qint64 worstNs = 0;
+    for (std::int64_t minute = start + 1; minute <= start + TimingWheel::MinutesPerWeek; ++minute) {
+        timer.restart();
+        result.fired += qint64(wheel.advanceTo(minute, [&](std::uint64_t payload, TimingWheel::Handle) {
+            if (!weekly[size_t(payload)]) {
+                handles[size_t(payload)] = wheel.scheduleAt(minute + 4 * TimingWheel::MinutesPerWeek, payload);
+            }
+        }));
+        const qint64 elapsed = timer.nsecsElapsed();
+        totalNs += elapsed;
+        worstNs = std::max(worstNs, elapsed);
+    }
+    result.tickMeanUs = double(totalNs) / double(TimingWheel::MinutesPerWeek) / 1000.0;
+    result.tickMaxUs = double(worstNs) / 1000.0;
+
+    // Cancel in random order so that the lists are not walked sequentially
+    std::shuffle(handles.begin(), handles.end(), random);
+    timer.restart();
+    for (TimingWheel::Handle handle : handles) {
+        wheel.cancel(handle);
+    }
+    result.cancelNs = double(timer.nsecsElapsed()) / double(entries);
+
+    return result;
+}
+
+/**
+ * @brief Entry of the reference model the wheel check compares against.
+ */
+struct CheckEntry {
+    TimingWheel::Handle handle; ///< Handle the wheel returned.
+    std::int64_t minute;        ///< One-shot: minute it fires at. Weekly: unused.
+    int minuteOfWeek;           ///< Weekly: minute of the week it fires at. One-shot: -1.
+};
+
+/**
+ * @brief A fire, as seen by the wheel or expected by the reference.
+ */
+using CheckFire = std::pair<std::int64_t, TimingWheel::Handle>;
+
+/**
+ * @brief Returns the minute of the week of a wheel minute.
+ */
+int checkMinuteOfWeek(std::int64_t minute) {
+    return int(((minute % TimingWheel::MinutesPerWeek) + TimingWheel::MinutesPerWeek) % TimingWheel::MinutesPerWeek);
+}
+
+/**
+ * @brief Checks the timing wheel against a brute-force scan of a plain list of entries.
+ *
+ * Each step adds a one-shot entry (in the past, or in range of any of the
+ * four levels, or beyond the top one), adds a weekly entry, cancels a live
+ * or a dead handle, or advances the wheel: one minute, up to 90 minutes, or
+ * a catch-up jump of up to ~200 days or, rarely, ~30 years, which crosses
+ * cascades of every level. On every advance the reference scans all of its
+ * entries for the ones due in each minute passed, and the sorted
+ * (minute, handle) lists must match what the wheel fired, minute for
+ * minute. The entry count and cancel() results are checked too.
+ *
+ * @param steps Number of random steps.
+ * @param seed Seed for the steps.
+ * @param out Stream the result is written to.
+ * @return False at the first mismatch.
+ */
+bool runWheelCheck(qint64 steps, quint64 seed, QTextStream &out) {
+    const std::int64_t start = 2900000 + 12345; // Not on a level boundary
+    std::mt19937_64 random(seed);
+    TimingWheel wheel(start);
+    std::vector<CheckEntry> live;
+    std::vector<TimingWheel::Handle> dead;
+    std::vector<CheckFire> expected;
+    std::vector<CheckFire> fired;
+    qint64 ticks = 0;
+    qint64 fires = 0;
+
+    const auto below = [&](std::int64_t bound) { return std::int64_t(random() % std::uint64_t(bound)); };
+    const auto between = [&](std::int64_t low, std::int64_t high) { return low + below(high - low + 1); };
+    const auto fail = [&](qint64 step, const QString &what) {
+        out << "wheel check: step " << step << " at minute " << wheel.currentMinute() << ": " << what << "\n";
+        return false;
+    };
+
+    for (qint64 step = 0; step < steps; ++step) {
+        const int kind = int(below(100));
+        if (kind < 35) {
+            // Past (fires on the next minute), level 0 to 3, or beyond the top level
+            static const std::int64_t ranges[][2] = {{-500, 0}, {1, 63}, {64, 4095}, {4096, 262143},
+                                                     {262144, (1 << 24) - 1}, {1 << 24, 1 << 25}};
+            const auto &range = ranges[below(6)];
+            const std::int64_t minute = wheel.currentMinute() + between(range[0], range[1]);
+            const TimingWheel::Handle handle = wheel.scheduleAt(minute, std::uint64_t(step));
+            live.push_back({handle, std::max(minute, wheel.currentMinute() + 1), -1});
+        } else if (kind < 40) {
+            if (live.size() < 2000 && std::count_if(live.begin(), live.end(), [](const CheckEntry &entry) {
+                    return entry.minuteOfWeek >= 0;
+                }) < 48) {
+                const int minuteOfWeek = int(below(TimingWheel::MinutesPerWeek));
+                live.push_back({wheel.scheduleWeekly(minuteOfWeek, std::uint64_t(step)), 0, minuteOfWeek});
+            }
+        } else if (kind < 60) {
+            if (!dead.empty() && below(4) == 0) {
+                if (wheel.cancel(dead[size_t(below(qint64(dead.size())))])) {
+                    return fail(step, "cancelled a fired or cancelled handle");
+                }
+            } else if (!live.empty()) {
+                const size_t index = size_t(below(qint64(live.size())));
+                if (!wheel.cancel(live[index].handle)) return fail(step, "could not cancel a live handle");
+                if (dead.size() < 1024) dead.push_back(live[index].handle);
+                live[index] = live.back();
+                live.pop_back();
+            }
+        } else {
+            const int jump = int(below(1000));
+            std::int64_t minutes;
+            if (jump < 500) minutes = 1;
+            else if (jump < 750) minutes = between(2, 90);
+            else if (jump < 999 || wheel.currentMinute() - start > (1 << 30)) minutes = between(91, 300000);
+            else minutes = between(1 << 24, (1 << 24) + (1 << 23));
+            const std::int64_t from = wheel.currentMinute();
+            const std::int64_t to = from + minutes;
+
+            expected.clear();
+            for (const CheckEntry &entry : live) {
+                if (entry.minuteOfWeek < 0) {
+                    if (entry.minute <= to) expected.push_back({entry.minute, entry.handle});
+                    continue;
+                }
+                const std::int64_t first = from + 1
+                        + (entry.minuteOfWeek - checkMinuteOfWeek(from + 1) + TimingWheel::MinutesPerWeek)
+                          % TimingWheel::MinutesPerWeek;
+                for (std::int64_t minute = first; minute <= to; minute += TimingWheel::MinutesPerWeek) {
+                    expected.push_back({minute, entry.handle});
+                }
+            }
+
+            fired.clear();
+            const std::size_t count = wheel.advanceTo(to, [&](std::uint64_t, TimingWheel::Handle handle) {
+                fired.push_back({wheel.currentMinute(), handle});
+            });
+            ticks += minutes;
+            fires += qint64(count);
+
+            std::sort(expected.begin(), expected.end());
+            std::sort(fired.begin(), fired.end());
+            if (count != fired.size() || fired != expected) {
+                const auto mismatch = std::mismatch(expected.begin(), expected.end(), fired.begin(), fired.end());
+                const std::int64_t minute = std::min(mismatch.first != expected.end() ? mismatch.first->first : to,
+                                                     mismatch.second != fired.end() ? mismatch.second->first : to);
+                const auto inMinute = [minute](const std::vector<CheckFire> &fires) {
+                    return std::count_if(fires.begin(), fires.end(), [minute](const CheckFire &fire) {
+                        return fire.first == minute;
+                    });
+                };
+                return fail(step, QString("advancing %1 minutes from %2, minute %3 fired %4 entries instead of %5")
+                                  .arg(minutes).arg(from).arg(minute).arg(inMinute(fired)).arg(inMinute(expected)));
+            }
+
+            for (size_t index = 0; index < live.size();) {
+                if (live[index].minuteOfWeek < 0 && live[index].minute <= to) {
+                    if (dead.size() < 1024) dead.push_back(live[index].handle);
+                    live[index] = live.back();
+                    live.pop_back();
+                } else {
+                    ++index;
+                }
+            }
+        }
+
+        if (wheel.size() != live.size()) {
+            return fail(step, QString("holds %1 entries instead of %2").arg(wheel.size()).arg(live.size()));
+        }
+    }
+
+    out << "wheel check: " << steps << " steps, " << ticks << " minutes advanced, " << fires
+        << " fires, " << qint64(live.size()) << " entries left, no mismatch\n";
+    return true;
+}
+
+/**
+ * @brief Times "what rings between 06:00 and 09:00 next week" on the occurrence cache.
+ * @param alarms Number of weekly alarms to register.
+ * @param seed Seed for the random alarm times.
+ * @param out Stream the timings are written to.
+ */
+void runAgenda(qint64 alarms, quint64 seed, QTextStream &out) {
+    static const char *const days[] = {"Every Monday", "Every Tuesday", "Every Wednesday", "Every Thursday",
+                                       "Every Friday", "Every Saturday", "Every Sunday"};
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> day(0, 6);
+    std::uniform_int_distribution<int> minute(0, 24 * 60 - 1);
+
+    QVector<Alarm> added;
+    added.reserve(int(alarms));
+    for (qint64 i = 0; i < alarms; ++i) {
+        Alarm alarm;
+        alarm.time = QTime(0, 0).addSecs(minute(random) * 60);
+        alarm.originalTime = alarm.time;
+        alarm.repeat = days[day(random)];
+        alarm.label = QString("Alarm %1").arg(i);
+        added.append(alarm);
+    }
+
+    AlarmStore store;
+    const QVector<quint64> ids = store.apply(added, {}, {});
+    VirtualClock clock(QDateTime(QDate(2025, 3, 14), QTime(12, 0)));
+    OccurrenceCache cache(&store, &clock);
+
+    const QDate today = clock.currentDateTime().date();
+    const QDateTime from(today.addDays(8 - today.dayOfWeek()), QTime(0, 0)); // Next Monday
+    const QDateTime to = from.addDays(7);
+    const auto timeQuery = [&]() {
+        QElapsedTimer timer;
+        timer.start();
+        const int found = cache.occurrences(from, to, QTime(6, 0), QTime(9, 0)).size();
+        return qMakePair(found, timer.nsecsElapsed() / 1e6);
+    };
+
+    const auto cold = timeQuery();
+    const auto warm = timeQuery();
+    Alarm edited = *store.find(ids[ids.size() / 2]);
+    edited.time = edited.time.addSecs(60);
+    store.update(edited);
+    const auto edit = timeQuery();
+
+    out << "agenda: " << alarms << " weekly alarms, 06:00-09:00 next week: " << cold.first << " occurrences\n"
+        << "  first query " << QString::number(cold.second, 'f', 2) << " ms, cached "
+        << QString::number(warm.second, 'f', 2) << " ms, after editing one alarm "
+        << QString::number(edit.second, 'f', 2) << " ms\n";
+}
+
+/**
+ * @brief Times a full recompute of the next fire instants, and patching in one edit.
+ * @param alarms Number of alarms (weekly and daily, a tenth of them skipping a holiday calendar).
+ * @param weeklyShare Fraction of alarms that repeat weekly.
+ * @param seed Seed for the random alarm times.
+ * @param out Stream the timings are written to.
+ */
+void runRecompute(qint64 alarms, double weeklyShare, quint64 seed, QTextStream &out) {
+    static const char *const days[] = {"Every Monday", "Every Tuesday", "Every Wednesday", "Every Thursday",
+                                       "Every Friday", "Every Saturday", "Every Sunday"};
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> day(0, 6);
+    std::uniform_int_distribution<int> minute(0, 24 * 60 - 1);
+    std::bernoulli_distribution isWeekly(weeklyShare);
+    std::bernoulli_distribution usesCalendar(0.1);
+
+    HolidayCalendars calendars;
+    HolidayCalendar holidays;
+    holidays.addRange(QDate(2025, 12, 22), QDate(2026, 1, 2));
+    holidays.addDate(QDate(2025, 3, 17));
+    calendars.setCalendar("bench", holidays);
+
+    QVector<Alarm> added;
+    added.reserve(int(alarms));
+    for (qint64 i = 0; i < alarms; ++i) {
+        Alarm alarm;
+        alarm.time = QTime(0, 0).addSecs(minute(random) * 60);
+        alarm.originalTime = alarm.time;
+        alarm.repeat = isWeekly(random) ? days[day(random)] : "Never";
+        alarm.label = QString("Alarm %1").arg(i);
+        if (usesCalendar(random)) alarm.calendar = "bench";
+        added.append(alarm);
+    }
+
+    AlarmStore store;
+    const QVector<quint64> ids = store.apply(added, {}, {});
+    VirtualClock clock(QDateTime(QDate(2025, 3, 14), QTime(12, 0)));
+    NextFireIndex index(&store, &calendars, &clock);
+
+    QElapsedTimer timer;
+    timer.start();
+    index.recomputeNow();
+    const double bulkMs = timer.nsecsElapsed() / 1e6;
+
+    Alarm edited = *store.find(ids[ids.size() / 2]);
+    edited.time = edited.time.addSecs(60);
+    store.update(edited);
+    timer.restart();
+    index.sync();
+    const double editMs = timer.nsecsElapsed() / 1e6;
+
+    out << "next fire: " << alarms << " alarms on " << QThread::idealThreadCount() << " threads, next deadline "
+        << index.nextDeadline().toString("yyyy-MM-dd HH:mm") << "\n"
+        << "  bulk recompute " << QString::number(bulkMs, 'f', 1) << " ms, patching one edit "
+        << QString::number(editMs, 'f', 2) << " ms\n";
+}
+
+/**
+ * @brief Measures the memory of alarms whose labels come from a small vocabulary, as in imported sets.
+ * @param alarms Number of alarms.
+ * @param seed Seed for the label choice.
+ * @param out Stream the results are written to.
+ */
+void runLabels(qint64 alarms, quint64 seed, QTextStream &out) {
+    static const char *const vocabulary[] = {"Standup", "Meds", "Water the plants", "Gym", "School run",
+                                             "Take out the bins", "Call mum", "Lunch"};
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> pick(0, int(std::size(vocabulary)) - 1);
+
+    const qint64 rssBefore = MemoryUsage::residentKb();
+    QVector<Alarm> added;
+    added.reserve(int(alarms));
+    for (qint64 i = 0; i < alarms; ++i) {
+        Alarm alarm;
+        alarm.time = QTime(7, 30);
+        alarm.originalTime = alarm.time;
+        alarm.repeat = "Never";
+        // Built from a fresh string every time, like a parsed import line
+        alarm.label = QString::fromLatin1(vocabulary[pick(random)]);
+        added.append(alarm);
+    }
+    AlarmStore store;
+    store.apply(added, {}, {});
+    added.clear();
+    const qint64 rssKb = MemoryUsage::residentKb() - rssBefore;
+
+    QElapsedTimer timer;
+    timer.start();
+    const Label meds("Meds");
+    qint64 matches = 0;
+    for (const Alarm &alarm : store.alarms()) {
+        if (alarm.label == meds) ++matches;
+    }
+    const double compareNs = double(timer.nsecsElapsed()) / qMax<qint64>(1, alarms);
+
+    out << "labels: " << alarms << " alarms, " << LabelPool::instance().size() << " distinct labels ("
+        << LabelPool::instance().storedChars() << " chars), " << sizeof(Alarm) << " bytes per Alarm, RSS +"
+        << rssKb << " KB\n"
+        << "  label compare " << QString::number(compareNs, 'f', 2) << " ns, " << matches << " \"Meds\"\n";
+}
+
+/**
+ * @brief Fills a store with one-shot and weekly alarms, a tenth of them in each of ten groups.
+ */
+void fillStore(AlarmStore &store, qint64 alarms, quint64 seed) {
+    static const char *const repeats[] = {"Never", "Every Monday", "Every Wednesday", "Every Friday"};
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> second(0, 24 * 3600 - 1);
+
+    QVector<Alarm> added;
+    added.reserve(int(alarms));
+    for (qint64 i = 0; i < alarms; ++i) {
+        Alarm alarm;
+        alarm.time = QTime(0, 0).addSecs(second(random));
+        alarm.originalTime = alarm.time;
+        alarm.repeat = repeats[i % 4];
+        alarm.label = QString("Alarm %1").arg(i);
+        alarm.group = QString("Group %1").arg(i % 10);
+        added.append(alarm);
+    }
+    store.apply(added, {}, {});
+}
+
+/**
+ * @brief Counts the full copies of the alarm list that store changes cause.
+ *
+ * The store belongs to a scheduler with an AlarmService attached, as in
+ * the app. Single edits are made with no snapshot held (but the service's
+ * snapshot read after each, as the windows do, and a bulk recompute of the
+ * next fire instants started before them), which must copy nothing,
+ * and with one snapshot held across all of them, which must copy the list
+ * once (for the first edit) rather than once per edit. It then times
+ * switching a group of 100 alarms on and off in a store of a tenth of the
+ * size and of the full size, which must copy nothing and keep the agenda's
+ * expanded days, and should take about the same time in both.
+ *
+ * @param alarms Number of alarms in the store.
+ * @param seed Seed for the alarm times.
+ * @param out Stream the results are written to.
+ * @return False if a change copied the list when it should not have.
+ */
+bool runStoreCheck(qint64 alarms, quint64 seed, QTextStream &out) {
+    const int edits = 1000;
+    VirtualClock clock(QDateTime(QDate(2025, 3, 14), QTime(12, 0)));
+    AlarmScheduler scheduler(&clock);
+    AlarmStore &store = *scheduler.store();
+    fillStore(store, alarms, seed);
+    AlarmService service(&scheduler);
+    const QVector<Alarm> &list = store.alarms();
+
+    qint64 seen = 0; // Keeps the reads from being optimized away
+    const auto edit = [&](int count) {
+        const quint64 before = store.detachCount();
+        for (int i = 0; i < count; ++i) {
+            Alarm alarm = list[int(qint64(i) * 7919 % list.size())];
+            alarm.time = alarm.time.addSecs(60);
+            store.update(alarm);
+            seen += service.snapshot().alarms().size();
+        }
+        return store.detachCount() - before;
+    };
+
+    // The recompute is only collected by sync(), so it is in progress during every edit
+    scheduler.nextFires()->recompute();
+    const quint64 unshared = edit(edits);
+    scheduler.nextFires()->sync();
+    quint64 held;
+    {
+        const AlarmSnapshot snapshot = store.snapshot();
+        held = edit(edits);
+    }
+
+    out << "store: " << alarms << " alarms with a service attached, " << edits << " edits copy the list " << unshared
+        << " times with no snapshot held, " << held << " times with one held across them ("
+        << seen / edits / 2 << " alarms read per edit)\n";
+
+    // A group toggle must cost the same whatever the number of other alarms
+    const int members = int(qMin<qint64>(100, alarms));
+    const qint64 small = qMax<qint64>(members, alarms / 10);
+    const ToggleResult few = timeGroupToggle(small, members, seed);
+    const ToggleResult many = timeGroupToggle(alarms, members, seed);
+    out << "  toggling a group of " << members << " takes " << QString::number(few.toggleUs, 'f', 1) << " us among "
+        << small << " alarms, " << QString::number(many.toggleUs, 'f', 1) << " us among " << alarms << " ("
+        << few.copies + many.copies << " list copies, agenda days " << (few.cacheKept && many.cacheKept ? "kept" : "dropped")
+        << ")\n";
+    return unshared == 0 && held == 1 && few.copies + many.copies == 0 && few.cacheKept && many.cacheKept;
+}
+
+/**
+ * @brief Cost of switching one small group on and off in a store of a given size.
+ */
+struct ToggleResult {
+    double toggleUs;   ///< Mean time of one setGroupEnabled() call.
+    quint64 copies;    ///< Full copies of the alarm list the toggles caused.
+    bool cacheKept;    ///< True if the occurrence cache kept its expanded days.
+};
+
+/**
+ * @brief Times setGroupEnabled() on a group of @p members alarms among @p alarms.
+ *
+ * The store belongs to a scheduler with an AlarmService and a built
+ * OccurrenceCache attached, as in the app, so every listener of the store
+ * runs inside the timed calls.
+ */
+ToggleResult timeGroupToggle(qint64 alarms, int members, quint64 seed) {
+    const int toggles = 200;
+    VirtualClock clock(QDateTime(QDate(2025, 3, 14), QTime(12, 0)));
+    AlarmScheduler scheduler(&clock);
+    AlarmStore &store = *scheduler.store();
+    fillStore(store, alarms, seed);
+    QVector<Alarm> moved;
+    for (int i = 0; i < members; ++i) {
+        moved.append(store.alarms()[i]);
+        moved.last().group = "Toggled";
+    }
+    store.apply({}, moved, {});
+    AlarmService service(&scheduler);
+    OccurrenceCache cache(&store, &clock);
+    const QDateTime from = clock.currentDateTime();
+    cache.occurrences(from, from.addDays(7), QTime(0, 0), QTime(23, 59));
+    const int days = cache.cachedDays();
+
+    const quint64 before = store.detachCount();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < toggles; ++i) {
+        store.setGroupEnabled("Toggled", i % 2 != 0);
+    }
+    const double toggleUs = timer.nsecsElapsed() / 1e3 / toggles;
+    return {toggleUs, store.detachCount() - before, days > 0 && cache.cachedDays() == days};
+}
+
+/**
+ * @brief Counts the heap allocations of the app's firing path once it has warmed up.
+ *
+ * The alarms are split between two loaded profiles and ring one after the
+ * other across 50 minutes of one hour (so the hourly time zone check stays
+ * out of the way), with the fires recorded in a history file. Each second
+ * runs what the main window does before showing the message box: a
+ * FireBatch collects the due alarms of every profile and builds the
+ * announcement with the profile names. The first half warms up the buffers
+ * and ends with one refresh of the next fire instants; only collect() is
+ * inside the probe for the second half. The refresh the fires queue is left
+ * pending, as it would run later from the event loop.
+ *
+ * @param alarms Number of one-shot alarms.
+ * @param out Stream the results are written to.
+ * @return False if a measured call allocated.
+ */
+bool runFireAllocations(qint64 alarms, QTextStream &out) {
+    if (!AllocationCounter::isAvailable()) {
+        out << "fire allocations: not available (the allocation hooks need glibc)\n";
+        return true;
+    }
+
+    const int window = 3000;
+    VirtualClock clock(QDateTime(QDate(2025, 3, 14), QTime(10, 0)));
+    AlarmProfiles profiles(&clock);
+    QTemporaryDir directory;
+    AlarmHistory history(directory.filePath("history.bin"), 1024);
+    profiles.setHistory(&history);
+    profiles.setActive("Ward B");
+    profiles.setActive("Default");
+
+    QVector<Alarm> added[2];
+    for (qint64 i = 0; i < alarms; ++i) {
+        Alarm alarm;
+        alarm.time = QTime(10, 0, 1).addSecs(int(i % window));
+        alarm.originalTime = alarm.time;
+        alarm.repeat = "Never";
+        alarm.label = QString("Alarm %1").arg(i);
+        added[i % 2].append(alarm);
+    }
+    for (int i = 0; i < profiles.loaded().size(); ++i) {
+        profiles.loaded()[i]->store()->apply(added[i % 2], {}, {});
+        profiles.loaded()[i]->nextFires()->recomputeNow();
+    }
+
+    FireBatch batch;
+    qint64 fired = 0;
+    qint64 textChars = 0;
+    auto fire = [&]() {
+        clock.advance(1000);
+        const QDateTime now = clock.currentDateTime();
+        AllocationProbe probe;
+        fired += batch.collect(profiles, now);
+        textChars += batch.message().size() + batch.details().size();
+        return probe.count();
+    };
+
+    for (int second = 0; second < window / 2; ++second) fire();
+    for (AlarmScheduler *scheduler : profiles.loaded()) scheduler->nextFires()->sync();
+    // Queues the next refresh again, as the first fire after an event loop pass does
+    fire();
+
+    fired = 0;
+    textChars = 0;
+    quint64 allocations = 0;
+    int allocatingCalls = 0;
+    const int measured = window - window / 2 - 1;
+    for (int second = 0; second < measured; ++second) {
+        const quint64 count = fire();
+        allocations += count;
+        if (count != 0) ++allocatingCalls;
+    }
+
+    out << "fire allocations: " << fired << " alarms fired in " << measured << " calls (" << textChars
+        << " chars announced), " << allocations << " allocations in " << allocatingCalls << " calls\n";
+    return allocations == 0;
+}
+
+} // namespace
+
+/**
+ * @brief Main function of the benchmark.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code (0 on success, 1 on bad arguments, 2 if firing alarms allocated,
+ *         3 if the wheel fired differently from the brute-force scan, 4 if a store change
+ *         copied the alarm list without a reason).
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("wheelbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures insert, cancel and per-minute advance costs of the alarm timing wheel.");
+    parser.addHelpOption();
+    parser.addOption({"entries", "Comma separated wheel sizes (default 1000000,10000000).", "list", "1000000,10000000"});
+    parser.addOption({"weekly", "Fraction of weekly entries, 0 to 1 (default 0.8).", "share", "0.8"});
+    parser.addOption({"seed", "Random seed (default 27).", "seed", "27"});
+    parser.addOption({"agenda", "Weekly alarms for the agenda query benchmark (default 100000, 0 skips it).", "alarms", "100000"});
+    parser.addOption({"recompute", "Alarms for the next-fire recompute benchmark (default 1000000, 0 skips it).", "alarms", "1000000"});
+    parser.addOption({"labels", "Alarms for the repeated-label memory benchmark (default 1000000, 0 skips it).", "alarms", "1000000"});
+    parser.addOption({"fire-allocs", "Alarms for the firing allocation check (default 0, which skips it).", "alarms", "0"});
+    parser.addOption({"check-wheel", "Random steps for the wheel correctness check (default 0, which skips it).", "steps", "0"});
+    parser.addOption({"store-check", "Alarms for the store copy check (default 0, which skips it).", "alarms", "0"});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    bool ok = true;
+    const double weeklyShare = parser.value("weekly").toDouble(&ok);
+    if (!ok || weeklyShare < 0 || weeklyShare > 1) {
+        err << "Invalid --weekly value: " << parser.value("weekly") << "\n";
+        return 1;
+    }
+    const quint64 seed = parser.value("seed").toULongLong();
+
+    QList<qint64> sizes;
+    for (const QString &size : parser.value("entries").split(',', Qt::SkipEmptyParts)) {
+        const qint64 entries = size.trimmed().toLongLong(&ok);
+        if (!ok || entries <= 0 || entries > 0x7FFFFFFF - TimingWheel::MinutesPerWeek - 256) {
+            err << "Invalid wheel size: " << size << "\n";
+            return 1;
+        }
+        sizes.append(entries);
+    }
+
+    out << "entries\tinsert ns\tcancel ns\ttick mean us\ttick max us\tfired/week\tRSS KB\n";
+    for (qint64 entries : sizes) {
+        const BenchResult result = run(entries, weeklyShare, seed);
+        out << result.entries << '\t'
+            << QString::number(result.insertNs, 'f', 1) << '\t'
+            << QString::number(result.cancelNs, 'f', 1) << '\t'
+            << QString::number(result.tickMeanUs, 'f', 1) << '\t'
+            << QString::number(result.tickMaxUs, 'f', 1) << '\t'
+            << result.fired << '\t'
+            << result.rssKb << '\n';
+        out.flush();
+    }
+
+    const qint64 agendaAlarms = parser.value("agenda").toLongLong();
+    if (agendaAlarms > 0) {
+        runAgenda(agendaAlarms, seed, out);
+    }
+
+    const qint64 recomputeAlarms = parser.value("recompute").toLongLong();
+    if (recomputeAlarms > 0) {
+        runRecompute(recomputeAlarms, weeklyShare, seed, out);
+    }
+
+    const qint64 labelAlarms = parser.value("labels").toLongLong();
+    if (labelAlarms > 0) {
+        runLabels(labelAlarms, seed, out);
+    }
+
+    const qint64 checkSteps = parser.value("check-wheel").toLongLong();
+    if (checkSteps > 0 && !runWheelCheck(checkSteps, seed, out)) {
+        return 3;
+    }
+
+    const qint64 storeAlarms = parser.value("store-check").toLongLong();
+    if (storeAlarms > 0 && !runStoreCheck(storeAlarms, seed, out)) {
+        return 4;
+    }
+
+    const qint64 fireAlarms = parser.value("fire-allocs").toLongLong();
+    if (fireAlarms > 0 && !runFireAllocations(fireAlarms, out)) {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+QT = core
+
+CONFIG += console c++17 release
+CONFIG -= app_bundle debug
+
+TARGET = wheelbench
+
+include(../../alarmcore/alarmcore.pri)
+# --fire-allocs counts heap allocations
+include(../../alarmcore/allocationhooks.pri)
+
+SOURCES += main.cpp